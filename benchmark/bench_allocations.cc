@@ -0,0 +1,135 @@
+#include "bench_common.hh"
+#include "msensor/conversions/conversions.hh"
+#include "msensor/recorder/scan_recorder.hh"
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <google/protobuf/arena.h>
+#include <new>
+
+// Count every heap allocation in the benchmark binary so the streaming paths
+// can report mallocs per scan alongside their timings.
+namespace {
+std::atomic<uint64_t> g_allocations{0};
+}
+
+void *operator new(size_t size) {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void *ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, size_t /*size*/) noexcept { std::free(ptr); }
+
+using namespace msensor;
+using namespace msensor::bench;
+
+namespace {
+
+/// Measures the loop body after one warm-up pass and reports mallocs per scan.
+template <typename Body>
+void runCounted(benchmark::State &state, Body &&body) {
+  body();
+  const uint64_t before = g_allocations.load(std::memory_order_relaxed);
+  for (auto _ : state) {
+    body();
+  }
+  const uint64_t allocations =
+      g_allocations.load(std::memory_order_relaxed) - before;
+  state.counters["allocs_per_scan"] =
+      benchmark::Counter(static_cast<double>(allocations),
+                         benchmark::Counter::kAvgIterations);
+}
+
+/// What a reactor did before: build a fresh message and assign it per scan.
+void BM_StreamFreshMessage(benchmark::State &state) {
+  const auto scan = makeScan(state.range(0));
+  sensors::PointCloud3 response;
+  std::string wire;
+  runCounted(state, [&] {
+    response = toProtobuf(scan);
+    response.SerializeToString(&wire);
+    benchmark::DoNotOptimize(wire.data());
+  });
+}
+
+/// Arena-owned response refilled in place, as the lidar reactors now do.
+void BM_StreamArenaMessage(benchmark::State &state) {
+  const auto scan = makeScan(state.range(0));
+  google::protobuf::Arena arena;
+  auto *response =
+      google::protobuf::Arena::CreateMessage<sensors::PointCloud3>(&arena);
+  std::string wire;
+  runCounted(state, [&] {
+    toProtobuf(scan, response);
+    response->SerializeToString(&wire);
+    benchmark::DoNotOptimize(wire.data());
+  });
+}
+
+void BM_StreamArenaPacked(benchmark::State &state) {
+  const auto scan = makeScan(state.range(0));
+  sensors::PackedEncoding encoding;
+  encoding.set_delta(true);
+  google::protobuf::Arena arena;
+  auto *response =
+      google::protobuf::Arena::CreateMessage<sensors::PointCloud3Packed>(
+          &arena);
+  std::string wire;
+  runCounted(state, [&] {
+    toProtobuf(scan, encoding, response);
+    response->SerializeToString(&wire);
+    benchmark::DoNotOptimize(wire.data());
+  });
+}
+
+/// Client side: parse into a reused arena message (decoded Scan3DI excluded).
+void BM_ParseArenaMessage(benchmark::State &state) {
+  const std::string wire =
+      toProtobuf(makeScan(state.range(0))).SerializeAsString();
+  google::protobuf::Arena arena;
+  auto *msg =
+      google::protobuf::Arena::CreateMessage<sensors::PointCloud3>(&arena);
+  runCounted(state, [&] {
+    msg->ParseFromString(wire);
+    benchmark::DoNotOptimize(msg->x().data());
+  });
+}
+
+/// File adapter that discards everything written to it.
+class NullFile : public IFile {
+public:
+  void open(const std::string & /*filename*/) override {}
+  void write(const char * /*data*/, size_t /*size*/) override {}
+  void close() override {}
+  std::ostream *ostream() override { return &stream_; }
+
+private:
+  std::ostream stream_{nullptr};
+};
+
+void BM_RecordScan(benchmark::State &state) {
+  const auto scan = makeScan(state.range(0));
+  ScanRecorder recorder(std::make_shared<NullFile>());
+  recorder.start("null");
+  runCounted(state, [&] { recorder.record(scan); });
+}
+
+void BM_RecordImu(benchmark::State &state) {
+  ScanRecorder recorder(std::make_shared<NullFile>());
+  recorder.start("null");
+  const IMUData imu{Header{10, 1}, 1, 2, 3, 4, 5, 6};
+  runCounted(state, [&] { recorder.record(imu); });
+}
+
+} // namespace
+
+BENCHMARK(BM_StreamFreshMessage)->Arg(g_mid360Scan);
+BENCHMARK(BM_StreamArenaMessage)->Arg(g_mid360Scan);
+BENCHMARK(BM_StreamArenaPacked)->Arg(g_mid360Scan);
+BENCHMARK(BM_ParseArenaMessage)->Arg(g_mid360Scan);
+BENCHMARK(BM_RecordScan)->Arg(g_mid360Scan);
+BENCHMARK(BM_RecordImu);
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <random>
+
+#include "msensor/interface/ILidar.hh"
+
+namespace msensor::bench {
+
+/// One Livox packet, a Mid360 10 Hz frame, and a dense accumulated cloud.
+constexpr int64_t g_packetPoints = 96;
+constexpr int64_t g_mid360Scan = 9600;
+constexpr int64_t g_largeScan = 100000;
+
+/// Evenly spread points along a line, with cycling intensities.
+inline std::shared_ptr<Scan3DI> makeScan(size_t count) {
+  auto scan = std::make_shared<Scan3DI>();
+  scan->header = Header{1700000000000000000, 1};
+  scan->points->reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    const auto f = static_cast<float>(i);
+    scan->points->emplace_back(0.01F * f, -0.02F * f, 1.0F + 0.001F * f,
+                               static_cast<float>(i % 256));
+  }
+  return scan;
+}
+
+/// Points scattered over a 40 m x 40 m x 4 m volume around the sensor, with
+/// per-point time offsets over 100 ms. Seeded, so every run sees the same
+/// cloud.
+inline std::shared_ptr<Scan3DI> makeRandomScan(size_t count) {
+  std::mt19937 random(42);
+  std::uniform_real_distribution<float> horizontal(-20.0F, 20.0F);
+  std::uniform_real_distribution<float> vertical(-2.0F, 2.0F);
+  std::uniform_real_distribution<float> intensity(0.0F, 255.0F);
+
+  auto scan = std::make_shared<Scan3DI>();
+  scan->header = Header{1700000000000000000, 1};
+  scan->points->reserve(count);
+  scan->time_offsets_us.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    scan->points->emplace_back(horizontal(random), horizontal(random),
+                               vertical(random), intensity(random));
+    scan->time_offsets_us.push_back(
+        static_cast<uint32_t>(i * 100000 / count));
+  }
+  return scan;
+}
+
+} // namespace msensor::bench
@@ -0,0 +1,155 @@
+#include "bench_common.hh"
+#include "msensor/conversions/conversions.hh"
+#include <benchmark/benchmark.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <opencv2/imgcodecs.hpp>
+
+using namespace msensor;
+using namespace msensor::bench;
+
+namespace {
+
+/// Raspberry Pi camera stream resolution.
+constexpr int g_frameWidth = 1536;
+constexpr int g_frameHeight = 864;
+constexpr int g_jpegQuality = 80;
+
+/// Per-point Add() loop that toProtobuf() used before the deinterleave kernel.
+sensors::PointCloud3 legacyToProtobuf(const std::shared_ptr<Scan3DI> &scan) {
+  sensors::PointCloud3 point_cloud;
+  point_cloud.mutable_header()->set_timestamp(scan->header.timestamp);
+  point_cloud.mutable_header()->set_sequence_number(
+      scan->header.sequence_number);
+  const auto point_count = static_cast<int>(scan->points->size());
+  point_cloud.mutable_x()->Reserve(point_count);
+  point_cloud.mutable_y()->Reserve(point_count);
+  point_cloud.mutable_z()->Reserve(point_count);
+  point_cloud.mutable_intensity()->Reserve(point_count);
+  for (const auto &point : scan->points->points) {
+    point_cloud.add_x(point.x);
+    point_cloud.add_y(point.y);
+    point_cloud.add_z(point.z);
+    point_cloud.add_intensity(static_cast<uint32_t>(point.intensity));
+  }
+  return point_cloud;
+}
+
+void BM_LegacySerialize(benchmark::State &state) {
+  const auto scan = makeScan(state.range(0));
+  std::string out;
+  for (auto _ : state) {
+    legacyToProtobuf(scan).SerializeToString(&out);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * out.size());
+}
+
+void BM_MessageSerialize(benchmark::State &state) {
+  const auto scan = makeScan(state.range(0));
+  std::string out;
+  for (auto _ : state) {
+    toProtobuf(scan).SerializeToString(&out);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * out.size());
+}
+
+void BM_DirectSerialize(benchmark::State &state) {
+  const auto scan = makeScan(state.range(0));
+  std::string out;
+  for (auto _ : state) {
+    out.clear();
+    {
+      google::protobuf::io::StringOutputStream raw(&out);
+      google::protobuf::io::CodedOutputStream output(&raw);
+      writePointCloud(scan, &output);
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * out.size());
+}
+
+void BM_ScanFromProtobuf(benchmark::State &state) {
+  const auto message = toProtobuf(makeRandomScan(state.range(0)));
+  for (auto _ : state) {
+    const auto scan = fromProtobuf(message);
+    benchmark::DoNotOptimize(scan->points->points.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+IMUData makeImu() {
+  return IMUData{Header{1700000000000000000, 1}, 0.1F, 0.2F, 9.8F,
+                 0.01F, 0.02F, 0.03F};
+}
+
+void BM_ImuToProtobuf(benchmark::State &state) {
+  const auto imu = makeImu();
+  for (auto _ : state) {
+    auto message = toProtobuf(imu);
+    benchmark::DoNotOptimize(message);
+  }
+}
+
+void BM_ImuFromProtobuf(benchmark::State &state) {
+  const auto message = toProtobuf(makeImu());
+  for (auto _ : state) {
+    auto imu = fromProtobuf(message);
+    benchmark::DoNotOptimize(imu);
+  }
+}
+
+/// Textured frame, so JPEG has real work to do.
+CameraFrame makeFrame() {
+  CameraFrame frame{Header{1700000000000000000, 1},
+                    cv::Mat(g_frameHeight, g_frameWidth, CV_8UC3)};
+  cv::randu(frame.mat, cv::Scalar::all(0), cv::Scalar::all(255));
+  return frame;
+}
+
+void BM_CameraToProtobuf(benchmark::State &state) {
+  const auto frame = makeFrame();
+  for (auto _ : state) {
+    auto reply = toProtobuf(frame, g_jpegQuality);
+    benchmark::DoNotOptimize(reply.image_data().data());
+  }
+  state.SetItemsProcessed(state.iterations() * g_frameWidth * g_frameHeight);
+}
+
+/// What a camera client does with each reply.
+void BM_CameraDecode(benchmark::State &state) {
+  const auto reply = toProtobuf(makeFrame(), g_jpegQuality);
+  const cv::Mat jpeg(1, static_cast<int>(reply.image_data().size()), CV_8UC1,
+                     const_cast<char *>(reply.image_data().data()));
+  for (auto _ : state) {
+    const cv::Mat image = cv::imdecode(jpeg, cv::IMREAD_COLOR);
+    benchmark::DoNotOptimize(image.data);
+  }
+  state.SetItemsProcessed(state.iterations() * g_frameWidth * g_frameHeight);
+}
+
+} // namespace
+
+BENCHMARK(BM_LegacySerialize)
+    ->Arg(g_packetPoints)
+    ->Arg(g_mid360Scan)
+    ->Arg(g_largeScan);
+BENCHMARK(BM_MessageSerialize)
+    ->Arg(g_packetPoints)
+    ->Arg(g_mid360Scan)
+    ->Arg(g_largeScan);
+BENCHMARK(BM_DirectSerialize)
+    ->Arg(g_packetPoints)
+    ->Arg(g_mid360Scan)
+    ->Arg(g_largeScan);
+BENCHMARK(BM_ScanFromProtobuf)
+    ->Arg(g_packetPoints)
+    ->Arg(g_mid360Scan)
+    ->Arg(g_largeScan);
+BENCHMARK(BM_ImuToProtobuf);
+BENCHMARK(BM_ImuFromProtobuf);
+BENCHMARK(BM_CameraToProtobuf)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CameraDecode)->Unit(benchmark::kMillisecond);
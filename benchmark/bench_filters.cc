@@ -0,0 +1,83 @@
+#include "bench_common.hh"
+#include "msensor/processing/crop.hh"
+#include "msensor/processing/voxel_filter.hh"
+#include <benchmark/benchmark.h>
+#include <numbers>
+#include <pcl/filters/voxel_grid.h>
+
+using namespace msensor;
+using namespace msensor::bench;
+
+namespace {
+
+/// Downsample `range(0)` points with a `range(1)` mm leaf, as
+/// getSubSampledLidarScan does per scan and client.
+void BM_VoxelGrid(benchmark::State &state) {
+  const auto scan = makeRandomScan(state.range(0));
+  const float leaf = static_cast<float>(state.range(1)) / 1000.0F;
+  PointCloud3I filtered;
+  for (auto _ : state) {
+    pcl::VoxelGrid<Point3I> grid;
+    grid.setInputCloud(scan->points);
+    grid.setLeafSize(leaf, leaf, leaf);
+    grid.filter(filtered);
+    benchmark::DoNotOptimize(filtered.points.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.counters["points_out"] = static_cast<double>(filtered.size());
+}
+
+/// The same downsampling with a reused `VoxelFilter`.
+void BM_HashVoxel(benchmark::State &state, VoxelFilter::Mode mode,
+                  size_t threads) {
+  const auto scan = makeRandomScan(state.range(0));
+  const float leaf = static_cast<float>(state.range(1)) / 1000.0F;
+  VoxelFilter filter(mode, threads);
+  PointCloud3I filtered;
+  for (auto _ : state) {
+    filter.filter(*scan->points, leaf, filtered);
+    benchmark::DoNotOptimize(filtered.points.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.counters["points_out"] = static_cast<double>(filtered.size());
+}
+
+/// Keep a 36 degree sector within 10 m, as a narrow-FOV stream asks for.
+void BM_Crop(benchmark::State &state) {
+  const auto scan = makeRandomScan(state.range(0));
+  CropRegion region;
+  region.azimuth_min = -std::numbers::pi_v<float> / 10;
+  region.azimuth_max = std::numbers::pi_v<float> / 10;
+  region.max_range = 10.0F;
+  Scan3DI cropped;
+  for (auto _ : state) {
+    crop(*scan, region, cropped);
+    benchmark::DoNotOptimize(cropped.points->points.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.counters["points_out"] = static_cast<double>(cropped.points->size());
+}
+
+/// Clouds and leaf sizes every voxel filter benchmark runs over.
+void voxelArgs(benchmark::internal::Benchmark *benchmark) {
+  benchmark->ArgNames({"points", "leaf_mm"})
+      ->ArgsProduct({{g_mid360Scan, g_largeScan}, {50, 100, 200, 500}})
+      ->Unit(benchmark::kMicrosecond);
+}
+
+} // namespace
+
+BENCHMARK(BM_VoxelGrid)->Apply(voxelArgs);
+BENCHMARK_CAPTURE(BM_HashVoxel, centroid, VoxelFilter::Mode::Centroid, 1)
+    ->Apply(voxelArgs);
+BENCHMARK_CAPTURE(BM_HashVoxel, centroid_parallel, VoxelFilter::Mode::Centroid,
+                  0)
+    ->Apply(voxelArgs)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_HashVoxel, first_point, VoxelFilter::Mode::FirstPoint, 1)
+    ->Apply(voxelArgs);
+BENCHMARK(BM_Crop)
+    ->ArgName("points")
+    ->Arg(g_mid360Scan)
+    ->Arg(g_largeScan)
+    ->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,52 @@
+#include "msensor/lidar/livox_conversion.hh"
+#include <benchmark/benchmark.h>
+#include <cstring>
+#include <vector>
+
+using namespace msensor;
+using namespace msensor::livox;
+
+namespace {
+
+constexpr size_t g_pointsPerPacket = 96;
+constexpr int64_t g_singlePacket = 1;
+constexpr int64_t g_accumulatedPackets = 100;
+
+/// Convert `range(0)` packets into one accumulated cloud, as Mid360 does.
+void BM_LivoxConvert(benchmark::State &state, Kernel kernel) {
+  if (!isSupported(kernel)) {
+    state.SkipWithError("kernel not supported on this CPU");
+    return;
+  }
+  const auto packets = static_cast<size_t>(state.range(0));
+  std::vector<uint8_t> payload(g_pointsPerPacket * g_cartesianHighPointSize);
+  for (size_t i = 0; i < g_pointsPerPacket; ++i) {
+    const int32_t xyz[3] = {static_cast<int32_t>(i) * 10, -1500, 2500};
+    std::memcpy(payload.data() + i * g_cartesianHighPointSize, xyz,
+                sizeof(xyz));
+  }
+
+  PointCloud3I cloud;
+  cloud.resize(packets * g_pointsPerPacket);
+  for (auto _ : state) {
+    for (size_t p = 0; p < packets; ++p) {
+      convertCartesianHigh(payload.data(), g_pointsPerPacket,
+                           &cloud[p * g_pointsPerPacket], kernel);
+    }
+    benchmark::DoNotOptimize(cloud.points.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * packets * g_pointsPerPacket);
+}
+
+} // namespace
+
+BENCHMARK_CAPTURE(BM_LivoxConvert, scalar, Kernel::Scalar)
+    ->Arg(g_singlePacket)
+    ->Arg(g_accumulatedPackets);
+BENCHMARK_CAPTURE(BM_LivoxConvert, sse2, Kernel::Sse2)
+    ->Arg(g_singlePacket)
+    ->Arg(g_accumulatedPackets);
+BENCHMARK_CAPTURE(BM_LivoxConvert, neon, Kernel::Neon)
+    ->Arg(g_singlePacket)
+    ->Arg(g_accumulatedPackets);
@@ -0,0 +1,69 @@
+#include "bench_common.hh"
+#include "msensor/conversions/conversions.hh"
+#include "msensor/file/file.hh"
+#include "msensor/recorder/scan_player.hh"
+#include "msensor/recorder/scan_recorder.hh"
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <unistd.h>
+
+using namespace msensor;
+using namespace msensor::bench;
+
+namespace {
+
+/// Scans in the recording replayed by BM_PlayScan before it rewinds.
+constexpr size_t g_recordedScans = 64;
+
+/// Record to /dev/null through the real file adapter: serialization, framing
+/// and the per-record flush, without the disk.
+void BM_RecordScanToFile(benchmark::State &state) {
+  const auto scan = makeRandomScan(state.range(0));
+  ScanRecorder recorder(std::make_shared<File>());
+  recorder.start("/dev/null");
+  for (auto _ : state) {
+    recorder.record(scan);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(pointCloudByteSize(scan)));
+}
+
+/// Decode the next entry of a recording, as scan_checker does.
+void BM_PlayScan(benchmark::State &state) {
+  const auto path = std::filesystem::temp_directory_path() /
+                    ("msensor_bench_" + std::to_string(getpid()) + ".pbscan");
+  {
+    const auto scan = makeRandomScan(state.range(0));
+    ScanRecorder recorder(std::make_shared<File>());
+    recorder.start(path.string());
+    for (size_t i = 0; i < g_recordedScans; ++i) {
+      recorder.record(scan);
+    }
+  }
+
+  auto player = std::make_unique<ScanPlayer>(path);
+  for (auto _ : state) {
+    if (!player->next()) {
+      state.PauseTiming();
+      player = std::make_unique<ScanPlayer>(path);
+      state.ResumeTiming();
+      player->next();
+    }
+    benchmark::DoNotOptimize(player->getLastEntry().scan().x().data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  player.reset();
+  std::filesystem::remove(path);
+}
+
+} // namespace
+
+BENCHMARK(BM_RecordScanToFile)
+    ->Arg(g_packetPoints)
+    ->Arg(g_mid360Scan)
+    ->Arg(g_largeScan);
+BENCHMARK(BM_PlayScan)
+    ->Arg(g_packetPoints)
+    ->Arg(g_mid360Scan)
+    ->Arg(g_largeScan);
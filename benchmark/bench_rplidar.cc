@@ -0,0 +1,32 @@
+#include "msensor/lidar/rp_lidar.hh"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+using namespace msensor;
+
+namespace {
+
+/// One 10 Hz revolution of an S-series RPLidar, and the driver's full buffer.
+constexpr int64_t g_revolutionNodes = 3200;
+constexpr int64_t g_maxNodes = 8192;
+
+void BM_RPLidarToScan3D(benchmark::State &state) {
+  const auto count = static_cast<int>(state.range(0));
+  std::vector<sl_lidar_response_measurement_node_hq_t> nodes(count);
+  for (int i = 0; i < count; ++i) {
+    nodes[i].angle_z_q14 = static_cast<uint16_t>((i * 65536LL) / count);
+    nodes[i].dist_mm_q2 = static_cast<uint32_t>((500 + i % 5000) * 4);
+    // Every fourth node is below the quality threshold and skipped.
+    nodes[i].quality = i % 4 == 0 ? 10 : 200;
+    nodes[i].flag = i == 0 ? 1 : 0;
+  }
+  for (auto _ : state) {
+    const auto scan = toScan3D(nodes.data(), count);
+    benchmark::DoNotOptimize(scan->points->points.data());
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+
+} // namespace
+
+BENCHMARK(BM_RPLidarToScan3D)->Arg(g_revolutionNodes)->Arg(g_maxNodes);
@@ -21,8 +21,10 @@ GRAY8: CameraEncoding
 MJPEG: CameraEncoding
 
 class CameraStreamRequest(_message.Message):
-    __slots__ = ()
-    def __init__(self) -> None: ...
+    __slots__ = ("conflate",)
+    CONFLATE_FIELD_NUMBER: _ClassVar[int]
+    conflate: bool
+    def __init__(self, conflate: _Optional[bool] = ...) -> None: ...
 
 class CameraStreamReply(_message.Message):
     __slots__ = ("header", "width", "height", "encoding", "image_data")
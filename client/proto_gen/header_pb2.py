@@ -24,13 +24,15 @@ _sym_db = _symbol_database.Default()
 
 
 
-DESCRIPTOR = _descriptor_pool.Default().AddSerializedFile(b'\n\x0cheader.proto\x12\x07sensors\"4\n\x06Header\x12\x11\n\ttimestamp\x18\x01 \x01(\x04\x12\x17\n\x0fsequence_number\x18\x02 \x01(\rb\x06proto3')
+DESCRIPTOR = _descriptor_pool.Default().AddSerializedFile(b'\n\x0cheader.proto\x12\x07sensors\"u\n\x05Trace\x12\x19\n\x11\x64river_receive_ns\x18\x01 \x01(\x04\x12\x1a\n\x12\x63onversion_done_ns\x18\x02 \x01(\x04\x12\x1d\n\x15serialization_done_ns\x18\x03 \x01(\x04\x12\x16\n\x0ewrite_start_ns\x18\x04 \x01(\x04\"d\n\x06Header\x12\x11\n\ttimestamp\x18\x01 \x01(\x04\x12\x17\n\x0fsequence_number\x18\x02 \x01(\r\x12\x1d\n\x05trace\x18\x03 \x01(\x0b\x32\x0e.sensors.Trace\x12\x0f\n\x07skipped\x18\x04 \x01(\rb\x06proto3')
 
 _globals = globals()
 _builder.BuildMessageAndEnumDescriptors(DESCRIPTOR, _globals)
 _builder.BuildTopDescriptorsAndMessages(DESCRIPTOR, 'header_pb2', _globals)
 if not _descriptor._USE_C_DESCRIPTORS:
   DESCRIPTOR._loaded_options = None
-  _globals['_HEADER']._serialized_start=25
-  _globals['_HEADER']._serialized_end=77
+  _globals['_TRACE']._serialized_start=25
+  _globals['_TRACE']._serialized_end=142
+  _globals['_HEADER']._serialized_start=144
+  _globals['_HEADER']._serialized_end=244
 # @@protoc_insertion_point(module_scope)
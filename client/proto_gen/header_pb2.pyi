@@ -1,13 +1,30 @@
 from google.protobuf import descriptor as _descriptor
 from google.protobuf import message as _message
-from typing import ClassVar as _ClassVar, Optional as _Optional
+from collections.abc import Mapping as _Mapping
+from typing import ClassVar as _ClassVar, Optional as _Optional, Union as _Union
 
 DESCRIPTOR: _descriptor.FileDescriptor
 
+class Trace(_message.Message):
+    __slots__ = ("driver_receive_ns", "conversion_done_ns", "serialization_done_ns", "write_start_ns")
+    DRIVER_RECEIVE_NS_FIELD_NUMBER: _ClassVar[int]
+    CONVERSION_DONE_NS_FIELD_NUMBER: _ClassVar[int]
+    SERIALIZATION_DONE_NS_FIELD_NUMBER: _ClassVar[int]
+    WRITE_START_NS_FIELD_NUMBER: _ClassVar[int]
+    driver_receive_ns: int
+    conversion_done_ns: int
+    serialization_done_ns: int
+    write_start_ns: int
+    def __init__(self, driver_receive_ns: _Optional[int] = ..., conversion_done_ns: _Optional[int] = ..., serialization_done_ns: _Optional[int] = ..., write_start_ns: _Optional[int] = ...) -> None: ...
+
 class Header(_message.Message):
-    __slots__ = ("timestamp", "sequence_number")
+    __slots__ = ("timestamp", "sequence_number", "trace", "skipped")
     TIMESTAMP_FIELD_NUMBER: _ClassVar[int]
     SEQUENCE_NUMBER_FIELD_NUMBER: _ClassVar[int]
+    TRACE_FIELD_NUMBER: _ClassVar[int]
+    SKIPPED_FIELD_NUMBER: _ClassVar[int]
     timestamp: int
     sequence_number: int
-    def __init__(self, timestamp: _Optional[int] = ..., sequence_number: _Optional[int] = ...) -> None: ...
+    trace: Trace
+    skipped: int
+    def __init__(self, timestamp: _Optional[int] = ..., sequence_number: _Optional[int] = ..., trace: _Optional[_Union[Trace, _Mapping]] = ..., skipped: _Optional[int] = ...) -> None: ...
@@ -25,17 +25,37 @@ _sym_db = _symbol_database.Default()
 import header_pb2 as header__pb2
 
 
-DESCRIPTOR = _descriptor_pool.Default().AddSerializedFile(b'\n\timu.proto\x12\x07sensors\x1a\x0cheader.proto\"r\n\x07IMUData\x12\x1f\n\x06header\x18\x01 \x01(\x0b\x32\x0f.sensors.Header\x12\n\n\x02\x61x\x18\x02 \x01(\x02\x12\n\n\x02\x61y\x18\x03 \x01(\x02\x12\n\n\x02\x61z\x18\x04 \x01(\x02\x12\n\n\x02gx\x18\x05 \x01(\x02\x12\n\n\x02gy\x18\x06 \x01(\x02\x12\n\n\x02gz\x18\x07 \x01(\x02\"\x12\n\x10ImuStreamRequest2I\n\nImuService\x12;\n\ngetImuData\x12\x19.sensors.ImuStreamRequest\x1a\x10.sensors.IMUData0\x01\x62\x06proto3')
+DESCRIPTOR = _descriptor_pool.Default().AddSerializedFile(b'\n\timu.proto\x12\x07sensors\x1a\x0cheader.proto\"r\n\x07IMUData\x12\x1f\n\x06header\x18\x01 \x01(\x0b\x32\x0f.sensors.Header\x12\n\n\x02\x61x\x18\x02 \x01(\x02\x12\n\n\x02\x61y\x18\x03 \x01(\x02\x12\n\n\x02\x61z\x18\x04 \x01(\x02\x12\n\n\x02gx\x18\x05 \x01(\x02\x12\n\n\x02gy\x18\x06 \x01(\x02\x12\n\n\x02gz\x18\x07 \x01(\x02\"\x12\n\x10ImuStreamRequest\"\xc4\x01\n\x08ImuBatch\x12\x1f\n\x06header\x18\x01 \x01(\x0b\x32\x0f.sensors.Header\x12\x1a\n\x0etime_offset_ns\x18\x02 \x03(\x04\x42\x02\x10\x01\x12\x1b\n\x0fsequence_number\x18\x03 \x03(\rB\x02\x10\x01\x12\x0e\n\x02\x61x\x18\x04 \x03(\x02\x42\x02\x10\x01\x12\x0e\n\x02\x61y\x18\x05 \x03(\x02\x42\x02\x10\x01\x12\x0e\n\x02\x61z\x18\x06 \x03(\x02\x42\x02\x10\x01\x12\x0e\n\x02gx\x18\x07 \x03(\x02\x42\x02\x10\x01\x12\x0e\n\x02gy\x18\x08 \x03(\x02\x42\x02\x10\x01\x12\x0e\n\x02gz\x18\t \x03(\x02\x42\x02\x10\x01\">\n\x0fImuBatchRequest\x12\x13\n\x0bmax_samples\x18\x01 \x01(\r\x12\x16\n\x0emax_latency_ms\x18\x02 \x01(\r2\x87\x01\n\nImuService\x12;\n\ngetImuData\x12\x19.sensors.ImuStreamRequest\x1a\x10.sensors.IMUData0\x01\x12<\n\x0bgetImuBatch\x12\x18.sensors.ImuBatchRequest\x1a\x11.sensors.ImuBatch0\x01\x62\x06proto3')
 
 _globals = globals()
 _builder.BuildMessageAndEnumDescriptors(DESCRIPTOR, _globals)
 _builder.BuildTopDescriptorsAndMessages(DESCRIPTOR, 'imu_pb2', _globals)
 if not _descriptor._USE_C_DESCRIPTORS:
   DESCRIPTOR._loaded_options = None
+  _globals['_IMUBATCH'].fields_by_name['time_offset_ns']._loaded_options = None
+  _globals['_IMUBATCH'].fields_by_name['time_offset_ns']._serialized_options = b'\020\001'
+  _globals['_IMUBATCH'].fields_by_name['sequence_number']._loaded_options = None
+  _globals['_IMUBATCH'].fields_by_name['sequence_number']._serialized_options = b'\020\001'
+  _globals['_IMUBATCH'].fields_by_name['ax']._loaded_options = None
+  _globals['_IMUBATCH'].fields_by_name['ax']._serialized_options = b'\020\001'
+  _globals['_IMUBATCH'].fields_by_name['ay']._loaded_options = None
+  _globals['_IMUBATCH'].fields_by_name['ay']._serialized_options = b'\020\001'
+  _globals['_IMUBATCH'].fields_by_name['az']._loaded_options = None
+  _globals['_IMUBATCH'].fields_by_name['az']._serialized_options = b'\020\001'
+  _globals['_IMUBATCH'].fields_by_name['gx']._loaded_options = None
+  _globals['_IMUBATCH'].fields_by_name['gx']._serialized_options = b'\020\001'
+  _globals['_IMUBATCH'].fields_by_name['gy']._loaded_options = None
+  _globals['_IMUBATCH'].fields_by_name['gy']._serialized_options = b'\020\001'
+  _globals['_IMUBATCH'].fields_by_name['gz']._loaded_options = None
+  _globals['_IMUBATCH'].fields_by_name['gz']._serialized_options = b'\020\001'
   _globals['_IMUDATA']._serialized_start=36
   _globals['_IMUDATA']._serialized_end=150
   _globals['_IMUSTREAMREQUEST']._serialized_start=152
   _globals['_IMUSTREAMREQUEST']._serialized_end=170
-  _globals['_IMUSERVICE']._serialized_start=172
-  _globals['_IMUSERVICE']._serialized_end=245
+  _globals['_IMUBATCH']._serialized_start=173
+  _globals['_IMUBATCH']._serialized_end=369
+  _globals['_IMUBATCHREQUEST']._serialized_start=371
+  _globals['_IMUBATCHREQUEST']._serialized_end=433
+  _globals['_IMUSERVICE']._serialized_start=436
+  _globals['_IMUSERVICE']._serialized_end=571
 # @@protoc_insertion_point(module_scope)
@@ -1,7 +1,8 @@
 import header_pb2 as _header_pb2
+from google.protobuf.internal import containers as _containers
 from google.protobuf import descriptor as _descriptor
 from google.protobuf import message as _message
-from collections.abc import Mapping as _Mapping
+from collections.abc import Iterable as _Iterable, Mapping as _Mapping
 from typing import ClassVar as _ClassVar, Optional as _Optional, Union as _Union
 
 DESCRIPTOR: _descriptor.FileDescriptor
@@ -27,3 +28,33 @@ class IMUData(_message.Message):
 class ImuStreamRequest(_message.Message):
     __slots__ = ()
     def __init__(self) -> None: ...
+
+class ImuBatch(_message.Message):
+    __slots__ = ("header", "time_offset_ns", "sequence_number", "ax", "ay", "az", "gx", "gy", "gz")
+    HEADER_FIELD_NUMBER: _ClassVar[int]
+    TIME_OFFSET_NS_FIELD_NUMBER: _ClassVar[int]
+    SEQUENCE_NUMBER_FIELD_NUMBER: _ClassVar[int]
+    AX_FIELD_NUMBER: _ClassVar[int]
+    AY_FIELD_NUMBER: _ClassVar[int]
+    AZ_FIELD_NUMBER: _ClassVar[int]
+    GX_FIELD_NUMBER: _ClassVar[int]
+    GY_FIELD_NUMBER: _ClassVar[int]
+    GZ_FIELD_NUMBER: _ClassVar[int]
+    header: _header_pb2.Header
+    time_offset_ns: _containers.RepeatedScalarFieldContainer[int]
+    sequence_number: _containers.RepeatedScalarFieldContainer[int]
+    ax: _containers.RepeatedScalarFieldContainer[float]
+    ay: _containers.RepeatedScalarFieldContainer[float]
+    az: _containers.RepeatedScalarFieldContainer[float]
+    gx: _containers.RepeatedScalarFieldContainer[float]
+    gy: _containers.RepeatedScalarFieldContainer[float]
+    gz: _containers.RepeatedScalarFieldContainer[float]
+    def __init__(self, header: _Optional[_Union[_header_pb2.Header, _Mapping]] = ..., time_offset_ns: _Optional[_Iterable[int]] = ..., sequence_number: _Optional[_Iterable[int]] = ..., ax: _Optional[_Iterable[float]] = ..., ay: _Optional[_Iterable[float]] = ..., az: _Optional[_Iterable[float]] = ..., gx: _Optional[_Iterable[float]] = ..., gy: _Optional[_Iterable[float]] = ..., gz: _Optional[_Iterable[float]] = ...) -> None: ...
+
+class ImuBatchRequest(_message.Message):
+    __slots__ = ("max_samples", "max_latency_ms")
+    MAX_SAMPLES_FIELD_NUMBER: _ClassVar[int]
+    MAX_LATENCY_MS_FIELD_NUMBER: _ClassVar[int]
+    max_samples: int
+    max_latency_ms: int
+    def __init__(self, max_samples: _Optional[int] = ..., max_latency_ms: _Optional[int] = ...) -> None: ...
@@ -39,6 +39,11 @@ class ImuServiceStub(object):
                 request_serializer=imu__pb2.ImuStreamRequest.SerializeToString,
                 response_deserializer=imu__pb2.IMUData.FromString,
                 _registered_method=True)
+        self.getImuBatch = channel.unary_stream(
+                '/sensors.ImuService/getImuBatch',
+                request_serializer=imu__pb2.ImuBatchRequest.SerializeToString,
+                response_deserializer=imu__pb2.ImuBatch.FromString,
+                _registered_method=True)
 
 
 class ImuServiceServicer(object):
@@ -50,6 +55,12 @@ class ImuServiceServicer(object):
         context.set_details('Method not implemented!')
         raise NotImplementedError('Method not implemented!')
 
+    def getImuBatch(self, request, context):
+        """Missing associated documentation comment in .proto file."""
+        context.set_code(grpc.StatusCode.UNIMPLEMENTED)
+        context.set_details('Method not implemented!')
+        raise NotImplementedError('Method not implemented!')
+
 
 def add_ImuServiceServicer_to_server(servicer, server):
     rpc_method_handlers = {
@@ -58,6 +69,11 @@ def add_ImuServiceServicer_to_server(servicer, server):
                     request_deserializer=imu__pb2.ImuStreamRequest.FromString,
                     response_serializer=imu__pb2.IMUData.SerializeToString,
             ),
+            'getImuBatch': grpc.unary_stream_rpc_method_handler(
+                    servicer.getImuBatch,
+                    request_deserializer=imu__pb2.ImuBatchRequest.FromString,
+                    response_serializer=imu__pb2.ImuBatch.SerializeToString,
+            ),
     }
     generic_handler = grpc.method_handlers_generic_handler(
             'sensors.ImuService', rpc_method_handlers)
@@ -95,3 +111,30 @@ class ImuService(object):
             timeout,
             metadata,
             _registered_method=True)
+
+    @staticmethod
+    def getImuBatch(request,
+            target,
+            options=(),
+            channel_credentials=None,
+            call_credentials=None,
+            insecure=False,
+            compression=None,
+            wait_for_ready=None,
+            timeout=None,
+            metadata=None):
+        return grpc.experimental.unary_stream(
+            request,
+            target,
+            '/sensors.ImuService/getImuBatch',
+            imu__pb2.ImuBatchRequest.SerializeToString,
+            imu__pb2.ImuBatch.FromString,
+            options,
+            channel_credentials,
+            insecure,
+            call_credentials,
+            compression,
+            wait_for_ready,
+            timeout,
+            metadata,
+            _registered_method=True)
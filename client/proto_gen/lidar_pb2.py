@@ -25,7 +25,7 @@ _sym_db = _symbol_database.Default()
 import header_pb2 as header__pb2
 
 
-DESCRIPTOR = _descriptor_pool.Default().AddSerializedFile(b'\n\x0blidar.proto\x12\x07sensors\x1a\x0cheader.proto\"\x9f\x01\n\x0bPointCloud3\x12\x1f\n\x06header\x18\x01 \x01(\x0b\x32\x0f.sensors.Header\x12\r\n\x01x\x18\x02 \x03(\x02\x42\x02\x10\x01\x12\r\n\x01y\x18\x03 \x03(\x02\x42\x02\x10\x01\x12\r\n\x01z\x18\x04 \x03(\x02\x42\x02\x10\x01\x12\x15\n\tintensity\x18\x05 \x03(\rB\x02\x10\x01\x12\r\n\x01r\x18\x06 \x03(\x02\x42\x02\x10\x01\x12\r\n\x01g\x18\x07 \x03(\x02\x42\x02\x10\x01\x12\r\n\x01\x62\x18\x08 \x03(\x02\x42\x02\x10\x01\"\x14\n\x12LidarStreamRequest\"2\n\x1cSubSampledLidarStreamRequest\x12\x12\n\nvoxel_size\x18\x01 \x01(\x02\x32\xae\x01\n\x0cLidarService\x12\x43\n\x0cgetLidarScan\x12\x1b.sensors.LidarStreamRequest\x1a\x14.sensors.PointCloud30\x01\x12Y\n\x16getSubSampledLidarScan\x12%.sensors.SubSampledLidarStreamRequest\x1a\x14.sensors.PointCloud3(\x01\x30\x01\x62\x06proto3')
+DESCRIPTOR = _descriptor_pool.Default().AddSerializedFile(b'\n\x0blidar.proto\x12\x07sensors\x1a\x0cheader.proto\"\xce\x01\n\x0bPointCloud3\x12\x1f\n\x06header\x18\x01 \x01(\x0b\x32\x0f.sensors.Header\x12\r\n\x01x\x18\x02 \x03(\x02\x42\x02\x10\x01\x12\r\n\x01y\x18\x03 \x03(\x02\x42\x02\x10\x01\x12\r\n\x01z\x18\x04 \x03(\x02\x42\x02\x10\x01\x12\x15\n\tintensity\x18\x05 \x03(\rB\x02\x10\x01\x12\r\n\x01r\x18\x06 \x03(\x02\x42\x02\x10\x01\x12\r\n\x01g\x18\x07 \x03(\x02\x42\x02\x10\x01\x12\r\n\x01\x62\x18\x08 \x03(\x02\x42\x02\x10\x01\x12\x1a\n\x0etime_offset_us\x18\t \x03(\rB\x02\x10\x01\x12\x11\n\tdevice_id\x18\n \x01(\r\"_\n\x0ePackedEncoding\x12\r\n\x05scale\x18\x01 \x01(\x02\x12\r\n\x05\x64\x65lta\x18\x02 \x01(\x08\x12/\n\x0b\x63ompression\x18\x03 \x01(\x0e\x32\x1a.sensors.PackedCompression\"N\n\x0cPackedPoints\x12\r\n\x01x\x18\x01 \x03(\x11\x42\x02\x10\x01\x12\r\n\x01y\x18\x02 \x03(\x11\x42\x02\x10\x01\x12\r\n\x01z\x18\x03 \x03(\x11\x42\x02\x10\x01\x12\x11\n\tintensity\x18\x04 \x01(\x0c\"\xd8\x01\n\x11PointCloud3Packed\x12\x1f\n\x06header\x18\x01 \x01(\x0b\x32\x0f.sensors.Header\x12)\n\x08\x65ncoding\x18\x02 \x01(\x0b\x32\x17.sensors.PackedEncoding\x12\'\n\x06points\x18\x03 \x01(\x0b\x32\x15.sensors.PackedPointsH\x00\x12\x1b\n\x11\x63ompressed_points\x18\x04 \x01(\x0cH\x00\x12\x11\n\tdevice_id\x18\x05 \x01(\r\x12\x13\n\x0bpoint_count\x18\x06 \x01(\rB\t\n\x07payload\"\xba\x01\n\x04\x42ox3\x12\x12\n\x05min_x\x18\x01 \x01(\x02H\x00\x88\x01\x01\x12\x12\n\x05min_y\x18\x02 \x01(\x02H\x01\x88\x01\x01\x12\x12\n\x05min_z\x18\x03 \x01(\x02H\x02\x88\x01\x01\x12\x12\n\x05max_x\x18\x04 \x01(\x02H\x03\x88\x01\x01\x12\x12\n\x05max_y\x18\x05 \x01(\x02H\x04\x88\x01\x01\x12\x12\n\x05max_z\x18\x06 \x01(\x02H\x05\x88\x01\x01\x42\x08\n\x06_min_xB\x08\n\x06_min_yB\x08\n\x06_min_zB\x08\n\x06_max_xB\x08\n\x06_max_yB\x08\n\x06_max_z\"\x8f\x01\n\nCropRegion\x12\x1a\n\x03\x62ox\x18\x01 \x01(\x0b\x32\r.sensors.Box3\x12\x11\n\tmin_range\x18\x02 \x01(\x02\x12\x11\n\tmax_range\x18\x03 \x01(\x02\x12\x13\n\x0b\x61zimuth_min\x18\x04 \x01(\x02\x12\x13\n\x0b\x61zimuth_max\x18\x05 \x01(\x02\x12\x15\n\rmin_intensity\x18\x06 \x01(\x02\"I\n\x12LidarStreamRequest\x12!\n\x04\x63rop\x18\x01 \x01(\x0b\x32\x13.sensors.CropRegion\x12\x10\n\x08\x63onflate\x18\x02 \x01(\x08\"z\n\x18PackedLidarStreamRequest\x12)\n\x08\x65ncoding\x18\x01 \x01(\x0b\x32\x17.sensors.PackedEncoding\x12!\n\x04\x63rop\x18\x02 \x01(\x0b\x32\x13.sensors.CropRegion\x12\x10\n\x08\x63onflate\x18\x03 \x01(\x08\"g\n\x1cSubSampledLidarStreamRequest\x12\x12\n\nvoxel_size\x18\x01 \x01(\x02\x12!\n\x04\x63rop\x18\x02 \x01(\x0b\x32\x13.sensors.CropRegion\x12\x10\n\x08\x63onflate\x18\x03 \x01(\x08*?\n\x11PackedCompression\x12\x14\n\x10\x43OMPRESSION_NONE\x10\x00\x12\x14\n\x10\x43OMPRESSION_ZSTD\x10\x01\x32\xd2\x02\n\x0cLidarService\x12\x43\n\x0cgetLidarScan\x12\x1b.sensors.LidarStreamRequest\x1a\x14.sensors.PointCloud30\x01\x12Y\n\x16getSubSampledLidarScan\x12%.sensors.SubSampledLidarStreamRequest\x1a\x14.sensors.PointCloud3(\x01\x30\x01\x12U\n\x12getPackedLidarScan\x12!.sensors.PackedLidarStreamRequest\x1a\x1a.sensors.PointCloud3Packed0\x01\x12K\n\x14getDeskewedLidarScan\x12\x1b.sensors.LidarStreamRequest\x1a\x14.sensors.PointCloud30\x01\x62\x06proto3')
 
 _globals = globals()
 _builder.BuildMessageAndEnumDescriptors(DESCRIPTOR, _globals)
@@ -46,12 +46,34 @@ if not _descriptor._USE_C_DESCRIPTORS:
   _globals['_POINTCLOUD3'].fields_by_name['g']._serialized_options = b'\020\001'
   _globals['_POINTCLOUD3'].fields_by_name['b']._loaded_options = None
   _globals['_POINTCLOUD3'].fields_by_name['b']._serialized_options = b'\020\001'
+  _globals['_POINTCLOUD3'].fields_by_name['time_offset_us']._loaded_options = None
+  _globals['_POINTCLOUD3'].fields_by_name['time_offset_us']._serialized_options = b'\020\001'
+  _globals['_PACKEDPOINTS'].fields_by_name['x']._loaded_options = None
+  _globals['_PACKEDPOINTS'].fields_by_name['x']._serialized_options = b'\020\001'
+  _globals['_PACKEDPOINTS'].fields_by_name['y']._loaded_options = None
+  _globals['_PACKEDPOINTS'].fields_by_name['y']._serialized_options = b'\020\001'
+  _globals['_PACKEDPOINTS'].fields_by_name['z']._loaded_options = None
+  _globals['_PACKEDPOINTS'].fields_by_name['z']._serialized_options = b'\020\001'
+  _globals['_PACKEDCOMPRESSION']._serialized_start=1282
+  _globals['_PACKEDCOMPRESSION']._serialized_end=1345
   _globals['_POINTCLOUD3']._serialized_start=39
-  _globals['_POINTCLOUD3']._serialized_end=198
-  _globals['_LIDARSTREAMREQUEST']._serialized_start=200
-  _globals['_LIDARSTREAMREQUEST']._serialized_end=220
-  _globals['_SUBSAMPLEDLIDARSTREAMREQUEST']._serialized_start=222
-  _globals['_SUBSAMPLEDLIDARSTREAMREQUEST']._serialized_end=272
-  _globals['_LIDARSERVICE']._serialized_start=275
-  _globals['_LIDARSERVICE']._serialized_end=449
+  _globals['_POINTCLOUD3']._serialized_end=245
+  _globals['_PACKEDENCODING']._serialized_start=247
+  _globals['_PACKEDENCODING']._serialized_end=342
+  _globals['_PACKEDPOINTS']._serialized_start=344
+  _globals['_PACKEDPOINTS']._serialized_end=422
+  _globals['_POINTCLOUD3PACKED']._serialized_start=425
+  _globals['_POINTCLOUD3PACKED']._serialized_end=641
+  _globals['_BOX3']._serialized_start=644
+  _globals['_BOX3']._serialized_end=830
+  _globals['_CROPREGION']._serialized_start=833
+  _globals['_CROPREGION']._serialized_end=976
+  _globals['_LIDARSTREAMREQUEST']._serialized_start=978
+  _globals['_LIDARSTREAMREQUEST']._serialized_end=1051
+  _globals['_PACKEDLIDARSTREAMREQUEST']._serialized_start=1053
+  _globals['_PACKEDLIDARSTREAMREQUEST']._serialized_end=1175
+  _globals['_SUBSAMPLEDLIDARSTREAMREQUEST']._serialized_start=1177
+  _globals['_SUBSAMPLEDLIDARSTREAMREQUEST']._serialized_end=1280
+  _globals['_LIDARSERVICE']._serialized_start=1348
+  _globals['_LIDARSERVICE']._serialized_end=1686
 # @@protoc_insertion_point(module_scope)
@@ -1,5 +1,6 @@
 import header_pb2 as _header_pb2
 from google.protobuf.internal import containers as _containers
+from google.protobuf.internal import enum_type_wrapper as _enum_type_wrapper
 from google.protobuf import descriptor as _descriptor
 from google.protobuf import message as _message
 from collections.abc import Iterable as _Iterable, Mapping as _Mapping
@@ -7,8 +8,15 @@ from typing import ClassVar as _ClassVar, Optional as _Optional, Union as _Union
 
 DESCRIPTOR: _descriptor.FileDescriptor
 
+class PackedCompression(int, metaclass=_enum_type_wrapper.EnumTypeWrapper):
+    __slots__ = ()
+    COMPRESSION_NONE: _ClassVar[PackedCompression]
+    COMPRESSION_ZSTD: _ClassVar[PackedCompression]
+COMPRESSION_NONE: PackedCompression
+COMPRESSION_ZSTD: PackedCompression
+
 class PointCloud3(_message.Message):
-    __slots__ = ("header", "x", "y", "z", "intensity", "r", "g", "b")
+    __slots__ = ("header", "x", "y", "z", "intensity", "r", "g", "b", "time_offset_us", "device_id")
     HEADER_FIELD_NUMBER: _ClassVar[int]
     X_FIELD_NUMBER: _ClassVar[int]
     Y_FIELD_NUMBER: _ClassVar[int]
@@ -17,6 +25,8 @@ class PointCloud3(_message.Message):
     R_FIELD_NUMBER: _ClassVar[int]
     G_FIELD_NUMBER: _ClassVar[int]
     B_FIELD_NUMBER: _ClassVar[int]
+    TIME_OFFSET_US_FIELD_NUMBER: _ClassVar[int]
+    DEVICE_ID_FIELD_NUMBER: _ClassVar[int]
     header: _header_pb2.Header
     x: _containers.RepeatedScalarFieldContainer[float]
     y: _containers.RepeatedScalarFieldContainer[float]
@@ -25,14 +35,104 @@ class PointCloud3(_message.Message):
     r: _containers.RepeatedScalarFieldContainer[float]
     g: _containers.RepeatedScalarFieldContainer[float]
     b: _containers.RepeatedScalarFieldContainer[float]
-    def __init__(self, header: _Optional[_Union[_header_pb2.Header, _Mapping]] = ..., x: _Optional[_Iterable[float]] = ..., y: _Optional[_Iterable[float]] = ..., z: _Optional[_Iterable[float]] = ..., intensity: _Optional[_Iterable[int]] = ..., r: _Optional[_Iterable[float]] = ..., g: _Optional[_Iterable[float]] = ..., b: _Optional[_Iterable[float]] = ...) -> None: ...
+    time_offset_us: _containers.RepeatedScalarFieldContainer[int]
+    device_id: int
+    def __init__(self, header: _Optional[_Union[_header_pb2.Header, _Mapping]] = ..., x: _Optional[_Iterable[float]] = ..., y: _Optional[_Iterable[float]] = ..., z: _Optional[_Iterable[float]] = ..., intensity: _Optional[_Iterable[int]] = ..., r: _Optional[_Iterable[float]] = ..., g: _Optional[_Iterable[float]] = ..., b: _Optional[_Iterable[float]] = ..., time_offset_us: _Optional[_Iterable[int]] = ..., device_id: _Optional[int] = ...) -> None: ...
+
+class PackedEncoding(_message.Message):
+    __slots__ = ("scale", "delta", "compression")
+    SCALE_FIELD_NUMBER: _ClassVar[int]
+    DELTA_FIELD_NUMBER: _ClassVar[int]
+    COMPRESSION_FIELD_NUMBER: _ClassVar[int]
+    scale: float
+    delta: bool
+    compression: PackedCompression
+    def __init__(self, scale: _Optional[float] = ..., delta: _Optional[bool] = ..., compression: _Optional[_Union[PackedCompression, str]] = ...) -> None: ...
+
+class PackedPoints(_message.Message):
+    __slots__ = ("x", "y", "z", "intensity")
+    X_FIELD_NUMBER: _ClassVar[int]
+    Y_FIELD_NUMBER: _ClassVar[int]
+    Z_FIELD_NUMBER: _ClassVar[int]
+    INTENSITY_FIELD_NUMBER: _ClassVar[int]
+    x: _containers.RepeatedScalarFieldContainer[int]
+    y: _containers.RepeatedScalarFieldContainer[int]
+    z: _containers.RepeatedScalarFieldContainer[int]
+    intensity: bytes
+    def __init__(self, x: _Optional[_Iterable[int]] = ..., y: _Optional[_Iterable[int]] = ..., z: _Optional[_Iterable[int]] = ..., intensity: _Optional[bytes] = ...) -> None: ...
+
+class PointCloud3Packed(_message.Message):
+    __slots__ = ("header", "encoding", "points", "compressed_points", "device_id", "point_count")
+    HEADER_FIELD_NUMBER: _ClassVar[int]
+    ENCODING_FIELD_NUMBER: _ClassVar[int]
+    POINTS_FIELD_NUMBER: _ClassVar[int]
+    COMPRESSED_POINTS_FIELD_NUMBER: _ClassVar[int]
+    DEVICE_ID_FIELD_NUMBER: _ClassVar[int]
+    POINT_COUNT_FIELD_NUMBER: _ClassVar[int]
+    header: _header_pb2.Header
+    encoding: PackedEncoding
+    points: PackedPoints
+    compressed_points: bytes
+    device_id: int
+    point_count: int
+    def __init__(self, header: _Optional[_Union[_header_pb2.Header, _Mapping]] = ..., encoding: _Optional[_Union[PackedEncoding, _Mapping]] = ..., points: _Optional[_Union[PackedPoints, _Mapping]] = ..., compressed_points: _Optional[bytes] = ..., device_id: _Optional[int] = ..., point_count: _Optional[int] = ...) -> None: ...
+
+class Box3(_message.Message):
+    __slots__ = ("min_x", "min_y", "min_z", "max_x", "max_y", "max_z")
+    MIN_X_FIELD_NUMBER: _ClassVar[int]
+    MIN_Y_FIELD_NUMBER: _ClassVar[int]
+    MIN_Z_FIELD_NUMBER: _ClassVar[int]
+    MAX_X_FIELD_NUMBER: _ClassVar[int]
+    MAX_Y_FIELD_NUMBER: _ClassVar[int]
+    MAX_Z_FIELD_NUMBER: _ClassVar[int]
+    min_x: float
+    min_y: float
+    min_z: float
+    max_x: float
+    max_y: float
+    max_z: float
+    def __init__(self, min_x: _Optional[float] = ..., min_y: _Optional[float] = ..., min_z: _Optional[float] = ..., max_x: _Optional[float] = ..., max_y: _Optional[float] = ..., max_z: _Optional[float] = ...) -> None: ...
+
+class CropRegion(_message.Message):
+    __slots__ = ("box", "min_range", "max_range", "azimuth_min", "azimuth_max", "min_intensity")
+    BOX_FIELD_NUMBER: _ClassVar[int]
+    MIN_RANGE_FIELD_NUMBER: _ClassVar[int]
+    MAX_RANGE_FIELD_NUMBER: _ClassVar[int]
+    AZIMUTH_MIN_FIELD_NUMBER: _ClassVar[int]
+    AZIMUTH_MAX_FIELD_NUMBER: _ClassVar[int]
+    MIN_INTENSITY_FIELD_NUMBER: _ClassVar[int]
+    box: Box3
+    min_range: float
+    max_range: float
+    azimuth_min: float
+    azimuth_max: float
+    min_intensity: float
+    def __init__(self, box: _Optional[_Union[Box3, _Mapping]] = ..., min_range: _Optional[float] = ..., max_range: _Optional[float] = ..., azimuth_min: _Optional[float] = ..., azimuth_max: _Optional[float] = ..., min_intensity: _Optional[float] = ...) -> None: ...
 
 class LidarStreamRequest(_message.Message):
-    __slots__ = ()
-    def __init__(self) -> None: ...
+    __slots__ = ("crop", "conflate")
+    CROP_FIELD_NUMBER: _ClassVar[int]
+    CONFLATE_FIELD_NUMBER: _ClassVar[int]
+    crop: CropRegion
+    conflate: bool
+    def __init__(self, crop: _Optional[_Union[CropRegion, _Mapping]] = ..., conflate: _Optional[bool] = ...) -> None: ...
+
+class PackedLidarStreamRequest(_message.Message):
+    __slots__ = ("encoding", "crop", "conflate")
+    ENCODING_FIELD_NUMBER: _ClassVar[int]
+    CROP_FIELD_NUMBER: _ClassVar[int]
+    CONFLATE_FIELD_NUMBER: _ClassVar[int]
+    encoding: PackedEncoding
+    crop: CropRegion
+    conflate: bool
+    def __init__(self, encoding: _Optional[_Union[PackedEncoding, _Mapping]] = ..., crop: _Optional[_Union[CropRegion, _Mapping]] = ..., conflate: _Optional[bool] = ...) -> None: ...
 
 class SubSampledLidarStreamRequest(_message.Message):
-    __slots__ = ("voxel_size",)
+    __slots__ = ("voxel_size", "crop", "conflate")
     VOXEL_SIZE_FIELD_NUMBER: _ClassVar[int]
+    CROP_FIELD_NUMBER: _ClassVar[int]
+    CONFLATE_FIELD_NUMBER: _ClassVar[int]
     voxel_size: float
-    def __init__(self, voxel_size: _Optional[float] = ...) -> None: ...
+    crop: CropRegion
+    conflate: bool
+    def __init__(self, voxel_size: _Optional[float] = ..., crop: _Optional[_Union[CropRegion, _Mapping]] = ..., conflate: _Optional[bool] = ...) -> None: ...
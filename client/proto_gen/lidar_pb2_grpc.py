@@ -44,6 +44,16 @@ class LidarServiceStub(object):
                 request_serializer=lidar__pb2.SubSampledLidarStreamRequest.SerializeToString,
                 response_deserializer=lidar__pb2.PointCloud3.FromString,
                 _registered_method=True)
+        self.getPackedLidarScan = channel.unary_stream(
+                '/sensors.LidarService/getPackedLidarScan',
+                request_serializer=lidar__pb2.PackedLidarStreamRequest.SerializeToString,
+                response_deserializer=lidar__pb2.PointCloud3Packed.FromString,
+                _registered_method=True)
+        self.getDeskewedLidarScan = channel.unary_stream(
+                '/sensors.LidarService/getDeskewedLidarScan',
+                request_serializer=lidar__pb2.LidarStreamRequest.SerializeToString,
+                response_deserializer=lidar__pb2.PointCloud3.FromString,
+                _registered_method=True)
 
 
 class LidarServiceServicer(object):
@@ -61,6 +71,19 @@ class LidarServiceServicer(object):
         context.set_details('Method not implemented!')
         raise NotImplementedError('Method not implemented!')
 
+    def getPackedLidarScan(self, request, context):
+        """Missing associated documentation comment in .proto file."""
+        context.set_code(grpc.StatusCode.UNIMPLEMENTED)
+        context.set_details('Method not implemented!')
+        raise NotImplementedError('Method not implemented!')
+
+    def getDeskewedLidarScan(self, request, context):
+        """Scans rotated into the sensor frame at their last point using the IMU.
+        """
+        context.set_code(grpc.StatusCode.UNIMPLEMENTED)
+        context.set_details('Method not implemented!')
+        raise NotImplementedError('Method not implemented!')
+
 
 def add_LidarServiceServicer_to_server(servicer, server):
     rpc_method_handlers = {
@@ -74,6 +97,16 @@ def add_LidarServiceServicer_to_server(servicer, server):
                     request_deserializer=lidar__pb2.SubSampledLidarStreamRequest.FromString,
                     response_serializer=lidar__pb2.PointCloud3.SerializeToString,
             ),
+            'getPackedLidarScan': grpc.unary_stream_rpc_method_handler(
+                    servicer.getPackedLidarScan,
+                    request_deserializer=lidar__pb2.PackedLidarStreamRequest.FromString,
+                    response_serializer=lidar__pb2.PointCloud3Packed.SerializeToString,
+            ),
+            'getDeskewedLidarScan': grpc.unary_stream_rpc_method_handler(
+                    servicer.getDeskewedLidarScan,
+                    request_deserializer=lidar__pb2.LidarStreamRequest.FromString,
+                    response_serializer=lidar__pb2.PointCloud3.SerializeToString,
+            ),
     }
     generic_handler = grpc.method_handlers_generic_handler(
             'sensors.LidarService', rpc_method_handlers)
@@ -138,3 +171,57 @@ class LidarService(object):
             timeout,
             metadata,
             _registered_method=True)
+
+    @staticmethod
+    def getPackedLidarScan(request,
+            target,
+            options=(),
+            channel_credentials=None,
+            call_credentials=None,
+            insecure=False,
+            compression=None,
+            wait_for_ready=None,
+            timeout=None,
+            metadata=None):
+        return grpc.experimental.unary_stream(
+            request,
+            target,
+            '/sensors.LidarService/getPackedLidarScan',
+            lidar__pb2.PackedLidarStreamRequest.SerializeToString,
+            lidar__pb2.PointCloud3Packed.FromString,
+            options,
+            channel_credentials,
+            insecure,
+            call_credentials,
+            compression,
+            wait_for_ready,
+            timeout,
+            metadata,
+            _registered_method=True)
+
+    @staticmethod
+    def getDeskewedLidarScan(request,
+            target,
+            options=(),
+            channel_credentials=None,
+            call_credentials=None,
+            insecure=False,
+            compression=None,
+            wait_for_ready=None,
+            timeout=None,
+            metadata=None):
+        return grpc.experimental.unary_stream(
+            request,
+            target,
+            '/sensors.LidarService/getDeskewedLidarScan',
+            lidar__pb2.LidarStreamRequest.SerializeToString,
+            lidar__pb2.PointCloud3.FromString,
+            options,
+            channel_credentials,
+            insecure,
+            call_credentials,
+            compression,
+            wait_for_ready,
+            timeout,
+            metadata,
+            _registered_method=True)
@@ -0,0 +1,56 @@
+# -*- coding: utf-8 -*-
+# Generated by the protocol buffer compiler.  DO NOT EDIT!
+# NO CHECKED-IN PROTOBUF GENCODE
+# source: stats.proto
+# Protobuf Python Version: 6.31.1
+"""Generated protocol buffer code."""
+from google.protobuf import descriptor as _descriptor
+from google.protobuf import descriptor_pool as _descriptor_pool
+from google.protobuf import runtime_version as _runtime_version
+from google.protobuf import symbol_database as _symbol_database
+from google.protobuf.internal import builder as _builder
+_runtime_version.ValidateProtobufRuntimeVersion(
+    _runtime_version.Domain.PUBLIC,
+    6,
+    31,
+    1,
+    '',
+    'stats.proto'
+)
+# @@protoc_insertion_point(imports)
+
+_sym_db = _symbol_database.Default()
+
+
+
+
+DESCRIPTOR = _descriptor_pool.Default().AddSerializedFile(b'\n\x0bstats.proto\x12\x07sensors\"\x0e\n\x0cStatsRequest\"S\n\tHistogram\x12\x17\n\x0bupper_bound\x18\x01 \x03(\x01\x42\x02\x10\x01\x12\x11\n\x05\x63ount\x18\x02 \x03(\x04\x42\x02\x10\x01\x12\x0b\n\x03sum\x18\x03 \x01(\x01\x12\r\n\x05total\x18\x04 \x01(\x04\"\x89\x02\n\x06Metric\x12\x0c\n\x04name\x18\x01 \x01(\t\x12\"\n\x04type\x18\x02 \x01(\x0e\x32\x14.sensors.Metric.Type\x12+\n\x06labels\x18\x03 \x03(\x0b\x32\x1b.sensors.Metric.LabelsEntry\x12\r\n\x05value\x18\x04 \x01(\x01\x12\x0c\n\x04rate\x18\x05 \x01(\x01\x12%\n\thistogram\x18\x06 \x01(\x0b\x32\x12.sensors.Histogram\x1a-\n\x0bLabelsEntry\x12\x0b\n\x03key\x18\x01 \x01(\t\x12\r\n\x05value\x18\x02 \x01(\t:\x02\x38\x01\"-\n\x04Type\x12\x0b\n\x07\x43OUNTER\x10\x00\x12\t\n\x05GAUGE\x10\x01\x12\r\n\tHISTOGRAM\x10\x02\";\n\x05Stats\x12\x10\n\x08uptime_s\x18\x01 \x01(\x01\x12 \n\x07metrics\x18\x02 \x03(\x0b\x32\x0f.sensors.Metric\"\x1e\n\x0ePrometheusText\x12\x0c\n\x04text\x18\x01 \x01(\t2\x86\x01\n\x0cStatsService\x12\x31\n\x08getStats\x12\x15.sensors.StatsRequest\x1a\x0e.sensors.Stats\x12\x43\n\x11getPrometheusText\x12\x15.sensors.StatsRequest\x1a\x17.sensors.PrometheusTextb\x06proto3')
+
+_globals = globals()
+_builder.BuildMessageAndEnumDescriptors(DESCRIPTOR, _globals)
+_builder.BuildTopDescriptorsAndMessages(DESCRIPTOR, 'stats_pb2', _globals)
+if not _descriptor._USE_C_DESCRIPTORS:
+  DESCRIPTOR._loaded_options = None
+  _globals['_HISTOGRAM'].fields_by_name['upper_bound']._loaded_options = None
+  _globals['_HISTOGRAM'].fields_by_name['upper_bound']._serialized_options = b'\020\001'
+  _globals['_HISTOGRAM'].fields_by_name['count']._loaded_options = None
+  _globals['_HISTOGRAM'].fields_by_name['count']._serialized_options = b'\020\001'
+  _globals['_METRIC_LABELSENTRY']._loaded_options = None
+  _globals['_METRIC_LABELSENTRY']._serialized_options = b'8\001'
+  _globals['_STATSREQUEST']._serialized_start=24
+  _globals['_STATSREQUEST']._serialized_end=38
+  _globals['_HISTOGRAM']._serialized_start=40
+  _globals['_HISTOGRAM']._serialized_end=123
+  _globals['_METRIC']._serialized_start=126
+  _globals['_METRIC']._serialized_end=391
+  _globals['_METRIC_LABELSENTRY']._serialized_start=299
+  _globals['_METRIC_LABELSENTRY']._serialized_end=344
+  _globals['_METRIC_TYPE']._serialized_start=346
+  _globals['_METRIC_TYPE']._serialized_end=391
+  _globals['_STATS']._serialized_start=393
+  _globals['_STATS']._serialized_end=452
+  _globals['_PROMETHEUSTEXT']._serialized_start=454
+  _globals['_PROMETHEUSTEXT']._serialized_end=484
+  _globals['_STATSSERVICE']._serialized_start=487
+  _globals['_STATSSERVICE']._serialized_end=621
+# @@protoc_insertion_point(module_scope)
@@ -0,0 +1,143 @@
+# Generated by the gRPC Python protocol compiler plugin. DO NOT EDIT!
+"""Client and server classes corresponding to protobuf-defined services."""
+import grpc
+import warnings
+
+import stats_pb2 as stats__pb2
+
+GRPC_GENERATED_VERSION = '1.78.0'
+GRPC_VERSION = grpc.__version__
+_version_not_supported = False
+
+try:
+    from grpc._utilities import first_version_is_lower
+    _version_not_supported = first_version_is_lower(GRPC_VERSION, GRPC_GENERATED_VERSION)
+except ImportError:
+    _version_not_supported = True
+
+if _version_not_supported:
+    raise RuntimeError(
+        f'The grpc package installed is at version {GRPC_VERSION},'
+        + ' but the generated code in stats_pb2_grpc.py depends on'
+        + f' grpcio>={GRPC_GENERATED_VERSION}.'
+        + f' Please upgrade your grpc module to grpcio>={GRPC_GENERATED_VERSION}'
+        + f' or downgrade your generated code using grpcio-tools<={GRPC_VERSION}.'
+    )
+
+
+class StatsServiceStub(object):
+    """Publisher introspection: per-sensor and per-stream counters.
+    """
+
+    def __init__(self, channel):
+        """Constructor.
+
+        Args:
+            channel: A grpc.Channel.
+        """
+        self.getStats = channel.unary_unary(
+                '/sensors.StatsService/getStats',
+                request_serializer=stats__pb2.StatsRequest.SerializeToString,
+                response_deserializer=stats__pb2.Stats.FromString,
+                _registered_method=True)
+        self.getPrometheusText = channel.unary_unary(
+                '/sensors.StatsService/getPrometheusText',
+                request_serializer=stats__pb2.StatsRequest.SerializeToString,
+                response_deserializer=stats__pb2.PrometheusText.FromString,
+                _registered_method=True)
+
+
+class StatsServiceServicer(object):
+    """Publisher introspection: per-sensor and per-stream counters.
+    """
+
+    def getStats(self, request, context):
+        """Missing associated documentation comment in .proto file."""
+        context.set_code(grpc.StatusCode.UNIMPLEMENTED)
+        context.set_details('Method not implemented!')
+        raise NotImplementedError('Method not implemented!')
+
+    def getPrometheusText(self, request, context):
+        """Missing associated documentation comment in .proto file."""
+        context.set_code(grpc.StatusCode.UNIMPLEMENTED)
+        context.set_details('Method not implemented!')
+        raise NotImplementedError('Method not implemented!')
+
+
+def add_StatsServiceServicer_to_server(servicer, server):
+    rpc_method_handlers = {
+            'getStats': grpc.unary_unary_rpc_method_handler(
+                    servicer.getStats,
+                    request_deserializer=stats__pb2.StatsRequest.FromString,
+                    response_serializer=stats__pb2.Stats.SerializeToString,
+            ),
+            'getPrometheusText': grpc.unary_unary_rpc_method_handler(
+                    servicer.getPrometheusText,
+                    request_deserializer=stats__pb2.StatsRequest.FromString,
+                    response_serializer=stats__pb2.PrometheusText.SerializeToString,
+            ),
+    }
+    generic_handler = grpc.method_handlers_generic_handler(
+            'sensors.StatsService', rpc_method_handlers)
+    server.add_generic_rpc_handlers((generic_handler,))
+    server.add_registered_method_handlers('sensors.StatsService', rpc_method_handlers)
+
+
+ # This class is part of an EXPERIMENTAL API.
+class StatsService(object):
+    """Publisher introspection: per-sensor and per-stream counters.
+    """
+
+    @staticmethod
+    def getStats(request,
+            target,
+            options=(),
+            channel_credentials=None,
+            call_credentials=None,
+            insecure=False,
+            compression=None,
+            wait_for_ready=None,
+            timeout=None,
+            metadata=None):
+        return grpc.experimental.unary_unary(
+            request,
+            target,
+            '/sensors.StatsService/getStats',
+            stats__pb2.StatsRequest.SerializeToString,
+            stats__pb2.Stats.FromString,
+            options,
+            channel_credentials,
+            insecure,
+            call_credentials,
+            compression,
+            wait_for_ready,
+            timeout,
+            metadata,
+            _registered_method=True)
+
+    @staticmethod
+    def getPrometheusText(request,
+            target,
+            options=(),
+            channel_credentials=None,
+            call_credentials=None,
+            insecure=False,
+            compression=None,
+            wait_for_ready=None,
+            timeout=None,
+            metadata=None):
+        return grpc.experimental.unary_unary(
+            request,
+            target,
+            '/sensors.StatsService/getPrometheusText',
+            stats__pb2.StatsRequest.SerializeToString,
+            stats__pb2.PrometheusText.FromString,
+            options,
+            channel_credentials,
+            insecure,
+            call_credentials,
+            compression,
+            wait_for_ready,
+            timeout,
+            metadata,
+            _registered_method=True)
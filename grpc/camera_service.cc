@@ -1,40 +1,107 @@
-
 #include "camera_service.hh"
+#include "hub_stream_reactor.hh"
 #include "msensor/conversions/conversions.hh"
+#include <chrono>
 
-CameraServiceImpl::CameraServiceImpl(std::shared_ptr<msensor::ICamera> camera)
-    : camera_(camera) {}
-
-::grpc::Status CameraServiceImpl::getCameraFrame(
-    ::grpc::ServerContext *context,
-    const ::sensors::CameraStreamRequest *request,
-    ::grpc::ServerWriter<::sensors::CameraStreamReply> *writer) {
-
-  static bool s_client_connected = false;
+constexpr size_t g_cameraHubCapacity = 2;
+/// Frames held by the frame hub, plus the one being read and one in use.
+constexpr size_t g_framePoolCapacity = g_cameraHubCapacity + 2;
+/// Back-off after a failed read, so a closed camera does not spin.
+constexpr auto g_readRetryDelay = std::chrono::milliseconds(10);
 
-  if (!camera_) {
-    return grpc::Status(grpc::StatusCode::UNAVAILABLE, "Camera not available");
+CameraServiceImpl::CameraServiceImpl(
+    std::shared_ptr<msensor::ICamera> camera,
+    std::shared_ptr<msensor::metrics::Registry> metrics)
+    : camera_(camera), metrics_(metrics),
+      hub_(std::make_shared<CameraHub>(g_cameraHubCapacity)),
+      frames_(std::make_shared<FrameHub>(g_cameraHubCapacity)),
+      frame_pool_(g_framePoolCapacity, [] {
+        return std::make_shared<msensor::CameraFrame>();
+      }) {
+  if (camera_ && metrics_) {
+    metrics_->callback(msensor::metrics::Type::Counter,
+                       "msensor_published_total",
+                       "Items published by a sensor's producer.",
+                       {{"sensor", "camera"}},
+                       [hub = hub_] { return hub->published(); });
+    encode_us_ = metrics_->histogram("msensor_camera_encode_us",
+                                     "JPEG encoding time per frame, in us.");
   }
-
-  if (s_client_connected) {
-    return grpc::Status(grpc::StatusCode::RESOURCE_EXHAUSTED,
-                        "Only one client per stream supported");
+  if (camera_) {
+    producer_ = std::jthread(
+        [this](std::stop_token stop_token) { produce(stop_token); });
   }
+}
 
-  std::cout << "Start camera stream." << std::endl;
-
-  s_client_connected = true;
+void CameraServiceImpl::produce(std::stop_token stop_token) {
+  while (!stop_token.stop_requested()) {
+    // Pooled: frames reach in-process consumers without a copy.
+    auto frame = frame_pool_.acquire();
+    if (camera_->read(*frame)) {
+      if (frames_->hasListeners()) {
+        frames_->publish(frame);
+      }
+      if (!hub_->hasListeners()) {
+        continue; // nobody streaming: skip the JPEG encoding
+      }
+      const auto encode_start = std::chrono::steady_clock::now();
+      auto reply = serializeToSlice(toProtobuf(*frame));
+      if (encode_us_) {
+        encode_us_->observe(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - encode_start)
+                .count());
+      }
+      hub_->publish(std::move(reply));
+    } else {
+      std::this_thread::sleep_for(g_readRetryDelay);
+    }
+  }
+}
 
-  while (!context->IsCancelled()) {
+class CameraFrameReactor
+    : public HubStreamReactor<grpc::ServerWriteReactor<grpc::ByteBuffer>,
+                              CameraHub, grpc::ByteBuffer> {
+public:
+  CameraFrameReactor(
+      std::shared_ptr<CameraHub> hub, bool conflate = false,
+      std::shared_ptr<msensor::metrics::Registry> metrics = nullptr)
+      : HubStreamReactor(hub, "camera", std::move(metrics)) {
+    if (!hub_) {
+      return; // finished as unavailable by the caller
+    }
+    SetConflate(conflate);
+    Start();
+  }
 
-    msensor::CameraFrame frame;
-    if (camera_->read(frame)) {
-      writer->Write(toProtobuf(frame));
+private:
+  const grpc::ByteBuffer *NextResponse() override {
+    auto reply = ReadNext();
+    if (!reply) {
+      return nullptr;
     }
+    // References the shared bytes until the write completes.
+    response_ = WithSkipped<sensors::CameraStreamReply>(*reply);
+    return &response_;
   }
 
-  std::cout << "Ending camera stream." << std::endl;
-  s_client_connected = false;
+  grpc::ByteBuffer response_;
+};
 
-  return ::grpc::Status::OK;
+grpc::ServerWriteReactor<grpc::ByteBuffer> *
+CameraServiceImpl::getCameraFrame(grpc::CallbackServerContext * /*context*/,
+                                  const grpc::ByteBuffer *request) {
+  sensors::CameraStreamRequest parsed;
+  grpc::ByteBuffer serialized(*request);
+  const grpc::Status status =
+      grpc::SerializationTraits<sensors::CameraStreamRequest>::Deserialize(
+          &serialized, &parsed);
+  if (!camera_ || !status.ok()) {
+    auto *reactor = new CameraFrameReactor(nullptr);
+    reactor->Finish(status.ok() ? grpc::Status(grpc::StatusCode::UNAVAILABLE,
+                                               "Camera not available")
+                                : status);
+    return reactor;
+  }
+  return new CameraFrameReactor(hub_, parsed.conflate(), metrics_);
 }
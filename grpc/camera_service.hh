@@ -1,20 +1,56 @@
 #pragma once
 
+#include <thread>
+
 #include "camera.grpc.pb.h"
+#include "msensor/concurrency/broadcast_hub.hh"
+#include "msensor/concurrency/object_pool.hh"
 #include "msensor/interface/ICamera.hh"
+#include "msensor/metrics/metrics.hh"
+
+/// Broadcast ring of encoded frames shared by every camera stream, as
+/// serialized `CameraStreamReply` messages.
+using CameraHub = msensor::BroadcastHub<grpc::Slice>;
+/// Broadcast ring of raw frames, for in-process consumers.
+using FrameHub =
+    msensor::BroadcastHub<std::shared_ptr<const msensor::CameraFrame>>;
 
 /**
- * @brief Implements the Camera gRPC service.
+ * @brief Implements the Camera gRPC service using the callback API.
+ *
+ * A single producer thread reads and JPEG-encodes each frame once, then
+ * publishes it into a `CameraHub`. Every stream writes the same serialized
+ * message, so adding clients costs no extra encoding nor serialization.
  */
-class CameraServiceImpl : public sensors::CameraService::Service {
+class CameraServiceImpl
+    : public sensors::CameraService::WithRawCallbackMethod_getCameraFrame<
+          sensors::CameraService::Service> {
 public:
-  CameraServiceImpl(std::shared_ptr<msensor::ICamera> camera);
+  CameraServiceImpl(
+      std::shared_ptr<msensor::ICamera> camera,
+      std::shared_ptr<msensor::metrics::Registry> metrics = nullptr);
 
-  ::grpc::Status getCameraFrame(
-      ::grpc::ServerContext *context,
-      const ::sensors::CameraStreamRequest *request,
-      ::grpc::ServerWriter<::sensors::CameraStreamReply> *writer) override;
+  /// Raw: takes a serialized `CameraStreamRequest` and writes serialized
+  /// `CameraStreamReply` messages.
+  grpc::ServerWriteReactor<grpc::ByteBuffer> *
+  getCameraFrame(grpc::CallbackServerContext *context,
+                 const grpc::ByteBuffer *request) override;
+
+  /// Hub of raw frames, for in-process consumers such as the shared-memory
+  /// publisher. Null without a camera.
+  std::shared_ptr<FrameHub> frames() const {
+    return camera_ ? frames_ : nullptr;
+  }
 
 private:
+  /// Producer loop: reads frames, encodes them and publishes them.
+  void produce(std::stop_token stop_token);
+
   std::shared_ptr<msensor::ICamera> camera_;
+  std::shared_ptr<msensor::metrics::Registry> metrics_;
+  std::shared_ptr<msensor::metrics::Histogram> encode_us_;
+  std::shared_ptr<CameraHub> hub_;
+  std::shared_ptr<FrameHub> frames_;
+  msensor::ObjectPool<msensor::CameraFrame> frame_pool_;
+  std::jthread producer_; ///< Declared last: joined before the hub is freed.
 };
@@ -0,0 +1,376 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+
+#include <grpcpp/alarm.h>
+#include <grpcpp/grpcpp.h>
+
+#include "msensor/metrics/metrics.hh"
+#include "msensor/timing/trace.hh"
+
+/// Id of the next stream, used to label its metrics.
+inline std::atomic<uint64_t> g_nextStreamId{0};
+
+/// Stamp the write-start trace checkpoint of a message about to be written.
+template <typename Message> void stampWriteStart(Message *message) {
+  if (timing::tracingEnabled()) {
+    message->mutable_header()->mutable_trace()->set_write_start_ns(
+        timing::getEpochTimeNs());
+  }
+}
+
+/// Serialize `message` once, into a slice that any number of streams can
+/// write without copying it.
+template <typename Message>
+grpc::Slice serializeToSlice(const Message &message) {
+  grpc::Slice slice(message.ByteSizeLong());
+  message.SerializeWithCachedSizesToArray(
+      const_cast<uint8_t *>(slice.begin()));
+  return slice;
+}
+
+/**
+ * @brief Metrics of one open stream, labelled with its RPC and a stream id.
+ * They are removed from the registry when the stream ends. The number of
+ * open streams per RPC is kept in `msensor_stream_clients`.
+ */
+struct StreamMetrics {
+  StreamMetrics(std::shared_ptr<msensor::metrics::Registry> registry_,
+                const std::string &rpc)
+      : registry(std::move(registry_)),
+        labels{{"rpc", rpc}, {"stream", std::to_string(g_nextStreamId++)}},
+        clients(registry->gauge("msensor_stream_clients",
+                                "Open streams per RPC.", {{"rpc", rpc}})),
+        messages(registry->counter("msensor_stream_messages_total",
+                                   "Messages written.", labels)),
+        bytes(registry->counter("msensor_stream_bytes_total",
+                                "Serialized bytes written.", labels)),
+        skipped(registry->counter(
+            "msensor_stream_skipped_total",
+            "Hub items overwritten before the stream read them.", labels)),
+        lag(registry->gauge("msensor_stream_lag",
+                            "Hub items published but not yet read.", labels)),
+        convert_us(registry->histogram(
+            "msensor_stream_convert_us",
+            "Time to build a message from the hub, in us.", labels)),
+        serialize_us(registry->histogram(
+            "msensor_stream_serialize_us",
+            "Time spent in StartWrite serializing a message, in us.", labels)),
+        write_us(registry->histogram(
+            "msensor_stream_write_us",
+            "Time from StartWrite to OnWriteDone, in us.", labels)) {
+    clients->add(1);
+  }
+
+  ~StreamMetrics() {
+    clients->add(-1);
+    registry->remove({{"stream", labels.at("stream")}});
+  }
+
+  StreamMetrics(const StreamMetrics &) = delete;
+  StreamMetrics &operator=(const StreamMetrics &) = delete;
+
+  const std::shared_ptr<msensor::metrics::Registry> registry;
+  const msensor::metrics::Labels labels;
+  const std::shared_ptr<msensor::metrics::Gauge> clients;
+  const std::shared_ptr<msensor::metrics::Counter> messages;
+  const std::shared_ptr<msensor::metrics::Counter> bytes;
+  const std::shared_ptr<msensor::metrics::Counter> skipped;
+  const std::shared_ptr<msensor::metrics::Gauge> lag;
+  const std::shared_ptr<msensor::metrics::Histogram> convert_us;
+  const std::shared_ptr<msensor::metrics::Histogram> serialize_us;
+  const std::shared_ptr<msensor::metrics::Histogram> write_us;
+};
+
+/**
+ * @brief Event-driven server-streaming reactor fed by a `BroadcastHub`.
+ *
+ * A write starts either from `OnWriteDone` (data already queued), from a
+ * wake-up the hub producer thread schedules when new data is published, or
+ * from an optional alarm. Messages are always built on gRPC callback
+ * threads: the producer thread only schedules the wake-up, so it is not held
+ * up by the number of streams. No gRPC callback thread ever blocks waiting
+ * for sensor data. Derived
+ * classes implement `NextResponse()` and call `Start()` at the end of their
+ * constructor. Given a metrics registry, the stream reports its traffic,
+ * hub lag and per-stage timings while it is open.
+ *
+ * A stream reads every item in order, skipping those the hub overwrote
+ * before it got to them. In conflate mode it reads only the newest item
+ * each time a write completes, so a slow client gets fresh data instead of
+ * a backlog. Either way, messages report the items skipped before them in
+ * `Header.skipped`.
+ *
+ * Streams of messages shared by several clients are raw (`Response` is
+ * `grpc::ByteBuffer`): they write the message serialized once, see
+ * `WithSkipped()`.
+ *
+ * @tparam Base `grpc::ServerWriteReactor<Response>` or
+ * `grpc::ServerBidiReactor<Request, Response>`.
+ * @tparam Hub `msensor::BroadcastHub` the stream reads from.
+ * @tparam Response Message type written to the stream.
+ */
+template <typename Base, typename Hub, typename Response>
+class HubStreamReactor : public Base {
+public:
+  void OnWriteDone(bool ok) override {
+    {
+      std::scoped_lock lock(mutex_);
+      write_pending_ = false;
+      if (ok && metrics_) {
+        metrics_->messages->add();
+        metrics_->bytes->add(SerializedBytes(*written_));
+        metrics_->write_us->observe(microsecondsSince(write_started_));
+      }
+      if (!ok || cancelled_) {
+        FinishLocked();
+        return;
+      }
+    }
+    TryWrite();
+  }
+
+  void OnCancel() override {
+    std::cout << "Ending " << name_ << " stream." << std::endl;
+    std::scoped_lock lock(mutex_);
+    cancelled_ = true;
+    if (!write_pending_) {
+      FinishLocked();
+    }
+  }
+
+  void OnDone() override {
+    if (hub_) {
+      hub_->removeListener(listener_id_);
+    }
+
+    bool cancel_alarm;
+    {
+      std::scoped_lock lock(mutex_);
+      metrics_.reset();
+      done_ = true;
+      cancel_alarm = alarm_armed_;
+      ++refs_; // keep alive while cancelling
+    }
+    if (cancel_alarm) {
+      alarm_->Cancel();
+    }
+    Unref();
+  }
+
+protected:
+  HubStreamReactor(
+      std::shared_ptr<Hub> hub, std::string name,
+      std::shared_ptr<msensor::metrics::Registry> metrics = nullptr)
+      : hub_(hub), cursor_(hub ? hub->subscribe() : typename Hub::Cursor{}),
+        name_(std::move(name)), registry_(std::move(metrics)) {}
+
+  /// Register with the hub and attempt the first write.
+  void Start() {
+    std::cout << "Start " << name_ << " stream." << std::endl;
+    if (registry_) {
+      metrics_.emplace(registry_, name_);
+    }
+    listener_id_ = hub_->addListener([this] { Wake(); });
+    TryWrite();
+  }
+
+  /**
+   * @brief Build the next message from the hub.
+   *
+   * Called with the reactor mutex held and no write in flight. The returned
+   * message must stay valid until the next call.
+   * @return Message to write, or nullptr if nothing is ready yet.
+   */
+  virtual const Response *NextResponse() = 0;
+
+  /// Read the next hub item for this stream: the oldest unread one, or the
+  /// newest in conflate mode. Only callable from `NextResponse()`.
+  auto ReadNext() {
+    return conflate_.load() ? hub_->readLatest(cursor_) : hub_->read(cursor_);
+  }
+
+  /// Keep only the newest item whenever a write completes, skipping the
+  /// rest, instead of streaming every item.
+  void SetConflate(bool conflate) { conflate_.store(conflate); }
+
+  /// Hub items skipped since the previous call, i.e. to be reported in the
+  /// header of the message being built.
+  uint32_t TakeSkipped() {
+    const auto skipped = static_cast<uint32_t>(cursor_.skipped - reported_);
+    reported_ = cursor_.skipped;
+    return skipped;
+  }
+
+  /**
+   * @brief The serialized `Message` `shared`, followed if items were skipped
+   * since the previous message by a serialized header reporting them.
+   *
+   * For messages shared by several streams, which cannot be stamped in
+   * place: parsers merge the second header into the first, so the shared
+   * bytes are written as they are, without a copy.
+   */
+  template <typename Message>
+  grpc::ByteBuffer WithSkipped(const grpc::Slice &shared) {
+    const uint32_t skipped = TakeSkipped();
+    if (skipped == 0) {
+      return grpc::ByteBuffer(&shared, 1);
+    }
+    Message report;
+    report.mutable_header()->set_skipped(skipped);
+    const grpc::Slice slices[] = {shared, serializeToSlice(report)};
+    return grpc::ByteBuffer(slices, 2);
+  }
+
+  /// Retry `NextResponse()` at `deadline` even if nothing is published.
+  /// Only callable from `NextResponse()`.
+  void WakeUpAt(std::chrono::steady_clock::time_point deadline) {
+    if (alarm_armed_ || done_) {
+      return; // a pending alarm re-evaluates the deadline when it fires
+    }
+    alarm_armed_ = true;
+    ++refs_;
+    // grpc::Alarm only accepts system_clock deadlines.
+    const auto system_deadline =
+        std::chrono::system_clock::now() +
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            deadline - std::chrono::steady_clock::now());
+    alarm_ = std::make_unique<grpc::Alarm>();
+    alarm_->Set(system_deadline, [this](bool ok) { OnAlarm(ok); });
+  }
+
+  std::shared_ptr<Hub> hub_;
+  typename Hub::Cursor cursor_;
+
+private:
+  std::atomic<bool> conflate_{false};
+  uint64_t reported_ = 0; ///< `cursor_.skipped` at the last `TakeSkipped()`.
+
+  using Clock = std::chrono::steady_clock;
+
+  static uint64_t microsecondsSince(Clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() -
+                                                                 start)
+        .count();
+  }
+
+  static size_t SerializedBytes(const grpc::ByteBuffer &buffer) {
+    return buffer.Length();
+  }
+  template <typename Message>
+  static size_t SerializedBytes(const Message &message) {
+    return message.GetCachedSize(); // cached by gRPC when it serialized it
+  }
+
+  /// Hub listener: schedule `TryWrite()` on a gRPC callback thread, through
+  /// an alarm that has already expired.
+  void Wake() {
+    std::scoped_lock lock(mutex_);
+    if (write_pending_ || finished_ || wake_armed_) {
+      return; // OnWriteDone or the pending wake-up reads the new item
+    }
+    wake_armed_ = true;
+    ++refs_;
+    wake_alarm_ = std::make_unique<grpc::Alarm>();
+    wake_alarm_->Set(std::chrono::system_clock::now(), [this](bool ok) {
+      {
+        std::scoped_lock lock(mutex_);
+        wake_armed_ = false;
+      }
+      if (ok) {
+        TryWrite();
+      }
+      Unref();
+    });
+  }
+
+  /// Start a write if none is in flight and a message is ready.
+  void TryWrite() {
+    std::scoped_lock lock(mutex_);
+    if (write_pending_ || finished_) {
+      return;
+    }
+    if (!metrics_) {
+      if (const Response *response = NextResponse()) {
+        write_pending_ = true;
+        this->StartWrite(response);
+      }
+      return;
+    }
+
+    const auto convert_start = Clock::now();
+    const Response *response = NextResponse();
+    if (!response) {
+      return;
+    }
+    write_started_ = Clock::now();
+    metrics_->convert_us->observe(
+        std::chrono::duration_cast<std::chrono::microseconds>(write_started_ -
+                                                              convert_start)
+            .count());
+    metrics_->skipped->add(cursor_.skipped - skipped_seen_);
+    skipped_seen_ = cursor_.skipped;
+    metrics_->lag->set(static_cast<int64_t>(hub_->published() - cursor_.next));
+
+    written_ = response;
+    write_pending_ = true;
+    this->StartWrite(response);
+    metrics_->serialize_us->observe(microsecondsSince(write_started_));
+  }
+
+  void FinishLocked() {
+    if (!finished_) {
+      finished_ = true;
+      this->Finish(grpc::Status::OK);
+    }
+  }
+
+  void OnAlarm(bool ok) {
+    {
+      std::scoped_lock lock(mutex_);
+      alarm_armed_ = false;
+    }
+    if (ok) {
+      TryWrite();
+    }
+    Unref();
+  }
+
+  /// The reactor is deleted once gRPC is done with it and no alarm callback
+  /// is pending.
+  void Unref() {
+    bool last;
+    {
+      std::scoped_lock lock(mutex_);
+      last = --refs_ == 0 && done_;
+    }
+    if (last) {
+      delete this;
+    }
+  }
+
+  std::string name_;
+  std::shared_ptr<msensor::metrics::Registry> registry_;
+  std::optional<StreamMetrics> metrics_;
+  const Response *written_ = nullptr;
+  Clock::time_point write_started_;
+  uint64_t skipped_seen_ = 0;
+  uint64_t listener_id_ = 0;
+  std::unique_ptr<grpc::Alarm> alarm_;
+  std::unique_ptr<grpc::Alarm> wake_alarm_;
+
+  std::mutex mutex_;
+  bool write_pending_ = false;
+  bool cancelled_ = false;
+  bool finished_ = false;
+  bool done_ = false;
+  bool alarm_armed_ = false;
+  bool wake_armed_ = false;
+  int refs_ = 0;
+};
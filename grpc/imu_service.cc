@@ -1,40 +1,175 @@
-
 #include "imu_service.hh"
+#include "hub_stream_reactor.hh"
 #include "msensor/conversions/conversions.hh"
-#include <thread>
+#include <algorithm>
+#include <chrono>
+
+constexpr size_t g_imuHubCapacity = 1024;
+/// Upper bound on how long the producer sleeps before re-checking for stop.
+constexpr auto g_producerWaitTimeout = std::chrono::milliseconds(100);
+/// Producer sleep while no stream or in-process consumer listens.
+constexpr auto g_idleDelay = std::chrono::milliseconds(100);
+constexpr uint32_t g_defaultBatchSamples = 32;
+constexpr uint32_t g_maxBatchSamples = 4096;
+constexpr uint32_t g_defaultBatchLatencyMs = 20;
 
-ImuServiceImpl::ImuServiceImpl(std::shared_ptr<msensor::IImu> imu)
-    : imu_(imu) {}
+ImuServiceImpl::ImuServiceImpl(
+    std::shared_ptr<msensor::IImu> imu,
+    std::shared_ptr<msensor::metrics::Registry> metrics)
+    : imu_(imu), metrics_(metrics),
+      hub_(std::make_shared<ImuHub>(g_imuHubCapacity)) {
+  if (imu_) {
+    producer_ = std::jthread(
+        [this](std::stop_token stop_token) { produce(stop_token); });
+  }
+  if (imu_ && metrics_) {
+    metrics_->callback(msensor::metrics::Type::Counter,
+                       "msensor_published_total",
+                       "Items published by a sensor's producer.",
+                       {{"sensor", "imu"}},
+                       [hub = hub_] { return hub->published(); });
+  }
+}
+
+void ImuServiceImpl::produce(std::stop_token stop_token) {
+  while (!stop_token.stop_requested()) {
+    if (!hub_->hasListeners()) {
+      // Nobody to publish to: leave the driver alone. Queueing drivers keep
+      // their newest samples meanwhile.
+      std::this_thread::sleep_for(g_idleDelay);
+      continue;
+    }
+    if (!imu_->waitForImuData(g_producerWaitTimeout)) {
+      continue;
+    }
+    if (const auto imu_data = imu_->getImuData()) {
+      hub_->publish(*imu_data);
+    }
+  }
+}
 
-::grpc::Status
-ImuServiceImpl::getImuData(::grpc::ServerContext *context,
-                           const ::sensors::ImuStreamRequest *request,
-                           ::grpc::ServerWriter<sensors::IMUData> *writer) {
+// ---------------------------------------------------------------------------
+// getImuData — one sample per message
+// ---------------------------------------------------------------------------
 
-  static bool s_client_connected = false;
+class ImuDataReactor
+    : public HubStreamReactor<grpc::ServerWriteReactor<sensors::IMUData>,
+                              ImuHub, sensors::IMUData> {
+public:
+  ImuDataReactor(
+      std::shared_ptr<ImuHub> hub,
+      std::shared_ptr<msensor::metrics::Registry> metrics = nullptr)
+      : HubStreamReactor(hub, "IMU data", std::move(metrics)) {
+    if (!hub_) {
+      return; // finished as unavailable by the caller
+    }
+    Start();
+  }
 
+private:
+  const sensors::IMUData *NextResponse() override {
+    const auto imu_data = hub_->read(cursor_);
+    if (!imu_data) {
+      return nullptr;
+    }
+    response_ = toProtobuf(*imu_data);
+    response_.mutable_header()->set_skipped(TakeSkipped());
+    stampWriteStart(&response_);
+    return &response_;
+  }
+
+  sensors::IMUData response_;
+};
+
+grpc::ServerWriteReactor<sensors::IMUData> *
+ImuServiceImpl::getImuData(grpc::CallbackServerContext * /*context*/,
+                           const sensors::ImuStreamRequest * /*request*/) {
   if (!imu_) {
-    return grpc::Status(grpc::StatusCode::UNAVAILABLE, "IMU not available");
+    auto *reactor = new ImuDataReactor(nullptr);
+    reactor->Finish(
+        grpc::Status(grpc::StatusCode::UNAVAILABLE, "IMU not available"));
+    return reactor;
   }
+  return new ImuDataReactor(hub_, metrics_);
+}
+
+// ---------------------------------------------------------------------------
+// getImuBatch — columnar batches bounded by size and latency
+//
+// Samples are appended as they are published. The batch is written when it
+// is full, or when an alarm fires at the latency deadline of its oldest
+// sample.
+// ---------------------------------------------------------------------------
 
-  if (s_client_connected) {
-    return grpc::Status(grpc::StatusCode::RESOURCE_EXHAUSTED,
-                        "Only one client per stream supported");
+class ImuBatchReactor
+    : public HubStreamReactor<grpc::ServerWriteReactor<sensors::ImuBatch>,
+                              ImuHub, sensors::ImuBatch> {
+public:
+  ImuBatchReactor(
+      std::shared_ptr<ImuHub> hub, const sensors::ImuBatchRequest &request,
+      std::shared_ptr<msensor::metrics::Registry> metrics = nullptr)
+      : HubStreamReactor(hub, "IMU batch", std::move(metrics)),
+        max_samples_(static_cast<int>(
+            request.max_samples() == 0
+                ? g_defaultBatchSamples
+                : std::min(request.max_samples(), g_maxBatchSamples))),
+        max_latency_(request.max_latency_ms() == 0
+                         ? g_defaultBatchLatencyMs
+                         : request.max_latency_ms()) {
+    if (!hub_) {
+      return; // finished as unavailable by the caller
+    }
+    std::cout << "IMU batch max_samples: " << max_samples_
+              << ", max_latency_ms: " << max_latency_.count() << std::endl;
+    Start();
   }
 
-  std::cout << "Start IMU data stream." << std::endl;
+private:
+  const sensors::ImuBatch *NextResponse() override {
+    while (batch_.ax_size() < max_samples_) {
+      const auto imu_data = hub_->read(cursor_);
+      if (!imu_data) {
+        break;
+      }
+      if (batch_.ax_size() == 0) {
+        deadline_ = std::chrono::steady_clock::now() + max_latency_;
+      }
+      appendToBatch(batch_, *imu_data);
+    }
 
-  s_client_connected = true;
+    if (batch_.ax_size() == 0) {
+      return nullptr;
+    }
 
-  while (!context->IsCancelled()) {
-    if (const auto imu_data = imu_->getImuData()) {
-      writer->Write(toProtobuf(*imu_data));
+    if (batch_.ax_size() < max_samples_ &&
+        std::chrono::steady_clock::now() < deadline_) {
+      WakeUpAt(deadline_);
+      return nullptr;
     }
-    std::this_thread::sleep_for(std::chrono::microseconds(100));
+
+    sealBatch(batch_);
+    response_.Swap(&batch_);
+    batch_.Clear();
+    response_.mutable_header()->set_skipped(TakeSkipped());
+    stampWriteStart(&response_);
+    return &response_;
   }
 
-  std::cout << "Ending IMU data stream." << std::endl;
-  s_client_connected = false;
+  const int max_samples_;
+  const std::chrono::milliseconds max_latency_;
+  std::chrono::steady_clock::time_point deadline_;
+  sensors::ImuBatch batch_;
+  sensors::ImuBatch response_;
+};
 
-  return ::grpc::Status::OK;
+grpc::ServerWriteReactor<sensors::ImuBatch> *
+ImuServiceImpl::getImuBatch(grpc::CallbackServerContext * /*context*/,
+                            const sensors::ImuBatchRequest *request) {
+  if (!imu_) {
+    auto *reactor = new ImuBatchReactor(nullptr, *request);
+    reactor->Finish(
+        grpc::Status(grpc::StatusCode::UNAVAILABLE, "IMU not available"));
+    return reactor;
+  }
+  return new ImuBatchReactor(hub_, *request, metrics_);
 }
@@ -1,20 +1,49 @@
 #pragma once
 
+#include <thread>
+
 #include "imu.grpc.pb.h"
+#include "msensor/concurrency/broadcast_hub.hh"
 #include "msensor/interface/IImu.hh"
+#include "msensor/metrics/metrics.hh"
+
+/// Broadcast ring of IMU samples shared by every IMU stream.
+using ImuHub = msensor::BroadcastHub<msensor::IMUData>;
 
 /**
- * @brief Implements the IMU gRPC service.
+ * @brief Implements the IMU gRPC service using the callback API.
+ *
+ * A single producer thread drains the driver into an `ImuHub` while the hub
+ * has listeners, and leaves the driver idle otherwise. Every stream
+ * reads from the hub through its own cursor, so any number of clients can
+ * subscribe without a thread per stream.
  */
-class ImuServiceImpl : public sensors::ImuService::Service {
+class ImuServiceImpl : public sensors::ImuService::CallbackService {
 public:
-  ImuServiceImpl(std::shared_ptr<msensor::IImu> imu);
+  ImuServiceImpl(
+      std::shared_ptr<msensor::IImu> imu,
+      std::shared_ptr<msensor::metrics::Registry> metrics = nullptr);
+
+  grpc::ServerWriteReactor<sensors::IMUData> *
+  getImuData(grpc::CallbackServerContext *context,
+             const sensors::ImuStreamRequest *request) override;
 
-  ::grpc::Status
-  getImuData(::grpc::ServerContext *context,
-             const ::sensors::ImuStreamRequest *request,
-             ::grpc::ServerWriter<sensors::IMUData> *writer) override;
+  /// Stream IMU samples in columnar batches. A batch is written when it
+  /// holds `max_samples` samples or its oldest sample is `max_latency_ms` old.
+  grpc::ServerWriteReactor<sensors::ImuBatch> *
+  getImuBatch(grpc::CallbackServerContext *context,
+              const sensors::ImuBatchRequest *request) override;
+
+  /// Hub of IMU samples, for in-process consumers such as the deskew stage.
+  /// Null without an IMU.
+  std::shared_ptr<ImuHub> hub() const { return imu_ ? hub_ : nullptr; }
 
 private:
+  /// Producer loop: pulls samples from the driver and publishes them.
+  void produce(std::stop_token stop_token);
+
   std::shared_ptr<msensor::IImu> imu_;
+  std::shared_ptr<msensor::metrics::Registry> metrics_;
+  std::shared_ptr<ImuHub> hub_;
+  std::jthread producer_; ///< Declared last: joined before the hub is freed.
 };
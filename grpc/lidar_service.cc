@@ -1,140 +1,371 @@
 #include "lidar_service.hh"
+#include "hub_stream_reactor.hh"
 #include "msensor/conversions/conversions.hh"
-#include <atomic>
+#include "msensor/processing/crop.hh"
+#include "msensor/processing/deskew.hh"
 #include <chrono>
-#include <pcl/filters/voxel_grid.h>
+#include <deque>
+#include <google/protobuf/arena.h>
+#include <mutex>
 #include <thread>
 
-LidarServiceImpl::LidarServiceImpl(std::shared_ptr<msensor::ILidar> lidar)
-    : lidar_(lidar) {}
+constexpr size_t g_scanHubCapacity = 8;
+/// Upper bound on how long the producer sleeps before re-checking for stop.
+constexpr auto g_producerWaitTimeout = std::chrono::milliseconds(100);
+/// Scans kept waiting for IMU coverage before the oldest is dropped.
+constexpr size_t g_maxPendingDeskew = 4;
 
-// ---------------------------------------------------------------------------
-// getLidarScan — server-streaming via WriteReactor
-// ---------------------------------------------------------------------------
+// Each stream owns an arena and one response message allocated on it. The
+// response is refilled in place for every scan, so its packed fields keep
+// their capacity and steady-state streaming does not allocate. Arena memory
+// is only released when the stream ends; growth past the largest scan seen is
+// geometric, so the footprint stays bounded.
+using google::protobuf::Arena;
 
-class LidarScanReactor : public grpc::ServerWriteReactor<sensors::PointCloud3> {
-public:
-  LidarScanReactor(std::shared_ptr<msensor::ILidar> lidar) : lidar_(lidar) {
-    std::cout << "Start Lidar scan stream." << std::endl;
-    NextWrite();
+LidarServiceImpl::LidarServiceImpl(
+    std::shared_ptr<msensor::ILidar> lidar,
+    std::shared_ptr<msensor::metrics::Registry> metrics)
+    : lidar_(lidar), metrics_(metrics),
+      hub_(std::make_shared<ScanHub>(g_scanHubCapacity)),
+      subsample_cache_(
+          std::make_shared<SubsampleCache>(g_scanHubCapacity, metrics)),
+      deskew_pool_(g_scanHubCapacity + g_maxPendingDeskew,
+                   [] { return std::make_shared<msensor::Scan3DI>(); }) {
+  if (lidar_) {
+    producer_ = std::jthread(
+        [this](std::stop_token stop_token) { produce(stop_token); });
+  }
+  if (lidar_ && metrics_) {
+    metrics_->callback(msensor::metrics::Type::Counter,
+                       "msensor_published_total",
+                       "Items published by a sensor's producer.",
+                       {{"sensor", "lidar"}},
+                       [hub = hub_] { return hub->published(); });
   }
+}
 
-  void OnWriteDone(bool ok) override {
-    if (!ok) {
-      Finish(grpc::Status::OK);
-      return;
+void LidarServiceImpl::produce(std::stop_token stop_token) {
+  while (!stop_token.stop_requested()) {
+    if (!lidar_->waitForScan(g_producerWaitTimeout)) {
+      continue;
+    }
+    if (auto scan = lidar_->getScan()) {
+      hub_->publish(std::move(scan));
     }
-    NextWrite();
   }
+}
 
-  void OnCancel() override {
-    std::cout << "Ending Lidar scan stream." << std::endl;
+void LidarServiceImpl::enableDeskew(std::shared_ptr<ImuHub> imu_hub) {
+  if (!lidar_ || !imu_hub || deskewed_hub_) {
+    return;
+  }
+  deskewed_hub_ = std::make_shared<ScanHub>(g_scanHubCapacity);
+  if (metrics_) {
+    metrics_->callback(msensor::metrics::Type::Counter,
+                       "msensor_published_total",
+                       "Items published by a sensor's producer.",
+                       {{"sensor", "lidar_deskewed"}},
+                       [hub = deskewed_hub_] { return hub->published(); });
   }
+  deskew_thread_ = std::jthread(
+      [this, imu_hub](std::stop_token stop_token) {
+        deskew(stop_token, imu_hub);
+      });
+}
+
+void LidarServiceImpl::deskew(std::stop_token stop_token,
+                              std::shared_ptr<ImuHub> imu_hub) {
+  auto scan_cursor = hub_->subscribe();
+  auto imu_cursor = imu_hub->subscribe();
+  const auto scan_listener =
+      hub_->addListener([this] { deskew_ready_.notify(); });
+  const auto imu_listener =
+      imu_hub->addListener([this] { deskew_ready_.notify(); });
+
+  msensor::ImuDeskewer deskewer;
+  std::deque<std::shared_ptr<const msensor::Scan3DI>> pending;
+
+  while (!stop_token.stop_requested()) {
+    deskew_ready_.waitFor(g_producerWaitTimeout);
+    while (const auto imu = imu_hub->read(imu_cursor)) {
+      deskewer.addImu(*imu);
+    }
+    while (auto scan = hub_->read(scan_cursor)) {
+      pending.push_back(std::move(*scan));
+    }
+
+    // IMU samples are still consumed while nobody listens, so the deskewer
+    // is ready as soon as a client subscribes.
+    if (!deskewed_hub_->hasListeners()) {
+      pending.clear();
+      continue;
+    }
 
-  void OnDone() override { delete this; }
+    while (!pending.empty()) {
+      const auto &scan = pending.front();
+      if (scan->time_offsets_us.empty()) {
+        pending.pop_front(); // lidar without per-point times
+        continue;
+      }
+      if (!deskewer.covers(*scan)) {
+        if (pending.size() <= g_maxPendingDeskew) {
+          break; // wait for the IMU to catch up
+        }
+        std::cout << "Deskew: no IMU data for scan "
+                  << scan->header.sequence_number << ", dropping it."
+                  << std::endl;
+        pending.pop_front();
+        continue;
+      }
+
+      auto deskewed = deskew_pool_.acquire();
+      if (deskewer.deskew(*scan, *deskewed)) {
+        deskewed_hub_->publish(std::move(deskewed));
+      }
+      pending.pop_front();
+    }
+  }
+
+  hub_->removeListener(scan_listener);
+  imu_hub->removeListener(imu_listener);
+}
+
+/// Crop applied by one stream to the scans it reads.
+class StreamCrop {
+public:
+  explicit StreamCrop(const msensor::CropRegion &region)
+      : region_(region), active_(!region.keepsAll()) {}
+
+  /// `scan` itself if the region keeps every point, else its cropped copy,
+  /// valid until the next call.
+  std::shared_ptr<const msensor::Scan3DI>
+  apply(const std::shared_ptr<const msensor::Scan3DI> &scan) {
+    if (!active_) {
+      return scan;
+    }
+    msensor::crop(*scan, region_, *cropped_);
+    return cropped_;
+  }
+
+private:
+  const msensor::CropRegion region_;
+  const bool active_;
+  std::shared_ptr<msensor::Scan3DI> cropped_ =
+      std::make_shared<msensor::Scan3DI>();
+};
+
+// ---------------------------------------------------------------------------
+// getLidarScan — server-streaming via WriteReactor
+//
+// Writes are event driven (see HubStreamReactor): a write starts from
+// OnWriteDone or from a wake-up scheduled when a new scan is published.
+// ---------------------------------------------------------------------------
+
+class LidarScanReactor
+    : public HubStreamReactor<grpc::ServerWriteReactor<sensors::PointCloud3>,
+                              ScanHub, sensors::PointCloud3> {
+public:
+  LidarScanReactor(
+      std::shared_ptr<ScanHub> hub,
+      const sensors::LidarStreamRequest &request = {},
+      std::string name = "Lidar scan",
+      std::shared_ptr<msensor::metrics::Registry> metrics = nullptr)
+      : HubStreamReactor(hub, std::move(name), std::move(metrics)),
+        crop_(fromProtobuf(request.crop())) {
+    if (!hub_) {
+      return; // finished as unavailable by the caller
+    }
+    SetConflate(request.conflate());
+    Start();
+  }
 
 private:
-  void NextWrite() {
-    std::shared_ptr<msensor::Scan3DI> scan;
-    while (!(scan = lidar_->getScan())) {
-      /// TODO: can we prevent sleep??
-      std::this_thread::sleep_for(std::chrono::microseconds(100));
+  const sensors::PointCloud3 *NextResponse() override {
+    const auto scan = ReadNext();
+    if (!scan) {
+      return nullptr;
     }
-    response_ = toProtobuf(scan);
-    StartWrite(&response_);
+    toProtobuf(crop_.apply(*scan), response_);
+    response_->mutable_header()->set_skipped(TakeSkipped());
+    stampWriteStart(response_);
+    return response_;
   }
 
-  std::shared_ptr<msensor::ILidar> lidar_;
-  sensors::PointCloud3 response_;
+  StreamCrop crop_;
+  Arena arena_;
+  sensors::PointCloud3 *response_ =
+      Arena::CreateMessage<sensors::PointCloud3>(&arena_);
 };
 
 grpc::ServerWriteReactor<sensors::PointCloud3> *LidarServiceImpl::getLidarScan(
     grpc::CallbackServerContext * /*context*/,
-    const sensors::LidarStreamRequest * /*request*/) {
+    const sensors::LidarStreamRequest *request) {
   if (!lidar_) {
     auto *reactor = new LidarScanReactor(nullptr);
     reactor->Finish(
         grpc::Status(grpc::StatusCode::UNAVAILABLE, "Lidar not available"));
     return reactor;
   }
-  return new LidarScanReactor(lidar_);
+  return new LidarScanReactor(hub_, *request, "Lidar scan", metrics_);
 }
 
 // ---------------------------------------------------------------------------
 // getSubSampledLidarScan — bidi streaming via BidiReactor
 //
 // Reads and writes are fully independent:
-//   - OnReadDone:  updates the voxel size when the client sends a new value
-//   - OnWriteDone: gets the next scan, filters it, and writes it back
+//   - OnReadDone:  updates the voxel size, crop region and conflation when
+//     the client sends new values
+//   - NextResponse: gets the next scan at the stream's voxel size from the
+//     shared SubsampleCache, and writes it back
 // ---------------------------------------------------------------------------
 
 class SubSampledLidarReactor
-    : public grpc::ServerBidiReactor<sensors::SubSampledLidarStreamRequest,
-                                     sensors::PointCloud3> {
+    : public HubStreamReactor<
+          grpc::ServerBidiReactor<grpc::ByteBuffer, grpc::ByteBuffer>,
+          ScanHub, grpc::ByteBuffer> {
 public:
-  SubSampledLidarReactor(std::shared_ptr<msensor::ILidar> lidar)
-      : lidar_(lidar) {
-    std::cout << "Start subsampled Lidar scan stream." << std::endl;
-    StartRead(&request_); // start listening for client messages
-    NextWrite();          // start pushing scans immediately
+  SubSampledLidarReactor(
+      std::shared_ptr<ScanHub> hub, std::shared_ptr<SubsampleCache> cache,
+      std::shared_ptr<msensor::metrics::Registry> metrics = nullptr)
+      : HubStreamReactor(hub, "subsampled Lidar scan", std::move(metrics)),
+        cache_(std::move(cache)) {
+    if (!hub_) {
+      return; // finished as unavailable by the caller
+    }
+    StartRead(&read_); // start listening for client messages
+    Start();           // start pushing scans immediately
   }
 
   void OnReadDone(bool ok) override {
     if (!ok)
       return; // client closed its half
+    sensors::SubSampledLidarStreamRequest request;
+    if (!grpc::SerializationTraits<sensors::SubSampledLidarStreamRequest>::
+             Deserialize(&read_, &request)
+                 .ok()) {
+      std::cout << "Ignoring malformed subsample request." << std::endl;
+      StartRead(&read_);
+      return;
+    }
     std::cout << "Received subsample request with voxel size: "
-              << request_.voxel_size() << std::endl;
-    voxel_size_.store(request_.voxel_size());
-    StartRead(&request_); // keep listening
+              << request.voxel_size() << std::endl;
+    {
+      std::scoped_lock lock(settings_mutex_);
+      voxel_size_ = request.voxel_size();
+      region_ = fromProtobuf(request.crop());
+    }
+    SetConflate(request.conflate());
+    StartRead(&read_); // keep listening
   }
 
-  void OnWriteDone(bool ok) override {
-    if (!ok) {
-      Finish(grpc::Status::OK);
-      return;
+private:
+  const grpc::ByteBuffer *NextResponse() override {
+    const auto scan = ReadNext();
+    if (!scan) {
+      return nullptr;
+    }
+    float voxel_size;
+    msensor::CropRegion region;
+    {
+      std::scoped_lock lock(settings_mutex_);
+      voxel_size = voxel_size_;
+      region = region_;
     }
-    NextWrite();
+    // Shared with every stream with the same view, hence not stamped with a
+    // write-start checkpoint.
+    response_ = WithSkipped<sensors::PointCloud3>(
+        cache_->getSerialized(*scan, voxel_size, region));
+    return &response_;
   }
 
-  void OnCancel() override {
-    std::cout << "Ending subsampled Lidar scan stream." << std::endl;
+  std::mutex settings_mutex_; ///< Guards the settings below.
+  float voxel_size_ = 0.1f;
+  msensor::CropRegion region_;
+  grpc::ByteBuffer read_; ///< Serialized request being read.
+  const std::shared_ptr<SubsampleCache> cache_;
+  grpc::ByteBuffer response_;
+};
+
+grpc::ServerBidiReactor<grpc::ByteBuffer, grpc::ByteBuffer> *
+LidarServiceImpl::getSubSampledLidarScan(
+    grpc::CallbackServerContext * /*context*/) {
+  if (!lidar_) {
+    auto *reactor = new SubSampledLidarReactor(nullptr, nullptr);
+    reactor->Finish(
+        grpc::Status(grpc::StatusCode::UNAVAILABLE, "Lidar not available"));
+    return reactor;
   }
+  return new SubSampledLidarReactor(hub_, subsample_cache_, metrics_);
+}
 
-  void OnDone() override { delete this; }
+// ---------------------------------------------------------------------------
+// getPackedLidarScan — server-streaming of quantized point clouds
+// ---------------------------------------------------------------------------
+
+class PackedLidarScanReactor
+    : public HubStreamReactor<
+          grpc::ServerWriteReactor<sensors::PointCloud3Packed>, ScanHub,
+          sensors::PointCloud3Packed> {
+public:
+  PackedLidarScanReactor(
+      std::shared_ptr<ScanHub> hub,
+      const sensors::PackedLidarStreamRequest &request,
+      std::shared_ptr<msensor::metrics::Registry> metrics = nullptr)
+      : HubStreamReactor(hub, "packed Lidar scan", std::move(metrics)),
+        encoding_(request.encoding()), crop_(fromProtobuf(request.crop())) {
+    if (!hub_) {
+      return; // finished as unavailable by the caller
+    }
+    SetConflate(request.conflate());
+    Start();
+  }
 
 private:
-  void NextWrite() {
-    std::shared_ptr<msensor::Scan3DI> scan;
-    while (!(scan = lidar_->getScan())) {
-      std::this_thread::sleep_for(std::chrono::microseconds(100));
-    }
-    float vs = voxel_size_.load();
-    pcl::VoxelGrid<msensor::Point3I> grid;
-    grid.setInputCloud(scan->points);
-    grid.setLeafSize(vs, vs, vs);
-    auto filtered = std::make_shared<msensor::Scan3DI>();
-    filtered->header = scan->header;
-
-    grid.filter(*filtered->points);
-    response_ = toProtobuf(filtered);
-    StartWrite(&response_);
-  }
-
-  std::shared_ptr<msensor::ILidar> lidar_;
-  std::atomic<float> voxel_size_{0.1f};
-  sensors::SubSampledLidarStreamRequest request_;
-  sensors::PointCloud3 response_;
+  const sensors::PointCloud3Packed *NextResponse() override {
+    const auto scan = ReadNext();
+    if (!scan) {
+      return nullptr;
+    }
+    toProtobuf(crop_.apply(*scan), encoding_, response_);
+    response_->mutable_header()->set_skipped(TakeSkipped());
+    stampWriteStart(response_);
+    return response_;
+  }
+
+  const sensors::PackedEncoding encoding_;
+  StreamCrop crop_;
+  Arena arena_;
+  sensors::PointCloud3Packed *response_ =
+      Arena::CreateMessage<sensors::PointCloud3Packed>(&arena_);
 };
 
-grpc::ServerBidiReactor<sensors::SubSampledLidarStreamRequest,
-                        sensors::PointCloud3> *
-LidarServiceImpl::getSubSampledLidarScan(
-    grpc::CallbackServerContext * /*context*/) {
+grpc::ServerWriteReactor<sensors::PointCloud3Packed> *
+LidarServiceImpl::getPackedLidarScan(
+    grpc::CallbackServerContext * /*context*/,
+    const sensors::PackedLidarStreamRequest *request) {
   if (!lidar_) {
-    auto *reactor = new SubSampledLidarReactor(nullptr);
+    auto *reactor = new PackedLidarScanReactor(nullptr, *request);
     reactor->Finish(
         grpc::Status(grpc::StatusCode::UNAVAILABLE, "Lidar not available"));
     return reactor;
   }
-  return new SubSampledLidarReactor(lidar_);
+  return new PackedLidarScanReactor(hub_, *request, metrics_);
+}
+
+// ---------------------------------------------------------------------------
+// getDeskewedLidarScan — server-streaming of the deskew stage's output
+// ---------------------------------------------------------------------------
+
+grpc::ServerWriteReactor<sensors::PointCloud3> *
+LidarServiceImpl::getDeskewedLidarScan(
+    grpc::CallbackServerContext * /*context*/,
+    const sensors::LidarStreamRequest *request) {
+  if (!deskewed_hub_) {
+    auto *reactor = new LidarScanReactor(nullptr);
+    reactor->Finish(
+        grpc::Status(grpc::StatusCode::UNAVAILABLE, "Deskew not enabled"));
+    return reactor;
+  }
+  return new LidarScanReactor(deskewed_hub_, *request, "deskewed Lidar scan",
+                              metrics_);
 }
@@ -1,26 +1,91 @@
 #pragma once
 
+#include <thread>
+
+#include "imu_service.hh"
 #include "lidar.grpc.pb.h"
+#include "msensor/concurrency/broadcast_hub.hh"
+#include "msensor/concurrency/object_pool.hh"
+#include "msensor/concurrency/ready_signal.hh"
 #include "msensor/interface/ILidar.hh"
+#include "msensor/metrics/metrics.hh"
+#include "subsample_cache.hh"
+
+/// Broadcast ring of immutable scans shared by every LiDAR stream.
+using ScanHub = msensor::BroadcastHub<std::shared_ptr<const msensor::Scan3DI>>;
+
+/// Callback API, with `getSubSampledLidarScan` raw: it writes messages
+/// serialized once for every stream.
+using LidarServiceBase =
+    sensors::LidarService::WithCallbackMethod_getLidarScan<
+        sensors::LidarService::WithRawCallbackMethod_getSubSampledLidarScan<
+            sensors::LidarService::WithCallbackMethod_getPackedLidarScan<
+                sensors::LidarService::WithCallbackMethod_getDeskewedLidarScan<
+                    sensors::LidarService::Service>>>>;
 
 /**
  * @brief Implements the LiDAR gRPC service using the callback API.
  *
  * CallbackService provides reactor-based async handling, allowing
  * independent reads and writes on bidirectional streams without threads.
+ *
+ * A single producer thread drains the driver and publishes each scan into a
+ * `ScanHub`. Every stream reads from the hub through its own cursor, so any
+ * number of clients share one acquisition.
  */
-class LidarServiceImpl : public sensors::LidarService::CallbackService {
+class LidarServiceImpl : public LidarServiceBase {
 public:
-  LidarServiceImpl(std::shared_ptr<msensor::ILidar> lidar);
+  LidarServiceImpl(
+      std::shared_ptr<msensor::ILidar> lidar,
+      std::shared_ptr<msensor::metrics::Registry> metrics = nullptr);
 
   grpc::ServerWriteReactor<sensors::PointCloud3> *
   getLidarScan(grpc::CallbackServerContext *context,
                const sensors::LidarStreamRequest *request) override;
 
-  grpc::ServerBidiReactor<sensors::SubSampledLidarStreamRequest,
-                          sensors::PointCloud3> *
+  /// Raw: reads serialized `SubSampledLidarStreamRequest` messages and
+  /// writes serialized `PointCloud3` messages.
+  grpc::ServerBidiReactor<grpc::ByteBuffer, grpc::ByteBuffer> *
   getSubSampledLidarScan(grpc::CallbackServerContext *context) override;
 
+  /// Stream scans in the compact quantized format requested by the client.
+  grpc::ServerWriteReactor<sensors::PointCloud3Packed> *
+  getPackedLidarScan(grpc::CallbackServerContext *context,
+                     const sensors::PackedLidarStreamRequest *request) override;
+
+  /// Stream motion-compensated scans. Unavailable unless `enableDeskew()`
+  /// was called.
+  grpc::ServerWriteReactor<sensors::PointCloud3> *
+  getDeskewedLidarScan(grpc::CallbackServerContext *context,
+                       const sensors::LidarStreamRequest *request) override;
+
+  /**
+   * @brief Start the deskew stage, which corrects every scan once with the
+   * gyro samples of `imu_hub` and shares the result with all deskewed
+   * streams. Needs a lidar filling per-point times. Call before serving.
+   */
+  void enableDeskew(std::shared_ptr<ImuHub> imu_hub);
+
+  /// Hub of raw scans, for in-process consumers. Null without a lidar.
+  std::shared_ptr<ScanHub> hub() const { return lidar_ ? hub_ : nullptr; }
+
 private:
+  /// Producer loop: pulls scans from the driver and publishes them.
+  void produce(std::stop_token stop_token);
+  /// Deskew loop: pairs scans with IMU samples and publishes corrected scans.
+  void deskew(std::stop_token stop_token, std::shared_ptr<ImuHub> imu_hub);
+
   std::shared_ptr<msensor::ILidar> lidar_;
+  std::shared_ptr<msensor::metrics::Registry> metrics_;
+  std::shared_ptr<ScanHub> hub_;
+  /// Filtered scans shared by the subsampled streams.
+  std::shared_ptr<SubsampleCache> subsample_cache_;
+  /// Declared after `hub_`, so it is joined before the hub is freed.
+  std::jthread producer_;
+
+  std::shared_ptr<ScanHub> deskewed_hub_;
+  msensor::ObjectPool<msensor::Scan3DI> deskew_pool_;
+  msensor::ReadySignal deskew_ready_;
+  /// Declared last: joined before the deskew state and the hubs are freed.
+  std::jthread deskew_thread_;
 };
@@ -7,8 +7,31 @@ SensorsServer::SensorsServer(std::shared_ptr<msensor::IAdc> adc,
                              std::shared_ptr<msensor::ICamera> camera,
                              std::shared_ptr<msensor::IImu> imu,
                              std::shared_ptr<msensor::ILidar> lidar)
-    : lidar_service_(lidar), imu_service_(imu), camera_service_(camera),
-      adc_service_(adc) {}
+    : metrics_(std::make_shared<msensor::metrics::Registry>()),
+      lidar_service_(lidar, metrics_), imu_service_(imu, metrics_),
+      camera_service_(camera, metrics_), adc_service_(adc),
+      stats_service_(metrics_) {}
+
+void SensorsServer::enableDeskew() {
+  lidar_service_.enableDeskew(imu_service_.hub());
+}
+
+void SensorsServer::enableSharedMemory(
+    const msensor::ShmPublisher::Options &options) {
+  if (!shm_publisher_) {
+    shm_publisher_ = std::make_unique<msensor::ShmPublisher>(
+        options, lidar_service_.hub(), imu_service_.hub(),
+        camera_service_.frames());
+  }
+}
+
+void SensorsServer::enableMulticast(
+    const msensor::MulticastPublisher::Options &options) {
+  if (!multicast_publisher_) {
+    multicast_publisher_ = std::make_unique<msensor::MulticastPublisher>(
+        options, lidar_service_.hub(), imu_service_.hub());
+  }
+}
 
 void SensorsServer::start() {
 
@@ -19,6 +42,7 @@ void SensorsServer::start() {
   builder.RegisterService(&imu_service_);
   builder.RegisterService(&camera_service_);
   builder.RegisterService(&adc_service_);
+  builder.RegisterService(&stats_service_);
 
   server_ = builder.BuildAndStart();
   std::cout << "Listening..." << std::endl;
@@ -7,6 +7,10 @@
 #include "camera_service.hh"
 #include "imu_service.hh"
 #include "lidar_service.hh"
+#include "msensor/metrics/metrics.hh"
+#include "msensor/multicast/multicast_publisher.hh"
+#include "msensor/shm/shm_publisher.hh"
+#include "stats_service.hh"
 
 /**
  * @brief This class manages the gRPC server and provides methods to publish
@@ -20,13 +24,37 @@ public:
                 std::shared_ptr<msensor::IImu> imu = nullptr,
                 std::shared_ptr<msensor::ILidar> lidar = nullptr);
 
+  /// Serve motion-compensated scans from the lidar and IMU. Call before
+  /// `start()`.
+  void enableDeskew();
+
+  /// Also publish raw scans, IMU samples and camera frames to same-host
+  /// `msensor::ShmClient`s through shared memory. Call before `start()`.
+  void enableSharedMemory(const msensor::ShmPublisher::Options &options = {});
+
+  /// Also send scans and IMU samples to a UDP multicast group, once for any
+  /// number of `msensor::MulticastReceiver`s. Call before `start()`.
+  void enableMulticast(
+      const msensor::MulticastPublisher::Options &options = {});
+
+  /// Metrics served by the StatsService. Drivers may register their own,
+  /// e.g. queue depths, before `start()`.
+  std::shared_ptr<msensor::metrics::Registry> metrics() const {
+    return metrics_;
+  }
+
   void start();
   void stop();
 
 private:
+  std::shared_ptr<msensor::metrics::Registry> metrics_;
   LidarServiceImpl lidar_service_;
   ImuServiceImpl imu_service_;
   CameraServiceImpl camera_service_;
   AdcServiceImpl adc_service_;
+  StatsServiceImpl stats_service_;
+  /// Declared after the services: detached before their hubs are freed.
+  std::unique_ptr<msensor::ShmPublisher> shm_publisher_;
+  std::unique_ptr<msensor::MulticastPublisher> multicast_publisher_;
   std::unique_ptr<grpc::Server> server_;
 };
\ No newline at end of file
@@ -1,18 +1,72 @@
+#include <google/protobuf/arena.h>
 #include <google/protobuf/empty.pb.h>
 #include <grpcpp/client_context.h>
 #include <grpcpp/grpcpp.h>
 
 #include "msensor/conversions/conversions.hh"
+#include "msensor/timing/timing.hh"
 #include "sensors_remote_client.hh"
 
 constexpr int g_idleTimeMs = 5;
 constexpr size_t g_maxLidarSamples = 100;
 constexpr size_t g_maxImuSamples = 200;
 constexpr int g_connectionRecoverDelayMs = 1000;
+constexpr uint32_t g_imuBatchMaxSamples = 32;
+constexpr uint32_t g_imuBatchMaxLatencyMs = 20;
+
+namespace {
+/// Record `end - start` in us, if both checkpoints are set and ordered.
+void observeStage(msensor::metrics::Histogram &stage, uint64_t start_ns,
+                  uint64_t end_ns) {
+  if (start_ns != 0 && end_ns >= start_ns) {
+    stage.observe((end_ns - start_ns) / 1000);
+  }
+}
+
+/// Counter of the items the server skipped on `stream`.
+std::shared_ptr<msensor::metrics::Counter>
+skippedCounter(msensor::metrics::Registry &metrics, const std::string &stream) {
+  return metrics.counter("msensor_remote_skipped_total",
+                         "Items the server skipped before a message.",
+                         {{"stream", stream}});
+}
+} // namespace
+
+SensorsRemoteClient::TraceStages::TraceStages(
+    msensor::metrics::Registry &metrics, const std::string &stream) {
+  const auto stage = [&](const std::string &name) {
+    return metrics.histogram(
+        "msensor_trace_stage_us",
+        "Latency of each pipeline stage of traced messages, in us.",
+        {{"stream", stream}, {"stage", name}});
+  };
+  driver_ = stage("driver");
+  hub_ = stage("hub");
+  write_ = stage("write");
+  transport_ = stage("transport");
+  total_ = stage("total");
+}
+
+void SensorsRemoteClient::TraceStages::record(const sensors::Header &header) {
+  if (!header.has_trace()) {
+    return;
+  }
+  const auto &trace = header.trace();
+  const uint64_t received_ns = timing::getEpochTimeNs();
+  observeStage(*driver_, trace.driver_receive_ns(), trace.conversion_done_ns());
+  observeStage(*hub_, trace.conversion_done_ns(),
+               trace.serialization_done_ns());
+  observeStage(*write_, trace.serialization_done_ns(), trace.write_start_ns());
+  observeStage(*transport_, trace.write_start_ns(), received_ns);
+  observeStage(*total_, trace.driver_receive_ns(), received_ns);
+}
 
 SensorsRemoteClient::SensorsRemoteClient(const std::string &remote_ip)
-    : remote_ip_(remote_ip), scan_queue_(g_maxLidarSamples),
-      imu_queue_(g_maxImuSamples) {
+    : remote_ip_(remote_ip),
+      scan_queue_(g_maxLidarSamples, msensor::Overflow::DropOldest, {},
+                  "Remote scan queue"),
+      imu_queue_(g_maxImuSamples, msensor::Overflow::DropOldest, {},
+                 "Remote IMU queue") {
 
   channel_ = grpc::CreateChannel(remote_ip, grpc::InsecureChannelCredentials());
   lidar_stub_ = sensors::LidarService::NewStub(channel_);
@@ -26,39 +80,54 @@ void SensorsRemoteClient::stopSampling() {}
 SensorsRemoteClient::~SensorsRemoteClient() { stop(); }
 
 std::shared_ptr<msensor::Scan3DI> SensorsRemoteClient::getScan() {
+  return scan_queue_.pop().value_or(nullptr);
+}
 
+bool SensorsRemoteClient::waitForScan(std::chrono::milliseconds timeout) {
   if (!scan_queue_.empty()) {
-    auto pointcloud = scan_queue_.front();
-    scan_queue_.pop();
-    return pointcloud;
+    return true;
   }
-
-  return nullptr;
+  return scan_ready_.waitFor(timeout);
 }
 
 std::optional<msensor::IMUData> SensorsRemoteClient::getImuData() {
+  return imu_queue_.pop();
+}
 
-  if (!imu_queue_.empty()) {
-    const auto imu_data = imu_queue_.front();
-    imu_queue_.pop();
-    return imu_data;
-  }
+msensor::QueueStats SensorsRemoteClient::scanQueueStats() const {
+  return scan_queue_.stats();
+}
+
+msensor::QueueStats SensorsRemoteClient::imuQueueStats() const {
+  return imu_queue_.stats();
+}
+
+void SensorsRemoteClient::setCropRegion(const msensor::CropRegion &region) {
+  *lidar_request_.mutable_crop() = toProtobuf(region);
+}
 
-  return std::nullopt;
+void SensorsRemoteClient::setConflate(bool conflate) {
+  lidar_request_.set_conflate(conflate);
 }
 
 void SensorsRemoteClient::start() {
 
   read_thread_ = std::jthread([&](std::stop_token stop_token) {
     auto service_context_ = std::make_unique<grpc::ClientContext>();
-    sensors::LidarStreamRequest request;
+    const sensors::LidarStreamRequest request = lidar_request_;
 
     auto reader = lidar_stub_->getLidarScan(service_context_.get(), request);
 
-    sensors::PointCloud3 msg;
+    // Reads are parsed into the same arena-owned message, whose packed fields
+    // keep their capacity, so only the decoded Scan3DI is allocated per scan.
+    google::protobuf::Arena arena;
+    auto *msg = google::protobuf::Arena::CreateMessage<sensors::PointCloud3>(
+        &arena);
+    TraceStages trace_stages(metrics_, "lidar");
+    const auto skipped = skippedCounter(metrics_, "lidar");
 
     while (!stop_token.stop_requested()) {
-      if (!reader->Read(&msg)) {
+      if (!reader->Read(msg)) {
         std::cout << "Unable to read remote lidar." << std::endl;
         std::this_thread::sleep_for(
             std::chrono::milliseconds(g_connectionRecoverDelayMs));
@@ -66,28 +135,42 @@ void SensorsRemoteClient::start() {
         reader = lidar_stub_->getLidarScan(service_context_.get(),
                                            request); // retry
       } else {
-        scan_queue_.push(fromProtobuf(msg));
+        trace_stages.record(msg->header());
+        skipped->add(msg->header().skipped());
+        if (scan_queue_.push(fromProtobuf(*msg))) {
+          scan_ready_.notify();
+        }
       }
     }
   });
 
   imu_reader_thread_ = std::jthread([&](std::stop_token stop_token) {
     auto service_context_ = std::make_unique<grpc::ClientContext>();
-    sensors::ImuStreamRequest request;
+    sensors::ImuBatchRequest request;
+    request.set_max_samples(g_imuBatchMaxSamples);
+    request.set_max_latency_ms(g_imuBatchMaxLatencyMs);
 
-    auto imu_reader = imu_stub_->getImuData(service_context_.get(), request);
-    sensors::IMUData msg;
+    auto imu_reader = imu_stub_->getImuBatch(service_context_.get(), request);
+    google::protobuf::Arena arena;
+    auto *msg =
+        google::protobuf::Arena::CreateMessage<sensors::ImuBatch>(&arena);
+    TraceStages trace_stages(metrics_, "imu");
+    const auto skipped = skippedCounter(metrics_, "imu");
 
     while (!stop_token.stop_requested()) {
 
-      if (!imu_reader->Read(&msg)) {
+      if (!imu_reader->Read(msg)) {
         std::cout << "Unable to read remote imu." << std::endl;
         std::this_thread::sleep_for(
             std::chrono::milliseconds(g_connectionRecoverDelayMs));
         service_context_ = std::make_unique<grpc::ClientContext>();
-        imu_reader = imu_stub_->getImuData(service_context_.get(), request);
+        imu_reader = imu_stub_->getImuBatch(service_context_.get(), request);
       } else {
-        imu_queue_.push(fromProtobuf(msg));
+        trace_stages.record(msg->header());
+        skipped->add(msg->header().skipped());
+        for (const auto &imu_data : fromProtobuf(*msg)) {
+          imu_queue_.push(imu_data);
+        }
       }
     }
   });
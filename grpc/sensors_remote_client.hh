@@ -1,19 +1,26 @@
 #pragma once
 
-#include <boost/lockfree/spsc_queue.hpp>
 #include <grpcpp/channel.h>
 #include <memory>
 #include <thread>
 
 #include "imu.grpc.pb.h"
 #include "lidar.grpc.pb.h"
+#include "msensor/concurrency/bounded_queue.hh"
+#include "msensor/concurrency/ready_signal.hh"
 #include "msensor/interface/IImu.hh"
 #include "msensor/interface/ILidar.hh"
+#include "msensor/metrics/metrics.hh"
+#include "msensor/processing/crop.hh"
 
 /**
  * @brief This class connects to a SensorService and provides methods to get
  * sensor data remotely.
  *
+ * Messages carrying trace checkpoints (see `msensor/timing/trace.hh`) are
+ * broken down into per-stage latency histograms, `msensor_trace_stage_us`,
+ * in `metrics()`. Items the server skipped for this client are counted in
+ * `msensor_remote_skipped_total`.
  */
 class SensorsRemoteClient : public msensor::ILidar, public msensor::IImu {
 public:
@@ -23,6 +30,12 @@ public:
   void init() override;
   /// Start background threads that pull data from the server.
   void start();
+  /// Receive only the LiDAR points in `region`, cropped by the server.
+  /// Applies from the next `start()`.
+  void setCropRegion(const msensor::CropRegion &region);
+  /// Receive only the newest LiDAR scan whenever the previous one is sent,
+  /// for fresh data over slow links. Applies from the next `start()`.
+  void setConflate(bool conflate);
   /// Stop background readers and tear down the connection.
   void stop();
   void startSampling() override;
@@ -30,10 +43,35 @@ public:
 
   /// Pop the next LiDAR scan received over gRPC.
   std::shared_ptr<msensor::Scan3DI> getScan() override;
+  /// Block until a LiDAR scan has been received.
+  bool waitForScan(std::chrono::milliseconds timeout) override;
   /// Pop the next IMU sample received over gRPC.
   std::optional<msensor::IMUData> getImuData() override;
 
+  /// Counters of the received-scan queue. Thread-safe.
+  msensor::QueueStats scanQueueStats() const;
+  /// Counters of the received-IMU queue. Thread-safe.
+  msensor::QueueStats imuQueueStats() const;
+
+  /// Trace latency histograms and skip counters of the received streams.
+  msensor::metrics::Registry &metrics() { return metrics_; }
+
 private:
+  /// Latency of each traced stage of one stream, in microseconds.
+  class TraceStages {
+  public:
+    TraceStages(msensor::metrics::Registry &metrics, const std::string &stream);
+    /// Record the stages whose checkpoints `header` carries.
+    void record(const sensors::Header &header);
+
+  private:
+    std::shared_ptr<msensor::metrics::Histogram> driver_;
+    std::shared_ptr<msensor::metrics::Histogram> hub_;
+    std::shared_ptr<msensor::metrics::Histogram> write_;
+    std::shared_ptr<msensor::metrics::Histogram> transport_;
+    std::shared_ptr<msensor::metrics::Histogram> total_;
+  };
+
   std::string remote_ip_;
   std::shared_ptr<grpc::Channel> channel_;
   std::unique_ptr<sensors::LidarService::Stub> lidar_stub_;
@@ -42,7 +80,10 @@ private:
   std::jthread read_thread_;
   std::jthread imu_reader_thread_;
   std::unique_ptr<grpc::ClientContext> context_;
+  sensors::LidarStreamRequest lidar_request_;
 
-  boost::lockfree::spsc_queue<std::shared_ptr<msensor::Scan3DI>> scan_queue_;
-  boost::lockfree::spsc_queue<msensor::IMUData> imu_queue_;
+  msensor::BoundedQueue<std::shared_ptr<msensor::Scan3DI>> scan_queue_;
+  msensor::BoundedQueue<msensor::IMUData> imu_queue_;
+  msensor::ReadySignal scan_ready_;
+  msensor::metrics::Registry metrics_;
 };
\ No newline at end of file
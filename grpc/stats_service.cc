@@ -0,0 +1,106 @@
+#include "stats_service.hh"
+
+#include <limits>
+
+using msensor::metrics::Histogram;
+using msensor::metrics::Type;
+
+namespace {
+
+/// Callers without a getStats for this long lose their rate baseline.
+constexpr auto g_callerExpiry = std::chrono::minutes(5);
+
+sensors::Metric::Type toProtobuf(Type type) {
+  switch (type) {
+  case Type::Counter:
+    return sensors::Metric::COUNTER;
+  case Type::Gauge:
+    return sensors::Metric::GAUGE;
+  case Type::Histogram:
+    return sensors::Metric::HISTOGRAM;
+  }
+  return sensors::Metric::GAUGE;
+}
+
+/// Key identifying a counter across calls: its name and labels.
+std::string seriesKey(const msensor::metrics::Sample &sample) {
+  std::string key = sample.name;
+  for (const auto &[label, value] : sample.labels) {
+    key += '\0' + label + '=' + value;
+  }
+  return key;
+}
+} // namespace
+
+StatsServiceImpl::StatsServiceImpl(
+    std::shared_ptr<msensor::metrics::Registry> registry)
+    : registry_(registry), start_(std::chrono::steady_clock::now()) {}
+
+grpc::ServerUnaryReactor *
+StatsServiceImpl::getStats(grpc::CallbackServerContext *context,
+                           const sensors::StatsRequest * /*request*/,
+                           sensors::Stats *response) {
+  const auto samples = registry_->collect();
+  const auto now = std::chrono::steady_clock::now();
+  response->set_uptime_s(std::chrono::duration<double>(now - start_).count());
+
+  // Rates are per caller, so that callers polling independently do not
+  // shorten each other's intervals.
+  std::scoped_lock lock(previous_mutex_);
+  std::erase_if(previous_, [&](const auto &caller) {
+    return now - caller.second.time > g_callerExpiry;
+  });
+  Previous &previous = previous_[context->peer()];
+  const double elapsed_s =
+      std::chrono::duration<double>(now - previous.time).count();
+  std::map<std::string, double> values;
+
+  for (const auto &sample : samples) {
+    auto *metric = response->add_metrics();
+    metric->set_name(sample.name);
+    metric->set_type(toProtobuf(sample.type));
+    metric->mutable_labels()->insert(sample.labels.begin(),
+                                     sample.labels.end());
+
+    if (sample.histogram) {
+      auto *histogram = metric->mutable_histogram();
+      for (size_t i = 0; i < sample.histogram->counts.size(); ++i) {
+        histogram->add_upper_bound(
+            i + 1 == sample.histogram->counts.size()
+                ? std::numeric_limits<double>::infinity()
+                : static_cast<double>(Histogram::upperBound(i)));
+        histogram->add_count(sample.histogram->counts[i]);
+      }
+      histogram->set_sum(static_cast<double>(sample.histogram->sum));
+      histogram->set_total(sample.histogram->count);
+      continue;
+    }
+
+    metric->set_value(sample.value);
+    if (sample.type == Type::Counter) {
+      const auto key = seriesKey(sample);
+      const auto value = previous.values.find(key);
+      if (value != previous.values.end() && elapsed_s > 0) {
+        metric->set_rate((sample.value - value->second) / elapsed_s);
+      }
+      values.emplace(key, sample.value);
+    }
+  }
+
+  previous.values = std::move(values);
+  previous.time = now;
+
+  auto *reactor = context->DefaultReactor();
+  reactor->Finish(grpc::Status::OK);
+  return reactor;
+}
+
+grpc::ServerUnaryReactor *
+StatsServiceImpl::getPrometheusText(grpc::CallbackServerContext *context,
+                                    const sensors::StatsRequest * /*request*/,
+                                    sensors::PrometheusText *response) {
+  response->set_text(registry_->prometheusText());
+  auto *reactor = context->DefaultReactor();
+  reactor->Finish(grpc::Status::OK);
+  return reactor;
+}
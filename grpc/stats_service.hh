@@ -0,0 +1,46 @@
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <mutex>
+
+#include "msensor/metrics/metrics.hh"
+#include "stats.grpc.pb.h"
+
+/**
+ * @brief Implements the stats gRPC service using the callback API.
+ *
+ * Reads the server's metrics registry on request. Collecting never blocks
+ * the streams: they only update per-thread atomic counters.
+ */
+class StatsServiceImpl : public sensors::StatsService::CallbackService {
+public:
+  StatsServiceImpl(std::shared_ptr<msensor::metrics::Registry> registry);
+
+  /// Every metric, with counter rates over the time since the caller's
+  /// previous call.
+  grpc::ServerUnaryReactor *getStats(grpc::CallbackServerContext *context,
+                                     const sensors::StatsRequest *request,
+                                     sensors::Stats *response) override;
+
+  /// Every metric in the Prometheus text exposition format.
+  grpc::ServerUnaryReactor *
+  getPrometheusText(grpc::CallbackServerContext *context,
+                    const sensors::StatsRequest *request,
+                    sensors::PrometheusText *response) override;
+
+private:
+  std::shared_ptr<msensor::metrics::Registry> registry_;
+  const std::chrono::steady_clock::time_point start_;
+
+  /// Counter values a caller saw in its previous getStats, for rates.
+  struct Previous {
+    std::chrono::steady_clock::time_point time;
+    std::map<std::string, double> values;
+  };
+
+  std::mutex previous_mutex_;
+  /// By caller connection (peer address and port); callers silent for a
+  /// while are forgotten.
+  std::map<std::string, Previous> previous_;
+};
@@ -0,0 +1,132 @@
+#include "subsample_cache.hh"
+#include "hub_stream_reactor.hh"
+#include "msensor/conversions/conversions.hh"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+
+SubsampleCache::SubsampleCache(
+    size_t scans, std::shared_ptr<msensor::metrics::Registry> metrics)
+    : scans_(std::max<size_t>(scans, 1)) {
+  if (metrics) {
+    const auto lookups = [&](const std::string &result) {
+      return metrics->counter("msensor_subsample_cache_total",
+                              "Subsampled scan lookups by result.",
+                              {{"result", result}});
+    };
+    hits_ = lookups("hit");
+    misses_ = lookups("miss");
+    filter_us_ = metrics->histogram(
+        "msensor_subsample_filter_us",
+        "Time to filter and convert one scan at one resolution, in us.");
+  }
+}
+
+std::shared_ptr<SubsampleCache::Entry>
+SubsampleCache::entry(const Key &key, uint64_t timestamp) {
+  std::scoped_lock lock(mutex_);
+  auto &slot = entries_[key];
+  if (slot && slot->timestamp == timestamp) {
+    return slot;
+  }
+  slot = std::make_shared<Entry>();
+  slot->timestamp = timestamp;
+
+  const std::pair scan{std::get<0>(key), std::get<1>(key)};
+  if (std::find(order_.begin(), order_.end(), scan) == order_.end()) {
+    order_.push_back(scan);
+  }
+  while (order_.size() > scans_) {
+    const auto [device, sequence] = order_.front();
+    order_.pop_front();
+    std::erase_if(entries_, [&](const auto &item) {
+      return std::get<0>(item.first) == device &&
+             std::get<1>(item.first) == sequence;
+    });
+  }
+  return slot;
+}
+
+std::shared_ptr<const sensors::PointCloud3>
+SubsampleCache::get(const std::shared_ptr<const msensor::Scan3DI> &scan,
+                    float leaf, const msensor::CropRegion &region) {
+  return lookup(scan, leaf, region)->message;
+}
+
+grpc::Slice SubsampleCache::getSerialized(
+    const std::shared_ptr<const msensor::Scan3DI> &scan, float leaf,
+    const msensor::CropRegion &region) {
+  return lookup(scan, leaf, region)->serialized;
+}
+
+std::shared_ptr<const SubsampleCache::Entry>
+SubsampleCache::lookup(const std::shared_ptr<const msensor::Scan3DI> &scan,
+                       float leaf, const msensor::CropRegion &region) {
+  RegionBits region_bits;
+  std::ranges::transform(
+      std::array{region.box_min[0], region.box_min[1], region.box_min[2],
+                 region.box_max[0], region.box_max[1], region.box_max[2],
+                 region.min_range, region.max_range, region.azimuth_min,
+                 region.azimuth_max, region.min_intensity},
+      region_bits.begin(), [](float value) {
+        return std::bit_cast<uint32_t>(value);
+      });
+  const auto target =
+      entry({scan->device_id, scan->header.sequence_number,
+             std::bit_cast<uint32_t>(leaf), region_bits},
+            scan->header.timestamp);
+
+  std::scoped_lock lock(target->mutex);
+  if (target->message) {
+    if (hits_) {
+      hits_->add();
+    }
+    return target;
+  }
+  if (misses_) {
+    misses_->add();
+  }
+  target->message = compute(scan, leaf, region);
+  target->serialized = serializeToSlice(*target->message);
+  return target;
+}
+
+std::shared_ptr<const sensors::PointCloud3>
+SubsampleCache::compute(const std::shared_ptr<const msensor::Scan3DI> &scan,
+                        float leaf, const msensor::CropRegion &region) {
+  const auto start = std::chrono::steady_clock::now();
+  std::unique_ptr<Scratch> scratch;
+  {
+    std::scoped_lock lock(mutex_);
+    if (!scratches_.empty()) {
+      scratch = std::move(scratches_.back());
+      scratches_.pop_back();
+    }
+  }
+  if (!scratch) {
+    scratch = std::make_unique<Scratch>();
+  }
+
+  std::shared_ptr<const msensor::Scan3DI> source = scan;
+  if (!region.keepsAll()) {
+    msensor::crop(*scan, region, *scratch->cropped);
+    source = scratch->cropped;
+  }
+  auto filtered = std::make_shared<msensor::Scan3DI>();
+  scratch->filter.filter(*source->points, leaf, *filtered->points);
+  filtered->header = scan->header;
+  filtered->device_id = scan->device_id;
+  {
+    std::scoped_lock lock(mutex_);
+    scratches_.push_back(std::move(scratch));
+  }
+
+  auto message = std::make_shared<sensors::PointCloud3>();
+  toProtobuf(filtered, message.get());
+  if (filter_us_) {
+    filter_us_->observe(std::chrono::duration_cast<std::chrono::microseconds>(
+                            std::chrono::steady_clock::now() - start)
+                            .count());
+  }
+  return message;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+#include <grpcpp/support/slice.h>
+
+#include "lidar.pb.h"
+#include "msensor/interface/ILidar.hh"
+#include "msensor/metrics/metrics.hh"
+#include "msensor/processing/crop.hh"
+#include "msensor/processing/voxel_filter.hh"
+
+/**
+ * @brief Cropped, voxel-filtered scans shared by every subsampled LiDAR stream.
+ *
+ * Entries are keyed by device, scan sequence number, leaf size and crop
+ * region, so each distinct view is cropped, filtered and converted once per
+ * scan, however many streams ask for it. Each message is also serialized
+ * once, and streams write the same bytes.
+ *
+ * The results of the last `scans` scans are kept. Thread-safe: concurrent
+ * requests for one entry wait for a single computation, and distinct views
+ * are computed in parallel.
+ */
+class SubsampleCache {
+public:
+  /// Keep the results of the last `scans` scans.
+  explicit SubsampleCache(
+      size_t scans,
+      std::shared_ptr<msensor::metrics::Registry> metrics = nullptr);
+
+  /// The points of `scan` in `region`, filtered with cubic voxels of `leaf`
+  /// metres, as a message.
+  std::shared_ptr<const sensors::PointCloud3>
+  get(const std::shared_ptr<const msensor::Scan3DI> &scan, float leaf,
+      const msensor::CropRegion &region = {});
+
+  /// The message of `get()`, serialized.
+  grpc::Slice
+  getSerialized(const std::shared_ptr<const msensor::Scan3DI> &scan,
+                float leaf, const msensor::CropRegion &region = {});
+
+private:
+  /// Bits of every `CropRegion` field.
+  using RegionBits = std::array<uint32_t, 11>;
+  /// Device id, sequence number, leaf size bits and region bits.
+  using Key = std::tuple<uint32_t, uint32_t, uint32_t, RegionBits>;
+
+  struct Entry {
+    std::mutex mutex; ///< Held while the message is computed.
+    uint64_t timestamp = 0;
+    std::shared_ptr<const sensors::PointCloud3> message;
+    grpc::Slice serialized;
+  };
+
+  /// Entry for `key`, created if missing or left by an older scan that had
+  /// the same sequence number.
+  std::shared_ptr<Entry> entry(const Key &key, uint64_t timestamp);
+  /// Entry of the view, computed if missing.
+  std::shared_ptr<const Entry>
+  lookup(const std::shared_ptr<const msensor::Scan3DI> &scan, float leaf,
+         const msensor::CropRegion &region);
+  std::shared_ptr<const sensors::PointCloud3>
+  compute(const std::shared_ptr<const msensor::Scan3DI> &scan, float leaf,
+          const msensor::CropRegion &region);
+
+  /// Buffers of one computation. Its filter runs on the calling thread:
+  /// concurrent views already get one scratch each.
+  struct Scratch {
+    msensor::VoxelFilter filter{msensor::VoxelFilter::Mode::Centroid, 1};
+    std::shared_ptr<msensor::Scan3DI> cropped =
+        std::make_shared<msensor::Scan3DI>();
+  };
+
+  const size_t scans_;
+  std::mutex mutex_;
+  std::map<Key, std::shared_ptr<Entry>> entries_;
+  std::deque<std::pair<uint32_t, uint32_t>> order_; ///< Scans, oldest first.
+  std::vector<std::unique_ptr<Scratch>> scratches_; ///< Idle.
+
+  std::shared_ptr<msensor::metrics::Counter> hits_;
+  std::shared_ptr<msensor::metrics::Counter> misses_;
+  std::shared_ptr<msensor::metrics::Histogram> filter_us_;
+};
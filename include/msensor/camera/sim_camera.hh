@@ -10,9 +10,15 @@ namespace msensor {
  */
 class SimCamera : public ICamera {
 public:
+  SimCamera(int width = 640, int height = 480);
+
   virtual bool read(CameraFrame &frame) override;
   virtual bool isOpened() const override;
   virtual void release() override;
+
+private:
+  int width_;
+  int height_;
 };
 
 } // namespace msensor
\ No newline at end of file
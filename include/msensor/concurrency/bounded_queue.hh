@@ -0,0 +1,166 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <string>
+
+namespace msensor {
+
+/// What `BoundedQueue::push()` does when the queue is full.
+enum class Overflow {
+  DropOldest, ///< Evict the oldest element to make room.
+  DropNewest, ///< Discard the element being pushed.
+  /// Wait for room up to a timeout, then discard the new one. Not for
+  /// queues pushed from threads that must never stall, e.g. SDK callbacks.
+  Block,
+};
+
+/// Counters of a `BoundedQueue`, all since construction.
+struct QueueStats {
+  uint64_t pushed = 0;   ///< Elements offered to `push()`.
+  uint64_t dropped = 0;  ///< Elements lost to overflow, either end.
+  size_t high_water = 0; ///< Deepest occupancy observed.
+  size_t depth = 0;      ///< Current occupancy.
+  size_t capacity = 0;
+};
+
+/**
+ * @brief Bounded FIFO between a driver thread and its consumer that accounts
+ * for every element it loses.
+ *
+ * The counters are atomics, so `stats()` never takes the queue lock. Drops are
+ * also logged under the queue's name, outside the lock: the first one, then
+ * the running total at most every `g_dropLogPeriod`, so a sustained overload
+ * stays visible without flooding the log.
+ */
+template <typename T> class BoundedQueue {
+public:
+  /// Shortest interval between two drop logs of a queue.
+  static constexpr std::chrono::seconds g_dropLogPeriod{10};
+
+  BoundedQueue(size_t capacity, Overflow overflow = Overflow::DropOldest,
+               std::chrono::milliseconds block_timeout = {},
+               std::string name = "queue")
+      : capacity_(capacity), overflow_(overflow),
+        block_timeout_(block_timeout), name_(std::move(name)) {}
+
+  /**
+   * @brief Enqueue `value` per the overflow policy.
+   *
+   * @return false if `value` itself was discarded.
+   */
+  bool push(T value) {
+    pushed_.fetch_add(1, std::memory_order_relaxed);
+    std::unique_lock lock(mutex_);
+    if (elements_.size() >= capacity_) {
+      if (overflow_ == Overflow::Block) {
+        not_full_.wait_for(lock, block_timeout_,
+                           [this] { return elements_.size() < capacity_; });
+      }
+      if (elements_.size() >= capacity_) {
+        if (overflow_ != Overflow::DropOldest || capacity_ == 0) {
+          lock.unlock();
+          countDrop();
+          return false;
+        }
+        // Destroyed after the lock is released, with the log.
+        std::optional<T> evicted(std::move(elements_.front()));
+        elements_.pop_front();
+        pushBack(std::move(value));
+        lock.unlock();
+        evicted.reset();
+        countDrop();
+        return true;
+      }
+    }
+    pushBack(std::move(value));
+    return true;
+  }
+
+  /// Dequeue the oldest element, if any. Never blocks.
+  std::optional<T> pop() {
+    std::optional<T> value;
+    {
+      std::scoped_lock lock(mutex_);
+      if (elements_.empty()) {
+        return std::nullopt;
+      }
+      value.emplace(std::move(elements_.front()));
+      elements_.pop_front();
+    }
+    not_full_.notify_one();
+    return value;
+  }
+
+  bool empty() const {
+    std::scoped_lock lock(mutex_);
+    return elements_.empty();
+  }
+
+  size_t size() const {
+    std::scoped_lock lock(mutex_);
+    return elements_.size();
+  }
+
+  size_t capacity() const { return capacity_; }
+
+  QueueStats stats() const {
+    return QueueStats{pushed_.load(std::memory_order_relaxed),
+                      dropped_.load(std::memory_order_relaxed),
+                      high_water_.load(std::memory_order_relaxed), size(),
+                      capacity_};
+  }
+
+private:
+  /// Append under the lock and track the high-water mark.
+  void pushBack(T value) {
+    elements_.push_back(std::move(value));
+    const size_t depth = elements_.size();
+    if (depth > high_water_.load(std::memory_order_relaxed)) {
+      high_water_.store(depth, std::memory_order_relaxed);
+    }
+  }
+
+  /// Count a drop and log it if due. Call without the lock held.
+  void countDrop() {
+    const uint64_t dropped =
+        dropped_.fetch_add(1, std::memory_order_relaxed) + 1;
+    const int64_t now =
+        std::chrono::steady_clock::now().time_since_epoch().count();
+    int64_t last = last_drop_log_.load(std::memory_order_relaxed);
+    const int64_t period =
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            g_dropLogPeriod)
+            .count();
+    // Only the thread that claims the interval logs.
+    if ((dropped == 1 || now - last >= period) &&
+        last_drop_log_.compare_exchange_strong(last, now,
+                                               std::memory_order_relaxed)) {
+      std::cout << name_ << ": " << dropped << " elements dropped (capacity "
+                << capacity_ << ")." << std::endl;
+    }
+  }
+
+  const size_t capacity_;
+  const Overflow overflow_;
+  const std::chrono::milliseconds block_timeout_;
+  const std::string name_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable not_full_;
+  std::deque<T> elements_;
+
+  std::atomic<uint64_t> pushed_{0};
+  std::atomic<uint64_t> dropped_{0};
+  std::atomic<size_t> high_water_{0};
+  /// steady_clock ticks of the last drop log.
+  std::atomic<int64_t> last_drop_log_{0};
+};
+
+} // namespace msensor
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace msensor {
+
+/**
+ * @brief Single-producer, multi-consumer broadcast ring.
+ *
+ * The producer publishes items into a fixed-size ring. Every subscriber holds
+ * its own `Cursor` and reads at its own pace, without consuming the item for
+ * the other subscribers. A subscriber that falls more than `capacity` items
+ * behind skips forward to the oldest item still held by the ring.
+ *
+ * Consumers that must not block (e.g. gRPC reactors) register a listener,
+ * which the producer invokes after every publish.
+ *
+ * \note Items are copied out of the ring, so `T` is expected to be cheap to
+ * copy (e.g. `std::shared_ptr<const Scan3DI>`).
+ */
+template <typename T> class BroadcastHub {
+public:
+  /// Per-subscriber read position.
+  struct Cursor {
+    uint64_t next = 0;    ///< Index of the next item to be read.
+    uint64_t skipped = 0; ///< Items overwritten before they could be read.
+  };
+
+  /// Create a hub holding at most `capacity` items.
+  explicit BroadcastHub(size_t capacity) : slots_(capacity), head_(0) {}
+
+  using Listener = std::function<void()>;
+
+  /// Publish a new item, overwriting the oldest one when the ring is full,
+  /// then invoke every registered listener from the calling thread.
+  void publish(T item) {
+    {
+      std::scoped_lock lock(mutex_);
+      slots_[head_ % slots_.size()] = std::move(item);
+      ++head_;
+    }
+
+    std::scoped_lock lock(listeners_mutex_);
+    for (const auto &[id, listener] : listeners_) {
+      listener();
+    }
+  }
+
+  /**
+   * @brief Register a callback invoked after every publish.
+   *
+   * \note Listeners run on the producer thread and must not add or remove
+   * listeners themselves. Reading from the hub is allowed.
+   * @return Id to be passed to `removeListener`.
+   */
+  uint64_t addListener(Listener listener) {
+    std::scoped_lock lock(listeners_mutex_);
+    listeners_.emplace(next_listener_id_, std::move(listener));
+    return next_listener_id_++;
+  }
+
+  /// True if at least one listener is registered.
+  bool hasListeners() const {
+    std::scoped_lock lock(listeners_mutex_);
+    return !listeners_.empty();
+  }
+
+  /// Unregister a listener. Once this returns the listener is neither
+  /// running nor invoked again.
+  void removeListener(uint64_t id) {
+    std::scoped_lock lock(listeners_mutex_);
+    listeners_.erase(id);
+  }
+
+  /// Create a cursor positioned at the next item to be published.
+  Cursor subscribe() const {
+    std::scoped_lock lock(mutex_);
+    return Cursor{head_, 0};
+  }
+
+  /// Read the next item for `cursor` and advance it. Returns empty if the
+  /// subscriber is up to date.
+  std::optional<T> read(Cursor &cursor) const {
+    std::scoped_lock lock(mutex_);
+    if (cursor.next >= head_) {
+      return std::nullopt;
+    }
+
+    const uint64_t oldest =
+        head_ > slots_.size() ? head_ - slots_.size() : uint64_t{0};
+    if (cursor.next < oldest) {
+      cursor.skipped += oldest - cursor.next;
+      cursor.next = oldest;
+    }
+
+    return slots_[cursor.next++ % slots_.size()];
+  }
+
+  /// Read the newest item and move `cursor` past it, counting the unread
+  /// items before it as skipped. Returns empty if the subscriber is up to
+  /// date.
+  std::optional<T> readLatest(Cursor &cursor) const {
+    std::scoped_lock lock(mutex_);
+    if (cursor.next >= head_) {
+      return std::nullopt;
+    }
+    cursor.skipped += head_ - 1 - cursor.next;
+    cursor.next = head_;
+    return slots_[(head_ - 1) % slots_.size()];
+  }
+
+  /// Total number of items published so far.
+  uint64_t published() const {
+    std::scoped_lock lock(mutex_);
+    return head_;
+  }
+
+private:
+  mutable std::mutex mutex_;
+  std::vector<T> slots_;
+  uint64_t head_;
+
+  mutable std::mutex listeners_mutex_;
+  std::map<uint64_t, Listener> listeners_;
+  uint64_t next_listener_id_ = 0;
+};
+
+} // namespace msensor
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace msensor {
+
+/**
+ * @brief Bounded pool of preallocated objects handed out as `shared_ptr`.
+ *
+ * Every slot keeps one reference to its object. A slot is free again once all
+ * consumers have dropped their copies, i.e. when the pool holds the only
+ * reference. `acquire()` never locks and, while a slot is free, never
+ * allocates. Copying a `shared_ptr` only bumps its reference count.
+ *
+ * \note `acquire()` must be called from a single thread (the producer), and
+ * objects are handed back as they were left. Resetting them is the caller's
+ * job. Consumers must not keep `weak_ptr`s to pooled objects.
+ */
+template <typename T> class ObjectPool {
+public:
+  using Factory = std::function<std::shared_ptr<T>()>;
+
+  /// Preallocate `capacity` objects created by `factory`.
+  ObjectPool(size_t capacity, Factory factory) : factory_(std::move(factory)) {
+    slots_.reserve(capacity);
+    for (size_t i = 0; i < capacity; ++i) {
+      slots_.push_back(factory_());
+    }
+  }
+
+  /**
+   * @brief Return a free object, or a freshly created one if every slot is
+   * still in use. The latter is counted in `misses()` and is not pooled.
+   */
+  std::shared_ptr<T> acquire() {
+    for (size_t i = 0; i < slots_.size(); ++i) {
+      const size_t index = (next_ + i) % slots_.size();
+      if (slots_[index].use_count() == 1) {
+        // Pairs with the release done by the last consumer's decrement.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        next_ = index + 1;
+        return slots_[index];
+      }
+    }
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return factory_();
+  }
+
+  /// Number of preallocated objects.
+  size_t capacity() const { return slots_.size(); }
+
+  /// Number of `acquire()` calls that found the pool exhausted.
+  uint64_t misses() const { return misses_.load(std::memory_order_relaxed); }
+
+private:
+  Factory factory_;
+  std::vector<std::shared_ptr<T>> slots_;
+  size_t next_ = 0;
+  std::atomic<uint64_t> misses_{0};
+};
+
+} // namespace msensor
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+namespace msensor {
+
+/**
+ * @brief Sticky "data ready" notification between a driver and its consumer.
+ *
+ * The producer calls `notify()` after making data available. The consumer
+ * blocks in `waitFor()` instead of polling. A notification raised while
+ * nobody waits is kept until the next `waitFor()`, so no wakeup is lost.
+ */
+class ReadySignal {
+public:
+  /// Signal that new data is available.
+  void notify() {
+    {
+      std::scoped_lock lock(mutex_);
+      ready_ = true;
+    }
+    cv_.notify_all();
+  }
+
+  /// Block until notified or until `timeout` expires. Consumes the
+  /// notification. Returns true if notified.
+  template <typename Rep, typename Period>
+  bool waitFor(std::chrono::duration<Rep, Period> timeout) {
+    std::unique_lock lock(mutex_);
+    const bool ready = cv_.wait_for(lock, timeout, [this] { return ready_; });
+    ready_ = false;
+    return ready;
+  }
+
+private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool ready_ = false;
+};
+
+} // namespace msensor
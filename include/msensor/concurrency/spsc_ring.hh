@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace msensor {
+
+/**
+ * @brief Bounded single-producer single-consumer ring of preallocated slots.
+ *
+ * The producer fills the next slot in place (`writeSlot()` then `commit()`),
+ * so an item is copied once, straight into the ring. Neither side locks.
+ *
+ * `commit()` reports how many items the consumer had not taken yet. With
+ * the consumer checking for new items after `consumeAll()` returns 0, a
+ * producer that wakes the consumer only when that count is 1 never leaves
+ * it asleep on a non-empty ring: the indices are sequentially consistent.
+ */
+template <typename T> class SpscRing {
+public:
+  explicit SpscRing(size_t capacity) : slots_(capacity) {}
+
+  SpscRing(const SpscRing &) = delete;
+  SpscRing &operator=(const SpscRing &) = delete;
+
+  /// Slot to fill next, or null if the ring is full. Producer only.
+  T *writeSlot() {
+    const uint64_t write = write_.load(std::memory_order_relaxed);
+    if (write - read_.load(std::memory_order_acquire) == slots_.size()) {
+      return nullptr;
+    }
+    return &slots_[write % slots_.size()];
+  }
+
+  /// Publish the slot filled since `writeSlot()`. Returns the items queued,
+  /// it included, not yet taken by the consumer. Producer only.
+  size_t commit() {
+    const uint64_t write = write_.load(std::memory_order_relaxed) + 1;
+    write_.store(write, std::memory_order_seq_cst);
+    return static_cast<size_t>(write - read_.load(std::memory_order_seq_cst));
+  }
+
+  /// Pass every queued item to `fn`, oldest first, and free its slot.
+  /// Returns the number of items. Consumer only.
+  template <typename Fn> size_t consumeAll(Fn &&fn) {
+    const uint64_t first = read_.load(std::memory_order_relaxed);
+    const uint64_t write = write_.load(std::memory_order_seq_cst);
+    for (uint64_t read = first; read != write; ++read) {
+      fn(static_cast<const T &>(slots_[read % slots_.size()]));
+      read_.store(read + 1, std::memory_order_seq_cst);
+    }
+    return static_cast<size_t>(write - first);
+  }
+
+  size_t capacity() const { return slots_.size(); }
+
+private:
+  std::vector<T> slots_;
+  alignas(64) std::atomic<uint64_t> write_{0};
+  alignas(64) std::atomic<uint64_t> read_{0};
+};
+
+} // namespace msensor
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <array>
 #include <filesystem>
 #include <string>
+#include <vector>
 
 namespace msensor {
 
@@ -9,6 +11,7 @@ class Config {
 public:
   struct Icm20948Config {
     bool enable = false;
+    int rate_hz = 200; ///< Samples read per second, 1-1100.
   } icm20948;
 
   struct RplidarConfig {
@@ -27,6 +30,23 @@ public:
   struct Mid360Config {
     bool enable = false;
     std::string config;
+    int worker_cpu = -1;          ///< Packet worker CPU, -1 = unpinned.
+    int accumulate_packets = 100; ///< Packets per scan, 0 = window only.
+    int accumulate_window_ms = 0; ///< Scan duration on packet time, 0 = off.
+    int max_points = 0;           ///< Point cap per scan, 0 = no cap.
+    bool deskew = false;          ///< IMU-deskewed scans, one device only.
+    bool merge = false; ///< One cloud per window instead of per device.
+    int scan_queue = 8; ///< Scans queued for the server, at least 1.
+    /// Full scan/IMU queue policy: "drop_oldest", "drop_newest" or "block".
+    std::string overflow = "drop_oldest";
+
+    struct Device {
+      std::string ip;
+      /// x, y, z (m), roll, pitch, yaw (rad) in the rig frame.
+      std::array<float, 6> extrinsic{};
+    };
+    /// Devices to wait for, with their extrinsics. Empty = one device.
+    std::vector<Device> devices;
   } mid360;
 
   struct Ads1115Config {
@@ -34,6 +54,27 @@ public:
     int i2c_bus = 1;
   } ads1115;
 
+  struct TracingConfig {
+    /// Stamp pipeline checkpoints; needs a `WITH_TRACING` build.
+    bool enable = false;
+  } tracing;
+
+  struct ShmConfig {
+    /// Also publish to same-host clients through shared memory.
+    bool enable = false;
+    /// Segment name prefix, see `ShmPublisher::Options`.
+    std::string prefix = "/msensor";
+  } shm;
+
+  struct MulticastConfig {
+    /// Also send lidar and IMU data to a UDP multicast group.
+    bool enable = false;
+    std::string group = "239.255.76.1";
+    int port = 7600; ///< 1-65535.
+    /// Address of the interface to send from; empty for the default.
+    std::string interface;
+  } multicast;
+
   static Config fromFile(const std::filesystem::path &config_path);
   static std::filesystem::path defaultConfigPath();
 };
@@ -1,11 +1,16 @@
 #pragma once
 
+#include <google/protobuf/io/coded_stream.h>
+
 #include "camera.pb.h"
 #include "imu.pb.h"
 #include "lidar.pb.h"
 #include "msensor/interface/ICamera.hh"
 #include "msensor/interface/IImu.hh"
 #include "msensor/interface/ILidar.hh"
+#include "msensor/processing/crop.hh"
+
+#include <vector>
 
 /**
  * @brief Convert a gRPC point cloud message into an msensor point cloud.
@@ -15,7 +20,73 @@ std::shared_ptr<msensor::Scan3DI> fromProtobuf(const sensors::PointCloud3 &msg);
 /**
  * @brief Convert an msensor point cloud to gRPC point cloud message.
  */
-sensors::PointCloud3 toProtobuf(const std::shared_ptr<msensor::Scan3DI> &msg);
+sensors::PointCloud3
+toProtobuf(const std::shared_ptr<const msensor::Scan3DI> &msg);
+
+/**
+ * @brief Fill `point_cloud` from an msensor point cloud in place.
+ *
+ * Reuses the capacity of the packed fields, so refilling the same (e.g.
+ * arena-owned) message for every scan does not allocate in steady state.
+ */
+void toProtobuf(const std::shared_ptr<const msensor::Scan3DI> &msg,
+                sensors::PointCloud3 *point_cloud);
+
+/**
+ * @brief Size in bytes of `scan` serialized as a `sensors::PointCloud3`.
+ */
+size_t pointCloudByteSize(const std::shared_ptr<const msensor::Scan3DI> &scan);
+
+/**
+ * @brief Serialize `scan` as a `sensors::PointCloud3` straight into `output`.
+ *
+ * Deinterleaves the PCL points into the packed fields without building the
+ * intermediate message. The header is written as is: unlike `toProtobuf()`,
+ * no serialization-done checkpoint is stamped, so the bytes always match
+ * `pointCloudByteSize()` and equal `toProtobuf(scan).SerializeToCodedStream()`
+ * only while tracing is disabled. Write the `pointCloudByteSize()` length
+ * prefix first when embedding it as a sub-message.
+ */
+void writePointCloud(const std::shared_ptr<const msensor::Scan3DI> &scan,
+                     google::protobuf::io::CodedOutputStream *output);
+
+/**
+ * @brief Convert an msensor point cloud to the compact packed wire format.
+ *
+ * Coordinates are quantized to `encoding.scale()` metres (1 mm if zero) and
+ * intensity is clamped to one byte. Optionally delta-encodes coordinates and
+ * compresses the point payload. The returned message records the encoding
+ * actually applied, e.g. compression falls back to none when the library is
+ * built without zstd.
+ */
+sensors::PointCloud3Packed
+toProtobuf(const std::shared_ptr<const msensor::Scan3DI> &msg,
+           const sensors::PackedEncoding &encoding);
+
+/**
+ * @brief Fill `packed` in place, reusing its buffers across scans.
+ */
+void toProtobuf(const std::shared_ptr<const msensor::Scan3DI> &msg,
+                const sensors::PackedEncoding &encoding,
+                sensors::PointCloud3Packed *packed);
+
+/**
+ * @brief Convert a packed gRPC point cloud message into an msensor point
+ * cloud. Returns an empty scan if the payload cannot be decoded.
+ */
+std::shared_ptr<msensor::Scan3DI>
+fromProtobuf(const sensors::PointCloud3Packed &msg);
+
+/**
+ * @brief Convert a gRPC crop region into an msensor one. Unset fields leave
+ * their test off.
+ */
+msensor::CropRegion fromProtobuf(const sensors::CropRegion &msg);
+
+/**
+ * @brief Convert an msensor crop region into a gRPC one.
+ */
+sensors::CropRegion toProtobuf(const msensor::CropRegion &region);
 
 /**
  * @brief Convert a gRPC IMU message into an msensor IMU sample.
@@ -27,6 +98,23 @@ msensor::IMUData fromProtobuf(const sensors::IMUData &msg);
  */
 sensors::IMUData toProtobuf(msensor::IMUData msg);
 
+/**
+ * @brief Append a msensor IMU sample to a columnar gRPC IMU batch. The first
+ * sample appended sets the batch header.
+ */
+void appendToBatch(sensors::ImuBatch &batch, const msensor::IMUData &imu);
+
+/**
+ * @brief Mark a columnar gRPC IMU batch as complete, before it is written:
+ * stamps its serialization-done trace checkpoint.
+ */
+void sealBatch(sensors::ImuBatch &batch);
+
+/**
+ * @brief Convert a gRPC IMU batch into msensor IMU samples.
+ */
+std::vector<msensor::IMUData> fromProtobuf(const sensors::ImuBatch &msg);
+
 /**
  * @brief Converts a msensor camera frame to gRPC camera message.
  *
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "msensor/interface/IImu.hh"
+#include <chrono>
 #include <stdint.h>
 
 
@@ -24,7 +25,13 @@ public:
 
   enum ACC_SCALE { G_16 = 3, G_8 = 2, G_4 = 1, G_2 = 0 };
 
-  ICM20948(int i2c_device, int i2c_icm_address);
+  /// Default rate at which samples are read, in Hz.
+  static constexpr int g_defaultRateHz = 200;
+
+  /// Open the device. Samples are read at `rate_hz` (1-1100, the gyro's
+  /// output data rate without a divider).
+  ICM20948(int i2c_device, int i2c_icm_address,
+           int rate_hz = g_defaultRateHz);
   virtual ~ICM20948() = default;
 
   bool init() const;
@@ -35,6 +42,9 @@ public:
 
   std::optional<IMUData> getImuData() override;
 
+  /// Sleep until the next sample is due at the configured rate.
+  bool waitForImuData(std::chrono::milliseconds timeout) override;
+
 private:
   xyz_data_ get_acc_data() const;
   xyz_data_ get_gyro_data() const;
@@ -102,7 +112,8 @@ private:
   const int i2c_device_;
   const int i2c_icm_address_;
   int i2c_device_fd_;
-  
+  const std::chrono::steady_clock::duration period_;
+  std::chrono::steady_clock::time_point next_sample_{};
 };
 
 }
\ No newline at end of file
@@ -4,9 +4,27 @@
 
 namespace msensor {
 
+/**
+ * @brief Wall-clock times (epoch ns) at which a sample passed each pipeline
+ * stage. Zero means not recorded; stages are only stamped while tracing is
+ * enabled, see `msensor/timing/trace.hh`.
+ */
+struct Trace {
+  uint64_t driver_receive_ns = 0;     ///< Driver received the last raw data.
+  uint64_t conversion_done_ns = 0;    ///< Driver finished building the sample.
+  uint64_t serialization_done_ns = 0; ///< Server filled the message.
+  uint64_t write_start_ns = 0;        ///< Server handed it to gRPC.
+
+  bool empty() const {
+    return driver_receive_ns == 0 && conversion_done_ns == 0 &&
+           serialization_done_ns == 0 && write_start_ns == 0;
+  }
+};
+
 struct Header {
   uint64_t timestamp;       ///< Acquisition timestamp in nanoseconds.
   uint32_t sequence_number; ///< Sequence number of the data sample, incremented
                             ///< for each new sample.
+  Trace trace{};            ///< Optional pipeline checkpoints.
 };
-} // namespace msensor
\ No newline at end of file
+} // namespace msensor
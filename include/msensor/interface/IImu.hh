@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <optional>
 #include <stdint.h>
 
@@ -32,6 +33,18 @@ public:
    *         is ready.
    */
   virtual std::optional<IMUData> getImuData() = 0;
+
+  /**
+   * @brief Block until an IMU sample is ready or `timeout` expires.
+   *
+   * The default returns immediately, which suits drivers whose
+   * `getImuData()` already blocks (e.g. SimImu).
+   *
+   * @return true if `getImuData()` is expected to return a sample.
+   */
+  virtual bool waitForImuData(std::chrono::milliseconds /*timeout*/) {
+    return true;
+  }
 };
 
 } // namespace msensor
@@ -5,7 +5,9 @@
 
 #include "msensor/interface/Header.hh"
 
+#include <chrono>
 #include <stdint.h>
+#include <vector>
 
 namespace msensor {
 
@@ -35,6 +37,12 @@ struct Scan3DI {
   Scan3DI() : points(pcl::make_shared<PointCloud3I>()), header(Header{0, 0}) {}
   Header header;
   PointCloud3I::Ptr points;
+  /// Optional per-point measurement time, in microseconds after
+  /// `header.timestamp`. Either empty or one entry per point.
+  std::vector<uint32_t> time_offsets_us;
+  /// Driver-specific id of the device that produced the scan. 0 when there is
+  /// a single device or the scan merges several.
+  uint32_t device_id = 0;
 };
 
 /**
@@ -62,8 +70,22 @@ public:
    *
    * @return Scan3DI
    * @note The associated timestamp is assumed to be the time
-   * point[0] was measured. Unit: ns (1/1000000000 sec).
+   * point[0] was measured. Unit: ns (1/1000000000 sec). Drivers that know
+   * the time of every point also fill `Scan3DI::time_offsets_us`.
    */
   virtual std::shared_ptr<Scan3DI> getScan() = 0;
+
+  /**
+   * @brief Block until a scan is ready or `timeout` expires.
+   *
+   * Lets consumers sleep instead of polling `getScan()`. The default returns
+   * immediately, which suits drivers whose `getScan()` already blocks until
+   * data arrives (e.g. RPLidar, SimLidar).
+   *
+   * @return true if `getScan()` is expected to return a scan.
+   */
+  virtual bool waitForScan(std::chrono::milliseconds /*timeout*/) {
+    return true;
+  }
 };
 } // namespace msensor
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "msensor/interface/ILidar.hh"
+
+namespace msensor::livox {
+
+/// Size of a packed `LivoxLidarCartesianHighRawPoint` (3 x int32 mm,
+/// reflectivity, tag).
+constexpr size_t g_cartesianHighPointSize = 14;
+
+/// Maximum number of Cartesian points carried by one ethernet packet.
+constexpr size_t g_maxPointsPerPacket = 96;
+
+/// Implementations of the Cartesian point conversion.
+enum class Kernel { Scalar, Sse2, Neon };
+
+/// Fastest kernel supported by the running CPU. Detected once.
+Kernel bestKernel();
+
+/// Whether `kernel` can run on this CPU.
+bool isSupported(Kernel kernel);
+
+/**
+ * @brief Convert `count` packed Cartesian high points (millimetres) into
+ * `dest[0..count)` in metres, using `bestKernel()`.
+ *
+ * `raw` points at the payload of a Livox ethernet packet and need not be
+ * aligned. `dest` must hold at least `count` points.
+ */
+void convertCartesianHigh(const uint8_t *raw, size_t count, Point3I *dest);
+
+/// Same as above with an explicit kernel, which must be supported.
+void convertCartesianHigh(const uint8_t *raw, size_t count, Point3I *dest,
+                          Kernel kernel);
+
+} // namespace msensor::livox
@@ -1,19 +1,41 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
 #include <string>
+#include <thread>
 
+#include <Eigen/Core>
+
+#include "msensor/concurrency/bounded_queue.hh"
+#include "msensor/concurrency/object_pool.hh"
+#include "msensor/concurrency/ready_signal.hh"
+#include "msensor/concurrency/spsc_ring.hh"
 #include "msensor/interface/IImu.hh"
 #include "msensor/interface/ILidar.hh"
-
-#include <boost/lockfree/spsc_queue.hpp>
+#include "msensor/lidar/livox_conversion.hh"
 
 namespace msensor {
 
+/// Maximum number of Mid360 devices served by one driver instance.
+constexpr size_t g_mid360MaxDevices = 8;
+/// Pooled scans beyond the queue and the ones being accumulated: scans are
+/// also held downstream, e.g. by the server's scan hub and in-flight writes.
+constexpr size_t g_mid360ScanPoolHeadroom = 16;
+
 /**
  * @brief This class represents a Mid360 lidar, with getters methods to receive
  * LiDAR data. It has an embedded IMU sensor, therefore IImu is inherited as
  * well.
  *
+ * Every Mid360 reachable through the SDK configuration is handled by the same
+ * instance. Each device has its own packet ring, accumulator, sequence
+ * counters and extrinsic. Their scans are either delivered one by one, tagged
+ * with `Scan3DI::device_id`, or merged per time window. IMU samples come from
+ * the first device that connected.
+ *
  * \note Manual:
  * https://livox-wiki-en.readthedocs.io/en/latest/tutorials/new_product/mid360/livox_eth_protocol_mid360.html#point-cloud-imu-data-protocol
  *
@@ -23,18 +45,93 @@ public:
   enum class ScanPattern { Repetitive, NonRepetitive, LowFrameRate };
   enum class Mode { Normal, PowerSave };
 
+  /// Counters of the raw packet rings between the SDK thread and the worker,
+  /// summed over all devices.
+  struct PacketStats {
+    uint64_t received = 0;      ///< Packets handed over by the SDK.
+    uint64_t dropped = 0;       ///< Packets lost because a ring was full.
+    size_t ring_high_water = 0; ///< Deepest ring occupancy observed.
+    size_t ring_capacity = 0;   ///< Packets each ring can hold.
+    uint64_t late_scans = 0;    ///< Device scans too late for their merge.
+  };
+
+  /**
+   * @brief When an accumulated scan is emitted. Each non-zero limit closes the
+   * scan when reached; at least one of `packets` or `window` must be set.
+   */
+  struct Accumulation {
+    size_t packets = 100; ///< Emit after this many UDP packets.
+    /// Emit at the end of each `window`-long interval of packet time. The
+    /// intervals are aligned to multiples of `window`, so scans of several
+    /// devices cover the same span.
+    std::chrono::milliseconds window{0};
+    size_t max_points = 0; ///< Emit early rather than exceed this many points.
+  };
+
+  /// Pose of a device in the rig frame: metres and roll/pitch/yaw radians.
+  struct Extrinsic {
+    float x = 0;
+    float y = 0;
+    float z = 0;
+    float roll = 0;
+    float pitch = 0;
+    float yaw = 0;
+  };
+
+  /// How the scans of several devices are delivered.
+  enum class Output {
+    /// One scan per device, tagged with `Scan3DI::device_id`. Scans of all
+    /// devices come interleaved from the same `getScan()`.
+    PerDevice,
+    Merged, ///< One cloud per time window combining every device.
+  };
+
+  struct Options {
+    Accumulation accumulation;
+    int worker_cpu = -1; ///< CPU of the packet worker, -1 = unpinned.
+    /// `Merged` needs `accumulation.window` and ignores `packets`.
+    Output output = Output::PerDevice;
+    size_t expected_devices = 1; ///< Devices `init()` waits for.
+    std::map<std::string, Extrinsic> extrinsics{}; ///< Keyed by device IP.
+    /// Scans queued for `getScan()`. The driver preallocates this many
+    /// scans plus one per device and `g_mid360ScanPoolHeadroom`, each
+    /// reserved for a full scan at ~36 bytes per point: ~9 MB with the
+    /// defaults (26 scans of 9600 points).
+    size_t scan_queue_capacity = 8;
+    /// What happens to scans and IMU samples nobody picks up in time.
+    Overflow overflow = Overflow::DropOldest;
+    /// How long `Overflow::Block` stalls the packet worker. The SDK thread
+    /// never blocks: it hands over to the worker through fixed rings.
+    std::chrono::milliseconds block_timeout{10};
+  };
+
   /**
    * @brief Construct a new Mid360 object.
    *
    * @param config Configuration file to be loaded. \note The IP address of the
    * LiDAR is one of the configuration elements. Make sure your machine lies
    * within a reacheable subnet of the LiDAR.
-   * @param accumulate_scan_count number of samples to accumulate when returning
-   * data from getScan(). Typically the number of points per `getScan` is 96 *
+   * @param options accumulation, output mode and per-device extrinsics.
+   */
+  Mid360(std::string config, Options options);
+
+  /**
+   * @brief Construct a Mid360 emitting scans per `accumulation`.
+   *
+   * @param worker_cpu CPU the packet processing thread is pinned to, or -1 to
+   * leave it unpinned.
+   */
+  Mid360(std::string config, Accumulation accumulation, int worker_cpu = -1);
+
+  /**
+   * @brief Construct a Mid360 emitting a scan every `accumulate_scan_count`
+   * UDP packets. Typically the number of points per `getScan` is 96 *
    * `accumulate_scan_count`.
    */
-  Mid360(std::string config, size_t accumulate_scan_count);
-  /// Initialize the Livox driver and connect to the device.
+  Mid360(std::string config, size_t accumulate_scan_count,
+         int worker_cpu = -1);
+  ~Mid360();
+  /// Initialize the Livox driver and wait for `Options::expected_devices`.
   void init() override;
 
   /// Retrieve the next accumulated point cloud.
@@ -42,34 +139,130 @@ public:
   /// first UDP packet accumulated into the returned scan.
   std::shared_ptr<Scan3DI> getScan() override;
 
+  /// Block until an accumulated scan is queued. Signalled from the Livox
+  /// point cloud callback.
+  bool waitForScan(std::chrono::milliseconds timeout) override;
+
   /// Retrieve the latest IMU sample from the embedded sensor.
   /// \note Time is in nanoseconds.
   std::optional<IMUData> getImuData() override;
 
+  /// Block until an IMU sample is queued. Signalled from the Livox IMU
+  /// callback.
+  bool waitForImuData(std::chrono::milliseconds timeout) override;
+
   /// Start sampling LiDAR and IMU data.
   void startSampling() override;
 
   /// Stop sampling operations.
   void stopSampling() override;
 
-  /// Switch power/normal operating mode.
+  /// Switch power/normal operating mode of every device.
   void setMode(Mode mode);
 
-  /// Configure point emission pattern.
+  /// Configure point emission pattern of every device.
   void setScanPattern(ScanPattern pattern) const;
 
+  /// Snapshot of the packet ring counters. Thread-safe.
+  PacketStats packetStats() const;
+
+  /// Number of devices connected so far.
+  size_t deviceCount() const;
+
+  /// Counters of the queue behind getScan(). Thread-safe.
+  QueueStats scanQueueStats() const;
+
+  /// Counters of the queue behind getImuData(). Thread-safe.
+  QueueStats imuQueueStats() const;
+
 private:
+  /// Point payload of one Livox ethernet packet, copied off the SDK thread.
+  struct RawPacket {
+    uint64_t timestamp;
+    uint16_t time_interval; ///< Packet time span, 0.1 us units.
+    uint16_t dot_num;
+    uint64_t received_ns; ///< Trace checkpoint, 0 unless tracing.
+    std::array<uint8_t,
+               livox::g_maxPointsPerPacket * livox::g_cartesianHighPointSize>
+        payload;
+  };
+
+  /// State of one connected Mid360.
+  struct Device {
+    Device(size_t index, uint32_t handle, std::string ip);
+
+    const size_t index;
+    const uint32_t handle;
+    const std::string ip;
+    bool has_extrinsic = false;
+    Eigen::Matrix4f extrinsic = Eigen::Matrix4f::Identity();
+
+    // SDK callback -> worker hand-off. Only the SDK thread fills slots and
+    // updates the counters; only the worker consumes.
+    SpscRing<RawPacket> packet_ring;
+    std::atomic<uint64_t> packets_received{0};
+    std::atomic<uint64_t> packets_dropped{0};
+    std::atomic<size_t> ring_high_water{0};
+    uint32_t imu_sequence_number = 0;
+
+    // Accumulation state, owned by the worker.
+    std::shared_ptr<Scan3DI> accumulated;
+    uint64_t window_index = 0;
+    size_t packets_in_scan = 0;
+    uint32_t scan_sequence_number = 0;
+  };
+
+  /// Track a device reported by the SDK. Called from the SDK thread.
+  void registerDevice(uint32_t handle, const std::string &ip);
+  /// Connected device with `handle`, or null.
+  Device *findDevice(uint32_t handle) const;
+
+  /// Worker loop: drains the packet rings into accumulated scans.
+  void processPackets(std::stop_token stop_token);
+  /// Convert one packet into the device's scan, emitting it per
+  /// `Options::accumulation`.
+  void accumulate(Device &device, const RawPacket &packet);
+  /// Hand the device's current scan on and start a new one. `window_done`
+  /// is false if the scan was cut short of its window by `max_points`.
+  void emitScan(Device &device, bool window_done);
+  /// Add a device scan to the merged cloud of its time window, which is
+  /// queued once every device is done with the window.
+  void merge(const Device &device, const Scan3DI &scan, bool window_done);
+  /// Queue the merged cloud and start a new one.
+  void emitMerged();
+  /// Queue a finished scan for getScan().
+  void queueScan(std::shared_ptr<Scan3DI> scan);
+
   const std::string config_;
-  std::shared_ptr<Scan3DI> accumulated_pointcloud_data_;
+  const Options options_;
+  /// Preallocated scans, so the packet worker does not allocate.
+  ObjectPool<Scan3DI> scan_pool_;
 
-  boost::lockfree::spsc_queue<std::shared_ptr<Scan3DI>> scan_queue_;
-  boost::lockfree::spsc_queue<IMUData> imu_queue_;
+  BoundedQueue<std::shared_ptr<Scan3DI>> scan_queue_;
+  // SDK IMU callback -> worker hand-off, as the packet rings; the worker
+  // applies `Options::overflow` when moving samples into `imu_queue_`.
+  SpscRing<IMUData> imu_ring_;
+  std::atomic<uint64_t> imu_ring_dropped_{0};
+  BoundedQueue<IMUData> imu_queue_;
+  ReadySignal scan_ready_;
+  ReadySignal imu_ready_;
 
-  const size_t accumulate_scan_count_;
+  // Devices are only appended, by the SDK thread, and published through
+  // `device_count_`.
+  std::array<std::unique_ptr<Device>, g_mid360MaxDevices> devices_;
+  std::atomic<size_t> device_count_{0};
+  ReadySignal device_ready_;
+  ReadySignal packet_ready_;
 
-  size_t scan_count_;
+  // Merged output, owned by the worker.
+  std::shared_ptr<Scan3DI> merged_;
+  uint64_t merged_window_ = 0; ///< Of `merged_`, or of the last one queued.
+  uint32_t merged_devices_ = 0; ///< Bit per contributing device index.
+  uint32_t merged_sequence_number_ = 0;
+  std::atomic<uint64_t> late_scans_{0};
 
-  uint32_t connection_handle_;
+  // Declared last so it is joined before the state it uses is destroyed.
+  std::jthread worker_;
 };
 
 } // namespace msensor
\ No newline at end of file
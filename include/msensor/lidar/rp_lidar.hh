@@ -6,6 +6,13 @@
 
 namespace msensor {
 
+/**
+ * @brief Convert one revolution of RPLidar HQ nodes into a planar scan,
+ * skipping nodes of quality below 40.
+ */
+std::shared_ptr<Scan3DI>
+toScan3D(const sl_lidar_response_measurement_node_hq_t *nodes, int count);
+
 /**
  * @brief Wrapper around the RPLidar SDK providing the ILidar interface.
  */
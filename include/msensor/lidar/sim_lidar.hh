@@ -10,8 +10,8 @@ namespace msensor {
 class SimLidar : public ILidar {
 public:
   /// Construct a SimLidar. If `steady` is true, the same scan will be returned
-  /// on each call to `getScan()`.
-  SimLidar(bool steady = false);
+  /// on each call to `getScan()`. Each scan has `points` points.
+  SimLidar(bool steady = false, size_t points = 2000);
   /// Initialize simulator resources.
   void init() override;
   /// Begin generating simulated scans.
@@ -23,6 +23,7 @@ public:
 
 private:
   bool steady_;
+  size_t points_;
 };
 
 } // namespace msensor
\ No newline at end of file
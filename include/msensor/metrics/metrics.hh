@@ -0,0 +1,150 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace msensor::metrics {
+
+/// Cache lines each counter and histogram is spread over.
+constexpr size_t g_shards = 16;
+/// Histogram buckets: upper bounds 1, 2, 4, ... 2^22, then +Inf.
+constexpr size_t g_histogramBuckets = 24;
+
+/// Shard of the calling thread. Threads are assigned shards round-robin, so
+/// up to `g_shards` threads update a metric without sharing a cache line.
+size_t threadShard();
+
+using Labels = std::map<std::string, std::string>;
+
+/// Monotonic counter. `add()` is a relaxed increment of the caller's shard.
+class Counter {
+public:
+  void add(uint64_t n = 1) {
+    shards_[threadShard()].value.fetch_add(n, std::memory_order_relaxed);
+  }
+
+  uint64_t value() const;
+
+private:
+  struct alignas(64) Shard {
+    std::atomic<uint64_t> value{0};
+  };
+  std::array<Shard, g_shards> shards_;
+};
+
+/// Value that goes up and down, e.g. a depth or a number of clients.
+class Gauge {
+public:
+  void set(int64_t value) { value_.store(value, std::memory_order_relaxed); }
+  void add(int64_t n) { value_.fetch_add(n, std::memory_order_relaxed); }
+  int64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<int64_t> value_{0};
+};
+
+/**
+ * @brief Distribution of integer observations, e.g. durations in
+ * microseconds, over power-of-two buckets.
+ */
+class Histogram {
+public:
+  struct Snapshot {
+    std::array<uint64_t, g_histogramBuckets> counts{}; ///< Per bucket.
+    uint64_t sum = 0;
+    uint64_t count = 0;
+  };
+
+  void observe(uint64_t value);
+
+  Snapshot snapshot() const;
+
+  /// Inclusive upper bound of `bucket`; the last bucket is unbounded.
+  static uint64_t upperBound(size_t bucket) { return uint64_t{1} << bucket; }
+
+private:
+  struct alignas(64) Shard {
+    std::array<std::atomic<uint64_t>, g_histogramBuckets> counts{};
+    std::atomic<uint64_t> sum{0};
+  };
+  std::array<Shard, g_shards> shards_;
+};
+
+enum class Type { Counter, Gauge, Histogram };
+
+/// One metric read by `Registry::collect()`.
+struct Sample {
+  std::string name;
+  std::string help;
+  Type type;
+  Labels labels;
+  double value = 0; ///< Counters and gauges.
+  std::optional<Histogram::Snapshot> histogram{};
+};
+
+/**
+ * @brief Named, labelled metrics of one process.
+ *
+ * Creating or removing a metric locks the registry; updating one never does.
+ * Metrics are looked up once (e.g. when a stream opens) and then updated
+ * through the returned pointer.
+ */
+class Registry {
+public:
+  /// Get or create the counter `name` with `labels`.
+  std::shared_ptr<Counter> counter(const std::string &name,
+                                   const std::string &help,
+                                   const Labels &labels = {});
+  /// Get or create the gauge `name` with `labels`.
+  std::shared_ptr<Gauge> gauge(const std::string &name,
+                               const std::string &help,
+                               const Labels &labels = {});
+  /// Get or create the histogram `name` with `labels`.
+  std::shared_ptr<Histogram> histogram(const std::string &name,
+                                       const std::string &help,
+                                       const Labels &labels = {});
+
+  /// Register a metric whose value is read by `read` at collection time, for
+  /// state owned elsewhere such as driver queues. `type` is Counter or Gauge.
+  /// `read` runs without the registry locked, possibly once more right
+  /// after the metric is removed.
+  void callback(Type type, const std::string &name, const std::string &help,
+                const Labels &labels, std::function<double()> read);
+
+  /// Remove every metric whose labels include all of `labels`.
+  void remove(const Labels &labels);
+
+  /// Read every metric, sorted by name.
+  std::vector<Sample> collect() const;
+
+  /// Every metric in the Prometheus text exposition format.
+  std::string prometheusText() const;
+
+private:
+  struct Entry {
+    std::string name;
+    std::string help;
+    Type type;
+    Labels labels;
+    std::shared_ptr<Counter> counter{};
+    std::shared_ptr<Gauge> gauge{};
+    std::shared_ptr<Histogram> histogram{};
+    std::function<double()> read{};
+  };
+
+  Entry &findOrAdd(const std::string &name, const std::string &help,
+                   Type type, const Labels &labels);
+
+  mutable std::mutex mutex_;
+  std::vector<Entry> entries_;
+};
+
+} // namespace msensor::metrics
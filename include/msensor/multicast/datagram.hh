@@ -0,0 +1,145 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace msensor {
+
+/// Streams multiplexed on one multicast group.
+enum class MulticastStream : uint8_t { Lidar = 0, Imu = 1 };
+constexpr size_t g_multicastStreams = 2;
+
+/**
+ * @brief Header prepended to every datagram. A message (a scan or an IMU
+ * sample, see `msensor/shm/shm_records.hh`) is split into fragments that
+ * each fit one datagram.
+ *
+ * Fields are in host order: publishers and receivers are expected to be
+ * little-endian, like the records they carry.
+ */
+struct DatagramHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint8_t stream; ///< `MulticastStream`.
+  uint8_t reserved;
+  uint32_t session;  ///< Random per publisher: a new one means a restart.
+  uint32_t sequence; ///< Message number, per stream.
+  uint32_t message_bytes;
+  /// Carried by every fragment but the last, which has the remainder.
+  uint32_t fragment_bytes;
+  uint16_t fragment;
+  uint16_t fragments;
+};
+static_assert(std::endian::native == std::endian::little);
+
+/// Position of a fragment in its message.
+inline size_t fragmentOffset(const DatagramHeader &header) {
+  return size_t{header.fragment} * header.fragment_bytes;
+}
+
+/// Message bytes carried by a fragment, once its header is validated.
+inline size_t fragmentPayloadBytes(const DatagramHeader &header) {
+  return std::min<size_t>(header.fragment_bytes,
+                          header.message_bytes - fragmentOffset(header));
+}
+
+/// UDP payload of a datagram in a 1500-byte Ethernet MTU.
+constexpr size_t g_defaultDatagramBytes = 1500 - 20 - 8;
+
+/**
+ * @brief Splits messages into datagrams without copying them: datagram `i`
+ * is `headers()[i]` followed by `fragmentPayloadBytes()` message bytes at
+ * its `fragmentOffset()`.
+ */
+class Fragmenter {
+public:
+  /// Fragments of at most `datagram_bytes` bytes, header included.
+  Fragmenter(MulticastStream stream, uint32_t session,
+             size_t datagram_bytes = g_defaultDatagramBytes);
+
+  /// Headers of the fragments of the next message, `message_bytes` long.
+  std::span<const DatagramHeader> fragment(size_t message_bytes);
+
+private:
+  DatagramHeader next_;
+  size_t payload_bytes_;
+  std::vector<DatagramHeader> headers_;
+};
+
+/**
+ * @brief Rebuilds messages from datagrams received in any order, and counts
+ * the messages lost.
+ *
+ * Up to `window` messages per stream are assembled at once. A message is
+ * counted as lost once `window` newer ones have started without it being
+ * complete; fragments arriving later than that are dropped as late.
+ */
+class Reassembler {
+public:
+  struct Message {
+    MulticastStream stream;
+    uint32_t sequence;
+    std::span<const std::byte> bytes; ///< Valid until the next `add()`.
+  };
+
+  /// Counters of one stream, since construction.
+  struct Stats {
+    uint64_t datagrams = 0;
+    uint64_t messages = 0; ///< Messages completed.
+    uint64_t lost = 0;
+    uint64_t late = 0;    ///< Fragments of messages already given up on.
+    uint64_t invalid = 0; ///< Malformed or duplicate fragments.
+    uint64_t restarts = 0;
+  };
+
+  explicit Reassembler(size_t window = 4,
+                       size_t max_message_bytes = 16 * 1024 * 1024);
+
+  /**
+   * @brief Add one datagram. Returns the message it completes, if any.
+   *
+   * Fragments whose size or offset does not match their index are invalid,
+   * so a completed message has every byte written by its own fragments.
+   */
+  std::optional<Message> add(std::span<const std::byte> datagram);
+
+  const Stats &stats(MulticastStream stream) const {
+    return streams_[static_cast<size_t>(stream)].stats;
+  }
+
+private:
+  struct Slot {
+    bool used = false;
+    bool complete = false;
+    uint32_t sequence = 0;
+    uint32_t received = 0;
+    uint32_t fragment_bytes = 0;
+    size_t received_bytes = 0;
+    std::vector<uint8_t> have; ///< Per fragment.
+    std::vector<std::byte> bytes;
+  };
+  struct Stream {
+    bool started = false;
+    uint32_t session = 0;
+    uint32_t first = 0;  ///< First sequence of the session.
+    uint32_t newest = 0; ///< Newest sequence started.
+    std::vector<Slot> slots;
+    Stats stats;
+  };
+
+  /// Move the window of `stream` to end at `sequence`, resolving the
+  /// messages that leave it.
+  void advance(Stream &stream, uint32_t sequence);
+
+  size_t window_;
+  size_t max_message_bytes_;
+  std::array<Stream, g_multicastStreams> streams_;
+};
+
+} // namespace msensor
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <netinet/in.h>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "msensor/concurrency/broadcast_hub.hh"
+#include "msensor/interface/IImu.hh"
+#include "msensor/interface/ILidar.hh"
+#include "msensor/multicast/datagram.hh"
+
+namespace msensor {
+
+/**
+ * @brief Sends the scans and IMU samples of in-process hubs to a UDP
+ * multicast group, for `MulticastReceiver`s on the LAN.
+ *
+ * Every item is encoded and sent once whatever the number of receivers.
+ * Scans are split into datagrams of `datagram_bytes` and sent in batches
+ * with `sendmmsg`, straight from the encoded record, on the hub producer
+ * thread without blocking it. UDP gives no delivery guarantee: receivers
+ * count what they lose.
+ */
+class MulticastPublisher {
+public:
+  using ScanHub = BroadcastHub<std::shared_ptr<const Scan3DI>>;
+  using ImuHub = BroadcastHub<IMUData>;
+
+  struct Options {
+    std::string group = "239.255.76.1";
+    uint16_t port = 7600;
+    /// Address of the local interface to send from; empty for the default.
+    std::string interface;
+    /// 1 keeps datagrams on the local network.
+    int ttl = 1;
+    /// UDP payload per datagram; the default fits a 1500-byte MTU.
+    size_t datagram_bytes = g_defaultDatagramBytes;
+  };
+
+  /**
+   * @brief Open the socket and start sending from every non-null hub.
+   * @throws std::runtime_error if the socket cannot be set up.
+   */
+  MulticastPublisher(const Options &options, std::shared_ptr<ScanHub> scans,
+                     std::shared_ptr<ImuHub> imu);
+  MulticastPublisher(const MulticastPublisher &) = delete;
+  MulticastPublisher &operator=(const MulticastPublisher &) = delete;
+  /// Detach from the hubs, then close the socket.
+  ~MulticastPublisher();
+
+  /// Datagrams not sent: refused by the kernel, or dropped because the
+  /// send buffer was full, as sending never waits for room in it.
+  uint64_t sendErrors() const {
+    return send_errors_.load(std::memory_order_relaxed);
+  }
+
+private:
+  template <typename Hub, typename Send>
+  void attach(const std::shared_ptr<Hub> &hub, Send send);
+
+  /// Fragment and send `message`. Called from one producer thread per
+  /// stream.
+  void send(Fragmenter &fragmenter, std::span<const std::byte> message);
+
+  int socket_ = -1;
+  sockaddr_in group_{};
+  Fragmenter scan_fragmenter_;
+  Fragmenter imu_fragmenter_;
+  std::vector<std::byte> scan_record_;
+  std::vector<std::function<void()>> detach_;
+  std::atomic<uint64_t> send_errors_{0};
+};
+
+} // namespace msensor
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "msensor/concurrency/bounded_queue.hh"
+#include "msensor/concurrency/ready_signal.hh"
+#include "msensor/interface/IImu.hh"
+#include "msensor/interface/ILidar.hh"
+#include "msensor/multicast/datagram.hh"
+
+namespace msensor {
+
+/**
+ * @brief Joins the multicast group of a `MulticastPublisher` and provides
+ * its scans and IMU samples through the same interfaces as
+ * `SensorsRemoteClient`.
+ *
+ * A background thread reassembles the datagrams. Messages missing a
+ * fragment are dropped and counted in `stats()`.
+ */
+class MulticastReceiver : public ILidar, public IImu {
+public:
+  struct Options {
+    std::string group = "239.255.76.1";
+    uint16_t port = 7600;
+    /// Address of the local interface to join on; empty for the default.
+    std::string interface;
+    /// Messages of a stream assembled at once; fragments reordered further
+    /// than that are dropped.
+    size_t window = 4;
+  };
+
+  /**
+   * @brief Open the socket and join the group.
+   * @throws std::runtime_error if the socket cannot be set up.
+   */
+  explicit MulticastReceiver(const Options &options);
+  ~MulticastReceiver() override;
+
+  void init() override {}
+  /// Start the background thread that receives datagrams.
+  void start();
+  /// Stop the background thread.
+  void stop();
+  void startSampling() override {}
+  void stopSampling() override {}
+
+  /// Pop the next reassembled scan.
+  std::shared_ptr<Scan3DI> getScan() override;
+  /// Block until a scan has been reassembled.
+  bool waitForScan(std::chrono::milliseconds timeout) override;
+  /// Pop the next IMU sample.
+  std::optional<IMUData> getImuData() override;
+  /// Block until an IMU sample has been received.
+  bool waitForImuData(std::chrono::milliseconds timeout) override;
+
+  /// Datagram and message counters of `stream`, losses included.
+  Reassembler::Stats stats(MulticastStream stream) const;
+
+private:
+  /// Receive loop: reassembles messages and queues them.
+  void receive(std::stop_token stop_token);
+
+  int socket_ = -1;
+  mutable std::mutex mutex_; ///< Guards `reassembler_`.
+  Reassembler reassembler_;
+  BoundedQueue<std::shared_ptr<Scan3DI>> scan_queue_;
+  BoundedQueue<IMUData> imu_queue_;
+  ReadySignal scan_ready_;
+  ReadySignal imu_ready_;
+  std::jthread receiver_;
+};
+
+} // namespace msensor
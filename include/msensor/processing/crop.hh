@@ -0,0 +1,49 @@
+#pragma once
+
+#include <array>
+#include <limits>
+
+#include "msensor/interface/ILidar.hh"
+
+namespace msensor {
+
+/**
+ * @brief Part of a scan a stream keeps. Every test is optional; the default
+ * region keeps every finite point.
+ */
+struct CropRegion {
+  static constexpr float g_infinity = std::numeric_limits<float>::infinity();
+
+  /// Axis-aligned box, in metres, bounds included.
+  std::array<float, 3> box_min{-g_infinity, -g_infinity, -g_infinity};
+  std::array<float, 3> box_max{g_infinity, g_infinity, g_infinity};
+  /// Distance to the sensor origin, in metres, bounds included.
+  float min_range = 0.0F;
+  float max_range = g_infinity;
+  /// Sector swept counter-clockwise from `azimuth_min` to `azimuth_max`,
+  /// radians from +x towards +y. Equal angles: the whole turn.
+  float azimuth_min = 0.0F;
+  float azimuth_max = 0.0F;
+  float min_intensity = -g_infinity;
+
+  /// True if no test is set, i.e. cropping would only drop NaN points.
+  bool keepsAll() const {
+    for (size_t axis = 0; axis < 3; ++axis) {
+      if (box_min[axis] != -g_infinity || box_max[axis] != g_infinity) {
+        return false;
+      }
+    }
+    return min_range <= 0.0F && max_range == g_infinity &&
+           azimuth_min == azimuth_max && min_intensity == -g_infinity;
+  }
+};
+
+/**
+ * @brief Copy the points of `input` inside `region` into `output`, in order,
+ * with their time offsets. `output` gets the header and device id of
+ * `input`; it must not be `input`. Points are tested four at a time with SSE
+ * or NEON, with a scalar tail.
+ */
+void crop(const Scan3DI &input, const CropRegion &region, Scan3DI &output);
+
+} // namespace msensor
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+
+#include "msensor/interface/IImu.hh"
+#include "msensor/interface/ILidar.hh"
+
+namespace msensor {
+
+/**
+ * @brief Removes the motion distortion of a scan using gyroscope samples.
+ *
+ * The gyro rates are integrated across the scan's time span and every point
+ * is rotated into the sensor frame at the time of the scan's last point.
+ * Only rotation is compensated: translation would need a velocity estimate,
+ * which the IMU alone does not provide.
+ *
+ * Scans must carry `Scan3DI::time_offsets_us`. Not thread-safe.
+ */
+class ImuDeskewer {
+public:
+  /// Keep at most `imu_capacity` of the most recent IMU samples.
+  explicit ImuDeskewer(size_t imu_capacity = 1000);
+
+  /// Add an IMU sample. Samples are expected in timestamp order.
+  void addImu(const IMUData &imu);
+
+  /// Whether the buffered IMU samples reach the end of `scan`.
+  bool covers(const Scan3DI &scan) const;
+
+  /**
+   * @brief Deskew `scan` into `out`.
+   *
+   * `out` gets the points in the frame at the scan's last point, timestamped
+   * at that instant, without per-point times.
+   * @return false if `scan` has no per-point times or is not covered by IMU
+   * samples yet.
+   */
+  bool deskew(const Scan3DI &scan, Scan3DI &out) const;
+
+private:
+  size_t imu_capacity_;
+  std::deque<IMUData> imu_;
+};
+
+} // namespace msensor
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <barrier>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "msensor/interface/ILidar.hh"
+
+namespace msensor {
+
+/// Clouds at least this large are filtered on several threads.
+constexpr size_t g_voxelParallelThreshold = 50000;
+
+/**
+ * @brief Voxel grid downsampler over a hash of quantized voxel keys.
+ *
+ * A drop-in for `pcl::VoxelGrid<Point3I>` on the streaming path: no sort of
+ * the whole cloud, no 32-bit voxel index over the cloud's bounding box, and
+ * every buffer is kept across calls, so a filter reused per stream does not
+ * allocate once warmed up.
+ *
+ * `Centroid` outputs, per occupied voxel, the mean of its points' x, y, z
+ * and intensity accumulated in input order, as the PCL grid does. Voxel
+ * order differs: by first point, per partition, rather than grid order.
+ * `FirstPoint` keeps the first point of each voxel unchanged, which skips
+ * the accumulation.
+ *
+ * Non-finite points and points more than 2^20 leaves from the origin on an
+ * axis are dropped. Not thread-safe; clouds of `g_voxelParallelThreshold`
+ * points or more are split over `threads` threads internally: the calling
+ * thread and workers started once by the constructor.
+ */
+class VoxelFilter {
+public:
+  enum class Mode { Centroid, FirstPoint };
+
+  /// @param threads workers for large clouds; 0 = hardware concurrency.
+  explicit VoxelFilter(Mode mode = Mode::Centroid, size_t threads = 0);
+  ~VoxelFilter();
+  VoxelFilter(const VoxelFilter &) = delete;
+  VoxelFilter &operator=(const VoxelFilter &) = delete;
+
+  /**
+   * @brief Downsample `input` into `output` with cubic voxels of `leaf`
+   * metres. `output` keeps the PCL header of `input`; a non-positive `leaf`
+   * copies the cloud unchanged.
+   */
+  void filter(const PointCloud3I &input, float leaf, PointCloud3I &output);
+
+  /// Points dropped by the last `filter()` call.
+  size_t dropped() const { return dropped_; }
+
+private:
+  /// Sums of one voxel, or its first point in `FirstPoint` mode.
+  struct Cell {
+    float x;
+    float y;
+    float z;
+    float intensity;
+    uint32_t count;
+  };
+
+  /// Open-addressing table of the voxels whose keys fall in one partition.
+  struct Partition {
+    std::vector<uint64_t> slot_keys;
+    std::vector<uint32_t> slot_cells;
+    std::vector<Cell> cells;
+
+    void reset(size_t expected_voxels);
+    Cell &find(uint64_t key, uint64_t hash, bool &inserted);
+  };
+
+  /// Aggregate `point`, of voxel `key`, into `partition`.
+  void add(Partition &partition, const Point3I &point, uint64_t key,
+           uint64_t hash) const;
+  /// Key the points of chunk `chunk` and sort their indices by partition.
+  void split(const PointCloud3I &input, float inverse_leaf, size_t chunk);
+  /// Aggregate the points of partition `index`, chunk by chunk.
+  void aggregate(const PointCloud3I &input, size_t index);
+
+  /// Run `fn(0)` ... `fn(threads_ - 1)`, `fn(0)` on the calling thread.
+  template <typename Fn> void parallelFor(Fn &fn);
+  /// Loop of worker `index`: runs each job posted by `parallelFor()`.
+  void work(size_t index);
+
+  const Mode mode_;
+  const size_t threads_;
+  std::vector<uint64_t> keys_; ///< Voxel key per input point.
+  /// Input indices per chunk then partition, in input order.
+  std::vector<std::vector<std::vector<uint32_t>>> buckets_;
+  std::vector<size_t> chunk_dropped_;
+  std::vector<Partition> partitions_;
+  size_t dropped_ = 0;
+
+  // Job shared with the workers, between the two barriers.
+  void (*job_)(void *context, size_t index) = nullptr;
+  void *job_context_ = nullptr;
+  bool stopping_ = false;
+  std::barrier<> start_;
+  std::barrier<> done_;
+  std::vector<std::jthread> workers_; ///< Declared last: joined first.
+};
+
+} // namespace msensor
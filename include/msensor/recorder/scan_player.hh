@@ -13,6 +13,9 @@ class ScanPlayer {
 public:
   /// Open a recording file for playback.
   ScanPlayer(const std::filesystem::path &file);
+  ~ScanPlayer();
+  ScanPlayer(const ScanPlayer &) = delete;
+  ScanPlayer &operator=(const ScanPlayer &) = delete;
 
   /// Advance to the next entry; returns false on end-of-file.
   bool next();
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <array>
+#include <google/protobuf/arena.h>
+
 #include "msensor/interface/IFile.hh"
 #include "msensor/interface/IImu.hh"
 #include "msensor/interface/ILidar.hh"
@@ -53,6 +56,11 @@ private:
   std::shared_ptr<IFile> record_file_;
   bool has_started_;
   std::string filename_;
+
+  // Serialization buffers reused across records; guarded by the record lock.
+  std::array<char, 1024> arena_block_;
+  google::protobuf::Arena arena_;
+  std::string scratch_;
 };
 
 } // namespace msensor
\ No newline at end of file
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <chrono>
+#include <optional>
+#include <string>
+
+#include "msensor/concurrency/object_pool.hh"
+#include "msensor/interface/ICamera.hh"
+#include "msensor/interface/IImu.hh"
+#include "msensor/interface/ILidar.hh"
+#include "msensor/shm/shm_ring.hh"
+
+namespace msensor {
+
+/**
+ * @brief Reads the segments of a `ShmPublisher` on the same host, through
+ * the same interfaces as the drivers and `SensorsRemoteClient`.
+ *
+ * Every item is copied once out of shared memory, with no parsing, and
+ * readers sleep on a futex until the publisher writes. Segments are opened
+ * by `init()`, or on first use if they did not exist yet, and reopened when
+ * the publisher restarts. Each stream must be read from a single thread.
+ */
+class ShmClient : public ILidar, public IImu, public ICamera {
+public:
+  /// Items the publisher overwrote before this client read them.
+  struct Skipped {
+    uint64_t scans = 0;
+    uint64_t imu = 0;
+    uint64_t frames = 0;
+  };
+
+  /// Read the segments named after `prefix`, see `ShmPublisher::Options`.
+  explicit ShmClient(const std::string &prefix = "/msensor");
+
+  /// Open the segments that already exist.
+  void init() override;
+  void startSampling() override {}
+  void stopSampling() override {}
+
+  /// Next scan, or null if none was published since the last one.
+  std::shared_ptr<Scan3DI> getScan() override;
+  bool waitForScan(std::chrono::milliseconds timeout) override;
+  /// Next IMU sample, or empty if none was published since the last one.
+  std::optional<IMUData> getImuData() override;
+  bool waitForImuData(std::chrono::milliseconds timeout) override;
+
+  /// Wait for the next camera frame and copy it into `frame`.
+  bool read(CameraFrame &frame) override;
+  /// True while the camera segment is open: after `init()` or a `read()`
+  /// found it.
+  bool isOpened() const override { return camera_.ring.has_value(); }
+  /// Unmap every segment; they are reopened on the next read.
+  void release() override;
+
+  Skipped skipped() const {
+    return {lidar_.cursor.skipped, imu_.cursor.skipped,
+            camera_.cursor.skipped};
+  }
+
+private:
+  struct Stream {
+    std::string name;
+    std::optional<ShmRing> ring;
+    ShmRing::Cursor cursor;
+    std::chrono::steady_clock::time_point retry_at;
+  };
+
+  /// Open the segment of `stream` if needed. False if it does not exist.
+  static bool connect(Stream &stream);
+  /// Wait for an item of `stream`, reconnecting if the publisher went away.
+  static bool waitFor(Stream &stream, std::chrono::nanoseconds timeout);
+
+  Stream lidar_;
+  Stream imu_;
+  Stream camera_;
+  ObjectPool<Scan3DI> scan_pool_;
+};
+
+} // namespace msensor
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "msensor/concurrency/broadcast_hub.hh"
+#include "msensor/interface/ICamera.hh"
+#include "msensor/interface/IImu.hh"
+#include "msensor/interface/ILidar.hh"
+#include "msensor/shm/shm_ring.hh"
+
+namespace msensor {
+
+/**
+ * @brief Copies the scans, IMU samples and camera frames of in-process hubs
+ * into shared-memory rings, for `ShmClient`s on the same host.
+ *
+ * Items are written from the hub listeners, on the producer threads, so a
+ * reader is woken as soon as an item is published. Items larger than a slot
+ * are dropped and counted in `oversized()`.
+ */
+class ShmPublisher {
+public:
+  using ScanHub = BroadcastHub<std::shared_ptr<const Scan3DI>>;
+  using ImuHub = BroadcastHub<IMUData>;
+  using FrameHub = BroadcastHub<std::shared_ptr<const CameraFrame>>;
+
+  struct Options {
+    /// Segments are named <prefix>_lidar, <prefix>_imu and <prefix>_camera.
+    std::string prefix = "/msensor";
+    size_t scan_slots = 8;
+    size_t max_scan_points = 100000;
+    size_t imu_slots = 1024;
+    size_t frame_slots = 4;
+    size_t max_frame_bytes = 1920 * 1080 * 3;
+  };
+
+  /**
+   * @brief Create a segment for every non-null hub and start copying.
+   * @throws std::runtime_error if a segment cannot be created.
+   */
+  ShmPublisher(const Options &options, std::shared_ptr<ScanHub> scans,
+               std::shared_ptr<ImuHub> imu, std::shared_ptr<FrameHub> frames);
+  ShmPublisher(const ShmPublisher &) = delete;
+  ShmPublisher &operator=(const ShmPublisher &) = delete;
+  /// Detach from the hubs, then close and unlink the segments.
+  ~ShmPublisher();
+
+  /// Items dropped because they did not fit in a slot.
+  uint64_t oversized() const {
+    return oversized_.load(std::memory_order_relaxed);
+  }
+
+private:
+  template <typename Hub, typename Write>
+  void attach(const std::shared_ptr<Hub> &hub, Write write);
+
+  void write(const Scan3DI &scan);
+  void write(const IMUData &sample);
+  void write(const CameraFrame &frame);
+
+  std::optional<ShmRing> lidar_ring_;
+  std::optional<ShmRing> imu_ring_;
+  std::optional<ShmRing> camera_ring_;
+  std::vector<std::function<void()>> detach_;
+  std::atomic<uint64_t> oversized_{0};
+};
+
+} // namespace msensor
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "msensor/interface/Header.hh"
+#include "msensor/interface/IImu.hh"
+#include "msensor/interface/ILidar.hh"
+
+namespace msensor {
+
+/// Payload offset of the points of a scan, and of the pixels of a frame.
+constexpr size_t g_shmDataOffset = 64;
+
+/**
+ * @brief Slot layout of a scan: this record, then `points` PCL points at
+ * `g_shmDataOffset`, then `time_offsets` microsecond offsets.
+ */
+struct ShmScanRecord {
+  Header header;
+  uint32_t device_id;
+  uint32_t points;
+  uint32_t time_offsets; ///< 0 or `points`.
+};
+static_assert(sizeof(ShmScanRecord) <= g_shmDataOffset);
+static_assert(std::is_trivially_copyable_v<Point3I>);
+
+/// Payload bytes of a scan of `points` points.
+constexpr size_t shmScanBytes(size_t points, bool time_offsets) {
+  return g_shmDataOffset +
+         points * (sizeof(Point3I) + (time_offsets ? sizeof(uint32_t) : 0));
+}
+
+/// Payload bytes of `scan`, for `writeScanRecord()`.
+size_t shmScanBytes(const Scan3DI &scan);
+
+/// Write `scan` to `out`, which holds at least `shmScanBytes(scan)` bytes.
+void writeScanRecord(const Scan3DI &scan, std::byte *out);
+
+/// Read a scan from the `size` bytes at `data`. False, leaving `scan`
+/// partially filled, if they do not hold a whole record.
+bool readScanRecord(const std::byte *data, size_t size, Scan3DI &scan);
+
+/**
+ * @brief Slot layout of a camera frame: this record, then the rows of a
+ * `cv::Mat` of `type`, unpadded, at `g_shmDataOffset`.
+ */
+struct ShmFrameRecord {
+  Header header;
+  int32_t rows;
+  int32_t cols;
+  int32_t type;
+};
+static_assert(sizeof(ShmFrameRecord) <= g_shmDataOffset);
+
+/// IMU samples are stored as they are.
+static_assert(std::is_trivially_copyable_v<IMUData>);
+
+} // namespace msensor
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace msensor {
+
+/**
+ * @brief Single-writer, multi-reader ring of fixed-size slots in a POSIX
+ * shared-memory segment, for same-host transport without serialization.
+ *
+ * The writer fills the payload of the next slot in place and publishes it;
+ * readers in any process copy it out while it is still in the ring. Slots
+ * are guarded by a sequence lock instead of reference counts, so the writer
+ * never waits for, or depends on, a reader: a reader that falls more than a
+ * ring behind, or whose slot is overwritten while it copies, skips the item.
+ * Readers sleep on a futex in the segment and are only woken, with one
+ * syscall per publish, while at least one of them is waiting.
+ *
+ * The segment is created by the writer and unlinked when it is destroyed.
+ * Readers notice it through `closed()`, or `replaced()` if the writer died,
+ * and reopen it by name.
+ */
+class ShmRing {
+public:
+  /// Per-reader position, as `BroadcastHub::Cursor`.
+  struct Cursor {
+    uint64_t next = 0;    ///< Index of the next item to be read.
+    uint64_t skipped = 0; ///< Items overwritten before they could be read.
+  };
+
+  /**
+   * @brief Create the segment `name` (e.g. "/msensor_lidar") with `slots`
+   * slots of `slot_bytes` payload bytes, replacing any stale one.
+   * @throws std::runtime_error if it cannot be created or mapped.
+   */
+  static ShmRing create(const std::string &name, size_t slots,
+                        size_t slot_bytes);
+
+  /**
+   * @brief Map the existing segment `name` as a reader.
+   * @throws std::runtime_error if it does not exist or is not a ring.
+   */
+  static ShmRing open(const std::string &name);
+
+  ShmRing(ShmRing &&other) noexcept;
+  ShmRing &operator=(ShmRing &&other) noexcept;
+  ShmRing(const ShmRing &) = delete;
+  ShmRing &operator=(const ShmRing &) = delete;
+  ~ShmRing();
+
+  /// Payload capacity of a slot, in bytes.
+  size_t slotBytes() const { return slot_bytes_; }
+
+  /// Items published so far.
+  uint64_t published() const {
+    return control_->head.load(std::memory_order_acquire);
+  }
+
+  /// True once the writer has been destroyed.
+  bool closed() const {
+    return control_->closed.load(std::memory_order_acquire) != 0;
+  }
+
+  /// True if the name now refers to another segment, e.g. one created by a
+  /// restarted writer after a crash, or to none. Costs a few syscalls.
+  bool replaced() const;
+
+  /// Writer: payload of the next slot, marked as being written. Fill at most
+  /// `slotBytes()` bytes, then call `publish()`.
+  std::byte *beginWrite();
+
+  /// Writer: publish the slot returned by `beginWrite()` with `size` payload
+  /// bytes and wake waiting readers.
+  void publish(size_t size);
+
+  /// Reader: cursor positioned at the next item to be published.
+  Cursor subscribe() const { return Cursor{published(), 0}; }
+
+  /**
+   * @brief Reader: pass the next item for `cursor` to
+   * `copy(const std::byte *payload, size_t size)` and advance the cursor.
+   *
+   * `copy` must only copy the payload out: the writer may overwrite it
+   * meanwhile, in which case the copy is discarded and the item counted as
+   * skipped. Returns false if the reader is up to date.
+   */
+  template <typename Copy> bool read(Cursor &cursor, Copy &&copy) const {
+    while (true) {
+      const uint64_t head = published();
+      if (cursor.next >= head) {
+        return false;
+      }
+      const uint64_t oldest =
+          head > slots_ ? head - slots_ : uint64_t{0};
+      if (cursor.next < oldest) {
+        cursor.skipped += oldest - cursor.next;
+        cursor.next = oldest;
+      }
+
+      const Slot &slot = slotAt(cursor.next);
+      const uint64_t complete = 2 * cursor.next + 2;
+      if (slot.sequence.load(std::memory_order_acquire) == complete) {
+        const uint64_t size = slot.size;
+        if (size <= slot_bytes_) {
+          copy(payload(slot), static_cast<size_t>(size));
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) == complete &&
+            size <= slot_bytes_) {
+          ++cursor.next;
+          return true;
+        }
+      }
+      // Overwritten before or while being copied.
+      ++cursor.skipped;
+      ++cursor.next;
+    }
+  }
+
+  /// Reader: block until an item past `cursor` is published, the writer
+  /// closes, or `timeout` expires. Returns true if an item is ready.
+  bool waitFor(const Cursor &cursor, std::chrono::nanoseconds timeout) const;
+
+private:
+  // Shared layout. Slot `index % slots` holds item `index`; its sequence is
+  // 2 * index + 1 while being written and 2 * index + 2 once published.
+  struct alignas(64) Control {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t slots;
+    uint64_t slot_bytes;
+    uint64_t stride; ///< Bytes from one slot to the next.
+    std::atomic<uint64_t> head;
+    std::atomic<uint32_t> notify; ///< Futex word, bumped on every publish.
+    std::atomic<uint32_t> waiters;
+    std::atomic<uint32_t> closed;
+  };
+  struct alignas(64) Slot {
+    std::atomic<uint64_t> sequence;
+    uint64_t size;
+  };
+  static_assert(std::atomic<uint32_t>::is_always_lock_free &&
+                    std::atomic<uint64_t>::is_always_lock_free,
+                "shared atomics must be lock-free");
+
+  ShmRing(std::string name, void *memory, size_t bytes, uint64_t inode,
+          bool writer);
+  void release();
+
+  Slot &slotAt(uint64_t index) const {
+    auto *base = reinterpret_cast<std::byte *>(control_) + sizeof(Control);
+    return *reinterpret_cast<Slot *>(base + (index % slots_) * stride_);
+  }
+  static std::byte *payload(const Slot &slot) {
+    return const_cast<std::byte *>(
+        reinterpret_cast<const std::byte *>(&slot) + sizeof(Slot));
+  }
+
+  std::string name_;
+  Control *control_ = nullptr;
+  size_t bytes_ = 0;
+  // Geometry, validated once when mapped: the shared copy is not trusted.
+  uint64_t slots_ = 0;
+  uint64_t slot_bytes_ = 0;
+  uint64_t stride_ = 0;
+  uint64_t inode_ = 0; ///< Identifies the segment behind `name_`.
+  bool writer_ = false;
+};
+
+} // namespace msensor
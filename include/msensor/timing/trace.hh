@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+
+#include "msensor/timing/timing.hh"
+
+/**
+ * Pipeline tracing stamps `msensor::Trace` checkpoints into sample headers.
+ *
+ * It is compiled in with `-DWITH_TRACING=ON` and then switched at runtime
+ * with `setTracingEnabled()`. Without the option `tracingEnabled()` is a
+ * constant false, so every checkpoint compiles away.
+ */
+namespace timing {
+
+#ifdef MSENSOR_WITH_TRACING
+/// True while checkpoints are being recorded.
+bool tracingEnabled();
+/// Start or stop recording checkpoints.
+void setTracingEnabled(bool enabled);
+#else
+constexpr bool tracingEnabled() { return false; }
+inline void setTracingEnabled(bool /*enabled*/) {}
+#endif
+
+/// Epoch time in nanoseconds for a checkpoint, or 0 when tracing is off.
+inline uint64_t traceNowNs() {
+  return tracingEnabled() ? getEpochTimeNs() : 0;
+}
+} // namespace timing
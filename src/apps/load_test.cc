@@ -0,0 +1,485 @@
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <getopt.h>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include <grpcpp/grpcpp.h>
+
+#include "camera.grpc.pb.h"
+#include "imu.grpc.pb.h"
+#include "lidar.grpc.pb.h"
+#include "msensor/adc/sim_adc.hh"
+#include "msensor/camera/sim_camera.hh"
+#include "msensor/imu/sim_imu.hh"
+#include "msensor/lidar/sim_lidar.hh"
+#include "msensor/timing/timing.hh"
+#include "msensor_server.hh"
+
+// Sweeps concurrent clients and payload sizes over the streaming services of
+// a server fed by simulated devices, and reports where each service stops
+// keeping up. Latency is measured against the sample header timestamps,
+// which the sim devices take from the monotonic clock, so the server must
+// run on the same host.
+
+namespace {
+
+constexpr auto g_connectTimeout = std::chrono::seconds(10);
+constexpr auto g_warmUp = std::chrono::seconds(1);
+constexpr float g_subsampleVoxelSize = 0.1F;
+/// p99 latency growth over the single-client step that counts as degraded.
+constexpr double g_maxLatencyGrowth = 2.0;
+
+enum class Service { Lidar, SubSampled, Imu, Camera };
+constexpr Service g_services[] = {Service::Lidar, Service::SubSampled,
+                                  Service::Imu, Service::Camera};
+
+const char *serviceName(Service service) {
+  switch (service) {
+  case Service::Lidar:
+    return "lidar";
+  case Service::SubSampled:
+    return "subsampled";
+  case Service::Imu:
+    return "imu";
+  case Service::Camera:
+    return "camera";
+  }
+  return "unknown";
+}
+
+/// Sim device sizes of one sweep step.
+struct Payload {
+  size_t points = 2000;
+  int width = 640;
+  int height = 480;
+};
+
+struct Options {
+  std::vector<int> clients{1, 2, 4, 8, 16, 32};
+  std::vector<Payload> payloads{
+      {2000, 640, 480}, {9600, 1536, 864}, {100000, 1536, 864}};
+  std::chrono::seconds duration{5};
+  /// sim_publisher executable; empty runs the server in process.
+  std::string publisher;
+  std::string target = "localhost:50051";
+  /// Per-client rate loss, relative to the first step, counted as degraded.
+  double tolerance = 0.1;
+};
+
+/// What one client saw during a step.
+struct ClientResult {
+  uint64_t messages = 0;
+  uint64_t bytes = 0;
+  std::vector<uint32_t> latency_us;
+  uint64_t cpu_ns = 0; ///< CPU time of the client thread.
+};
+
+/// Aggregate of one (service, payload, clients) step.
+struct StepResult {
+  int clients = 0;
+  double messages_per_s = 0;
+  double megabytes_per_s = 0;
+  double min_client_rate = 0;
+  double mean_client_rate = 0;
+  double p50_ms = 0;
+  double p99_ms = 0;
+  double max_ms = 0;
+  double server_cpu = 0; ///< Percent of one core.
+};
+
+uint64_t clockNs(clockid_t clock) {
+  timespec ts{};
+  clock_gettime(clock, &ts);
+  return uint64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+/// Parse "1,2,4" into integers.
+std::vector<int> parseList(const std::string &text) {
+  std::vector<int> values;
+  std::stringstream stream(text);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    values.push_back(std::stoi(item));
+  }
+  return values;
+}
+
+/// Parse "2000:640x480,9600:1536x864" into payloads.
+std::vector<Payload> parsePayloads(const std::string &text) {
+  std::vector<Payload> payloads;
+  std::stringstream stream(text);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    Payload payload;
+    if (std::sscanf(item.c_str(), "%zu:%dx%d", &payload.points,
+                    &payload.width, &payload.height) != 3) {
+      throw std::runtime_error("Invalid payload '" + item +
+                               "', expected POINTS:WIDTHxHEIGHT.");
+    }
+    payloads.push_back(payload);
+  }
+  return payloads;
+}
+
+/// Record a received message stamped with `timestamp_ns`.
+void account(ClientResult &result, size_t bytes, uint64_t timestamp_ns) {
+  ++result.messages;
+  result.bytes += bytes;
+  const uint64_t now = timing::getNowNs();
+  if (timestamp_ns <= now) {
+    result.latency_us.push_back(
+        static_cast<uint32_t>((now - timestamp_ns) / 1000));
+  }
+}
+
+/// Read a server stream until the context deadline.
+template <typename Reader, typename Message>
+void drain(Reader &reader, Message &message, ClientResult &result) {
+  while (reader.Read(&message)) {
+    account(result, message.ByteSizeLong(), message.header().timestamp());
+  }
+}
+
+/// One client streaming `service` until `deadline`.
+void runClient(const std::shared_ptr<grpc::Channel> &channel, Service service,
+               std::chrono::system_clock::time_point deadline,
+               ClientResult &result) {
+  const uint64_t cpu_start = clockNs(CLOCK_THREAD_CPUTIME_ID);
+  grpc::ClientContext context;
+  context.set_deadline(deadline);
+
+  switch (service) {
+  case Service::Lidar: {
+    auto stub = sensors::LidarService::NewStub(channel);
+    sensors::PointCloud3 message;
+    auto reader = stub->getLidarScan(&context, {});
+    drain(*reader, message, result);
+    break;
+  }
+  case Service::SubSampled: {
+    auto stub = sensors::LidarService::NewStub(channel);
+    sensors::PointCloud3 message;
+    auto stream = stub->getSubSampledLidarScan(&context);
+    sensors::SubSampledLidarStreamRequest request;
+    request.set_voxel_size(g_subsampleVoxelSize);
+    stream->Write(request);
+    drain(*stream, message, result);
+    break;
+  }
+  case Service::Imu: {
+    auto stub = sensors::ImuService::NewStub(channel);
+    sensors::IMUData message;
+    auto reader = stub->getImuData(&context, {});
+    drain(*reader, message, result);
+    break;
+  }
+  case Service::Camera: {
+    auto stub = sensors::CameraService::NewStub(channel);
+    sensors::CameraStreamReply message;
+    auto reader = stub->getCameraFrame(&context, {});
+    drain(*reader, message, result);
+    break;
+  }
+  }
+  result.cpu_ns = clockNs(CLOCK_THREAD_CPUTIME_ID) - cpu_start;
+}
+
+/// CPU time of a child process, from /proc.
+uint64_t processCpuNs(pid_t pid) {
+  std::ifstream stat("/proc/" + std::to_string(pid) + "/stat");
+  std::string line;
+  std::getline(stat, line);
+  // Fields after the parenthesised command name; utime and stime are the
+  // 14th and 15th fields overall.
+  std::stringstream fields(line.substr(line.rfind(')') + 2));
+  std::string field;
+  uint64_t utime = 0;
+  uint64_t stime = 0;
+  for (int i = 3; i <= 15 && fields >> field; ++i) {
+    if (i == 14) {
+      utime = std::stoull(field);
+    } else if (i == 15) {
+      stime = std::stoull(field);
+    }
+  }
+  return (utime + stime) * (1000000000 / sysconf(_SC_CLK_TCK));
+}
+
+/// The server under test: a sim_publisher child or an in-process server.
+class Publisher {
+public:
+  Publisher(const Options &options, const Payload &payload) {
+    if (options.publisher.empty()) {
+      server_ = std::make_unique<SensorsServer>(
+          std::make_shared<msensor::SimAdc>(),
+          std::make_shared<msensor::SimCamera>(payload.width, payload.height),
+          std::make_shared<msensor::SimImu>(),
+          std::make_shared<msensor::SimLidar>(false, payload.points));
+      server_->start();
+      return;
+    }
+
+    const std::string points = std::to_string(payload.points);
+    const std::string frame =
+        std::to_string(payload.width) + "x" + std::to_string(payload.height);
+    pid_ = fork();
+    if (pid_ == 0) {
+      execl(options.publisher.c_str(), options.publisher.c_str(),
+            points.c_str(), frame.c_str(), nullptr);
+      std::perror("execl");
+      _exit(1);
+    }
+    if (pid_ < 0) {
+      throw std::runtime_error("Failed to start " + options.publisher);
+    }
+  }
+
+  ~Publisher() {
+    if (server_) {
+      server_->stop();
+    }
+    if (pid_ > 0) {
+      kill(pid_, SIGTERM);
+      waitpid(pid_, nullptr, 0);
+    }
+  }
+
+  /// CPU time used by the server so far. In process, that is the process
+  /// time minus the client threads' own time, supplied by the caller, so
+  /// gRPC's shared polling threads are charged to the server.
+  uint64_t cpuNs(uint64_t client_cpu_ns) const {
+    if (pid_ > 0) {
+      return processCpuNs(pid_);
+    }
+    return clockNs(CLOCK_PROCESS_CPUTIME_ID) - client_cpu_ns;
+  }
+
+private:
+  std::unique_ptr<SensorsServer> server_;
+  pid_t pid_ = -1;
+};
+
+StepResult runStep(const Options &options, const Publisher &publisher,
+                   Service service, int clients) {
+  std::vector<ClientResult> results(clients);
+  std::vector<std::thread> threads;
+  // A channel per client, so they do not share one HTTP/2 connection.
+  std::vector<std::shared_ptr<grpc::Channel>> channels;
+  for (int i = 0; i < clients; ++i) {
+    grpc::ChannelArguments arguments;
+    arguments.SetInt(GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL, 1);
+    arguments.SetMaxReceiveMessageSize(-1);
+    channels.push_back(grpc::CreateCustomChannel(
+        options.target, grpc::InsecureChannelCredentials(), arguments));
+  }
+
+  const uint64_t cpu_start = publisher.cpuNs(0);
+  const auto start = std::chrono::steady_clock::now();
+  const auto deadline = std::chrono::system_clock::now() + options.duration;
+  for (int i = 0; i < clients; ++i) {
+    threads.emplace_back(runClient, channels[i], service, deadline,
+                         std::ref(results[i]));
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  const double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+          .count();
+
+  StepResult step;
+  step.clients = clients;
+  uint64_t messages = 0;
+  uint64_t bytes = 0;
+  uint64_t client_cpu_ns = 0;
+  std::vector<uint32_t> latencies;
+  step.min_client_rate = std::numeric_limits<double>::max();
+  for (const auto &result : results) {
+    messages += result.messages;
+    bytes += result.bytes;
+    client_cpu_ns += result.cpu_ns;
+    latencies.insert(latencies.end(), result.latency_us.begin(),
+                     result.latency_us.end());
+    step.min_client_rate =
+        std::min(step.min_client_rate, result.messages / seconds);
+  }
+  step.messages_per_s = messages / seconds;
+  step.megabytes_per_s = bytes / seconds / 1e6;
+  step.mean_client_rate = step.messages_per_s / clients;
+  step.server_cpu =
+      100.0 * (publisher.cpuNs(client_cpu_ns) - cpu_start) / 1e9 / seconds;
+
+  if (!latencies.empty()) {
+    std::sort(latencies.begin(), latencies.end());
+    const auto percentile = [&](double p) {
+      return latencies[static_cast<size_t>(p * (latencies.size() - 1))] /
+             1000.0;
+    };
+    step.p50_ms = percentile(0.5);
+    step.p99_ms = percentile(0.99);
+    step.max_ms = latencies.back() / 1000.0;
+  }
+  return step;
+}
+
+/// First step that lost more than `tolerance` of the first step's per-client
+/// rate, or whose p99 latency grew more than `g_maxLatencyGrowth` times.
+const StepResult *firstDegraded(const std::vector<StepResult> &steps,
+                                double tolerance) {
+  if (steps.empty()) {
+    return nullptr;
+  }
+  const StepResult &baseline = steps.front();
+  for (const auto &step : steps) {
+    const bool slower =
+        step.mean_client_rate < (1.0 - tolerance) * baseline.mean_client_rate;
+    const bool later = baseline.p99_ms > 0 &&
+                       step.p99_ms > g_maxLatencyGrowth * baseline.p99_ms;
+    if (slower || later) {
+      return &step;
+    }
+  }
+  return nullptr;
+}
+
+void printHeader() {
+  std::cout << std::left << std::setw(11) << "service" << std::right
+            << std::setw(8) << "clients" << std::setw(10) << "msg/s"
+            << std::setw(9) << "MB/s" << std::setw(11) << "min rate"
+            << std::setw(11) << "mean rate" << std::setw(9) << "p50 ms"
+            << std::setw(9) << "p99 ms" << std::setw(9) << "max ms"
+            << std::setw(10) << "srv CPU%" << std::endl;
+}
+
+void printStep(Service service, const StepResult &step) {
+  std::cout << std::left << std::setw(11) << serviceName(service)
+            << std::right << std::fixed << std::setprecision(1)
+            << std::setw(8) << step.clients << std::setw(10)
+            << step.messages_per_s << std::setw(9) << step.megabytes_per_s
+            << std::setw(11) << step.min_client_rate << std::setw(11)
+            << step.mean_client_rate << std::setw(9) << step.p50_ms
+            << std::setw(9) << step.p99_ms << std::setw(9) << step.max_ms
+            << std::setw(10) << step.server_cpu << std::endl;
+}
+
+void printUsage() {
+  std::cout
+      << "Usage: load_test [options]\n"
+         "  --clients N,N,...      concurrent clients per step "
+         "(default 1,2,4,8,16,32)\n"
+         "  --payloads P:WxH,...   lidar points and camera size per sweep\n"
+         "                         (default 2000:640x480,9600:1536x864,"
+         "100000:1536x864)\n"
+         "  --duration S           seconds per step (default 5)\n"
+         "  --publisher PATH       run PATH (sim_publisher) instead of an\n"
+         "                         in-process server\n"
+         "  --target HOST:PORT     server address (default localhost:50051)\n"
+         "  --tolerance F          rate loss counted as degraded "
+         "(default 0.1)"
+      << std::endl;
+}
+
+Options parseOptions(int argc, char **argv) {
+  static const option long_options[] = {
+      {"clients", required_argument, nullptr, 'c'},
+      {"payloads", required_argument, nullptr, 'p'},
+      {"duration", required_argument, nullptr, 'd'},
+      {"publisher", required_argument, nullptr, 'e'},
+      {"target", required_argument, nullptr, 't'},
+      {"tolerance", required_argument, nullptr, 'o'},
+      {"help", no_argument, nullptr, 'h'},
+      {nullptr, 0, nullptr, 0}};
+
+  Options options;
+  int opt = 0;
+  while ((opt = getopt_long(argc, argv, "c:p:d:e:t:o:h", long_options,
+                            nullptr)) != -1) {
+    switch (opt) {
+    case 'c':
+      options.clients = parseList(optarg);
+      break;
+    case 'p':
+      options.payloads = parsePayloads(optarg);
+      break;
+    case 'd':
+      options.duration = std::chrono::seconds(std::stoi(optarg));
+      break;
+    case 'e':
+      options.publisher = optarg;
+      break;
+    case 't':
+      options.target = optarg;
+      break;
+    case 'o':
+      options.tolerance = std::stod(optarg);
+      break;
+    default:
+      printUsage();
+      exit(opt == 'h' ? 0 : -1);
+    }
+  }
+  std::sort(options.clients.begin(), options.clients.end());
+  return options;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  const Options options = parseOptions(argc, argv);
+
+  std::vector<std::string> summary;
+  for (const auto &payload : options.payloads) {
+    std::cout << "\n== " << payload.points << " points/scan, camera "
+              << payload.width << "x" << payload.height << " ==" << std::endl;
+    Publisher publisher(options, payload);
+    auto channel = grpc::CreateChannel(options.target,
+                                       grpc::InsecureChannelCredentials());
+    if (!channel->WaitForConnected(std::chrono::system_clock::now() +
+                                   g_connectTimeout)) {
+      std::cerr << "Server at " << options.target << " is not reachable."
+                << std::endl;
+      return -1;
+    }
+    std::this_thread::sleep_for(g_warmUp);
+
+    printHeader();
+    for (const Service service : g_services) {
+      std::vector<StepResult> steps;
+      for (const int clients : options.clients) {
+        steps.push_back(runStep(options, publisher, service, clients));
+        printStep(service, steps.back());
+      }
+
+      std::ostringstream line;
+      line << std::left << std::setw(11) << serviceName(service)
+           << std::setw(9) << payload.points << std::setw(10)
+           << (std::to_string(payload.width) + "x" +
+               std::to_string(payload.height));
+      if (const auto *degraded = firstDegraded(steps, options.tolerance)) {
+        line << "degrades at " << degraded->clients << " clients";
+      } else {
+        line << "holds up to " << options.clients.back() << " clients";
+      }
+      summary.push_back(line.str());
+    }
+  }
+
+  std::cout << "\n== Summary ==\n"
+            << std::left << std::setw(11) << "service" << std::setw(9)
+            << "points" << std::setw(10) << "camera" << std::endl;
+  for (const auto &line : summary) {
+    std::cout << line << std::endl;
+  }
+}
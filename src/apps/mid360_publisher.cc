@@ -6,7 +6,7 @@
 #include "msensor_server.hh"
 
 void printUsage() {
-  std::cout << "Usage: app [config] [accusamples] [mode: 0, 1,2,3]"
+  std::cout << "Usage: app [config] [accusamples] [mode: 0, 1,2,3] [worker cpu]"
             << std::endl;
 }
 int main(int argc, char **argv) {
@@ -17,7 +17,9 @@ int main(int argc, char **argv) {
 
   const int accumulate = atoi(argv[2]);
   std::cout << "Accu samples: " << accumulate << std::endl;
-  auto lidar = std::make_shared<msensor::Mid360>(argv[1], accumulate);
+  const int worker_cpu = argc > 4 ? atoi(argv[4]) : -1;
+  auto lidar =
+      std::make_shared<msensor::Mid360>(argv[1], accumulate, worker_cpu);
   lidar->init();
 
   const auto mode = atoi(argv[3]);
@@ -41,8 +43,17 @@ int main(int argc, char **argv) {
   server.start();
 
   while (true) {
-
-    /// \todo sleep just enough
-    std::this_thread::sleep_for(std::chrono::microseconds(100));
+    std::this_thread::sleep_for(std::chrono::seconds(5));
+    const auto stats = lidar->packetStats();
+    std::cout << "Packets: " << stats.received << " dropped: " << stats.dropped
+              << " ring high water: " << stats.ring_high_water << "/"
+              << stats.ring_capacity << std::endl;
+    const auto scans = lidar->scanQueueStats();
+    const auto imu = lidar->imuQueueStats();
+    std::cout << "Scans: " << scans.pushed << " dropped: " << scans.dropped
+              << " high water: " << scans.high_water << "/" << scans.capacity
+              << ", IMU: " << imu.pushed << " dropped: " << imu.dropped
+              << " high water: " << imu.high_water << "/" << imu.capacity
+              << std::endl;
   }
 }
\ No newline at end of file
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <chrono>
 #include <filesystem>
 #include <iostream>
 #include <string_view>
@@ -10,6 +12,7 @@
 #include "msensor/imu/icm-20948_defs.h"
 #include "msensor/lidar/mid360.hh"
 #include "msensor/lidar/rp_lidar.hh"
+#include "msensor/timing/trace.hh"
 #include "msensor_server.hh"
 
 constexpr int DefaultI2cBus = 1;
@@ -19,6 +22,33 @@ static void print_usage() {
   std::cout << "Usage: sensor_publisher [config.json]" << std::endl;
 }
 
+/// Expose the Mid360 packet ring and driver queue counters.
+static void register_metrics(msensor::metrics::Registry &registry,
+                             std::shared_ptr<msensor::Mid360> mid360) {
+  using msensor::metrics::Type;
+  registry.callback(Type::Counter, "msensor_driver_packets_total",
+                    "Packets received by the driver.", {{"sensor", "mid360"}},
+                    [mid360] { return mid360->packetStats().received; });
+  registry.callback(Type::Counter, "msensor_driver_packets_dropped_total",
+                    "Packets lost because the packet ring was full.",
+                    {{"sensor", "mid360"}},
+                    [mid360] { return mid360->packetStats().dropped; });
+
+  for (const auto &[queue, stats] :
+       {std::pair{"scan", &msensor::Mid360::scanQueueStats},
+        std::pair{"imu", &msensor::Mid360::imuQueueStats}}) {
+    const msensor::metrics::Labels labels{{"sensor", "mid360"},
+                                          {"queue", queue}};
+    registry.callback(Type::Gauge, "msensor_driver_queue_depth",
+                      "Elements waiting in a driver queue.", labels,
+                      [mid360, stats] { return ((*mid360).*stats)().depth; });
+    registry.callback(
+        Type::Counter, "msensor_driver_queue_dropped_total",
+        "Elements lost to a full driver queue.", labels,
+        [mid360, stats] { return ((*mid360).*stats)().dropped; });
+  }
+}
+
 int main(int argc, char **argv) {
   if (argc > 2) {
     print_usage();
@@ -35,8 +65,17 @@ int main(int argc, char **argv) {
                 : msensor::Config::defaultConfigPath();
   const msensor::Config config = msensor::Config::fromFile(config_path);
 
+  if (config.tracing.enable) {
+    timing::setTracingEnabled(true);
+    if (!timing::tracingEnabled()) {
+      std::cerr << "Tracing requested but not compiled in (WITH_TRACING)."
+                << std::endl;
+    }
+  }
+
   std::shared_ptr<msensor::ILidar> lidar = nullptr;
   std::shared_ptr<msensor::IImu> imu = nullptr;
+  std::shared_ptr<msensor::Mid360> mid360_driver = nullptr;
 
   if (config.mid360.enable && config.rplidar.enable) {
     std::cerr << "Both mid360 and rplidar are enabled; preferring mid360."
@@ -54,13 +93,36 @@ int main(int argc, char **argv) {
                 << " does not exist. Exiting." << std::endl;
       return 1;
     } else {
+      msensor::Mid360::Options options;
+      options.accumulation = {
+          static_cast<size_t>(std::max(config.mid360.accumulate_packets, 0)),
+          std::chrono::milliseconds(config.mid360.accumulate_window_ms),
+          static_cast<size_t>(std::max(config.mid360.max_points, 0))};
+      options.worker_cpu = config.mid360.worker_cpu;
+      options.output = config.mid360.merge
+                           ? msensor::Mid360::Output::Merged
+                           : msensor::Mid360::Output::PerDevice;
+      options.scan_queue_capacity =
+          static_cast<size_t>(config.mid360.scan_queue);
+      if (config.mid360.overflow == "drop_newest") {
+        options.overflow = msensor::Overflow::DropNewest;
+      } else if (config.mid360.overflow == "block") {
+        options.overflow = msensor::Overflow::Block;
+      }
+      options.expected_devices =
+          std::max<size_t>(config.mid360.devices.size(), 1);
+      for (const auto &device : config.mid360.devices) {
+        const auto &e = device.extrinsic;
+        options.extrinsics[device.ip] = {e[0], e[1], e[2], e[3], e[4], e[5]};
+      }
       auto mid360 = std::make_shared<msensor::Mid360>(
-          std::string(config.mid360.config), 100);
+          std::string(config.mid360.config), std::move(options));
       mid360->init();
       mid360->setMode(msensor::Mid360::Mode::Normal);
       mid360->setScanPattern(msensor::Mid360::ScanPattern::NonRepetitive);
       mid360->startSampling();
       lidar = mid360;
+      mid360_driver = mid360;
       if (config.icm20948.enable) {
         std::cerr << "mid360 already provides IMU data; skipping standalone "
                      "ICM20948 initialization."
@@ -94,8 +156,8 @@ int main(int argc, char **argv) {
   }
 
   if (config.icm20948.enable && !imu) {
-    auto icm20948 = std::make_shared<msensor::ICM20948>(config.ads1115.i2c_bus,
-                                                        ICM20948_ADDR0);
+    auto icm20948 = std::make_shared<msensor::ICM20948>(
+        config.ads1115.i2c_bus, ICM20948_ADDR0, config.icm20948.rate_hz);
     icm20948->init();
     icm20948->calibrate();
     imu = icm20948;
@@ -110,6 +172,24 @@ int main(int argc, char **argv) {
   }
 
   SensorsServer server(adc, camera, imu, lidar);
+  if (config.mid360.enable && config.mid360.deskew) {
+    server.enableDeskew();
+  }
+  if (config.shm.enable) {
+    msensor::ShmPublisher::Options options;
+    options.prefix = config.shm.prefix;
+    server.enableSharedMemory(options);
+  }
+  if (config.multicast.enable) {
+    msensor::MulticastPublisher::Options options;
+    options.group = config.multicast.group;
+    options.port = static_cast<uint16_t>(config.multicast.port);
+    options.interface = config.multicast.interface;
+    server.enableMulticast(options);
+  }
+  if (mid360_driver) {
+    register_metrics(*server.metrics(), mid360_driver);
+  }
   server.start();
 
   while (true) {
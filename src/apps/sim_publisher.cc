@@ -1,5 +1,7 @@
+#include <cstdio>
 #include <getopt.h>
 #include <iostream>
+#include <string>
 #include <thread>
 
 #include "msensor/adc/sim_adc.hh"
@@ -8,13 +10,29 @@
 #include "msensor/lidar/sim_lidar.hh"
 #include "msensor_server.hh"
 
-void print_usage() { std::cout << "Usage: sim_publisher" << std::endl; }
+void print_usage() {
+  std::cout << "Usage: sim_publisher [lidar points] [camera WIDTHxHEIGHT]"
+            << std::endl;
+}
 
 int main(int argc, char **argv) {
+  if (argc > 1 && (std::string(argv[1]) == "-h" ||
+                   std::string(argv[1]) == "--help")) {
+    print_usage();
+    exit(0);
+  }
+
+  const size_t points = argc > 1 ? std::stoul(argv[1]) : 2000;
+  int width = 640;
+  int height = 480;
+  if (argc > 2 && std::sscanf(argv[2], "%dx%d", &width, &height) != 2) {
+    print_usage();
+    exit(-1);
+  }
 
-  auto sim_lidar = std::make_shared<msensor::SimLidar>(false);
+  auto sim_lidar = std::make_shared<msensor::SimLidar>(false, points);
   auto sim_imu = std::make_shared<msensor::SimImu>();
-  auto sim_camera = std::make_shared<msensor::SimCamera>();
+  auto sim_camera = std::make_shared<msensor::SimCamera>(width, height);
   auto sim_adc = std::make_shared<msensor::SimAdc>();
 
   SensorsServer server(sim_adc, sim_camera, sim_imu, sim_lidar);
@@ -22,9 +40,6 @@ int main(int argc, char **argv) {
 
   std::cout << "Publishing scan and Imu data";
   while (true) {
-    const auto scan = sim_lidar->getScan();
-    const auto imudata = sim_imu->getImuData();
-
     std::this_thread::sleep_for(std::chrono::microseconds(100));
   }
 }
\ No newline at end of file
@@ -4,15 +4,16 @@
 
 namespace msensor {
 
+SimCamera::SimCamera(int width, int height)
+    : width_(width), height_(height) {}
+
 bool SimCamera::read(CameraFrame &frame) {
   // Generate a simple synthetic image (e.g., a gradient)
-  constexpr int width = 640;
-  constexpr int height = 480;
   constexpr int factor = 256;
 
-  frame.mat.create(height, width, CV_8UC3);
-  for (int y = 0; y < height; ++y) {
-    for (int x = 0; x < width; ++x) {
+  frame.mat.create(height_, width_, CV_8UC3);
+  for (int y = 0; y < height_; ++y) {
+    for (int x = 0; x < width_; ++x) {
       frame.mat.at<cv::Vec3b>(y, x) =
           cv::Vec3b(x % factor, y % factor, (x + y) % factor);
     }
@@ -1,5 +1,6 @@
 #include "msensor/config/config.hh"
 
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 #include <stdexcept>
@@ -67,6 +68,45 @@ int readIntMember(const Json::Value &object, const char *key,
   return value.asInt();
 }
 
+const Json::Value *readArrayMember(const Json::Value &object,
+                                   const char *key) {
+  if (!object.isObject() || !object.isMember(key)) {
+    return nullptr;
+  }
+
+  const auto &value = object[key];
+  if (!value.isArray()) {
+    throw std::runtime_error(std::string("Expected array for '") + key + "'.");
+  }
+
+  return &value;
+}
+
+Config::Mid360Config::Device readMid360Device(const Json::Value &object) {
+  if (!object.isObject()) {
+    throw std::runtime_error("Expected object in 'devices'.");
+  }
+
+  Config::Mid360Config::Device device;
+  device.ip = readStringMember(object, "ip", "");
+  if (device.ip.empty()) {
+    throw std::runtime_error("Expected string for 'ip'.");
+  }
+  if (const auto *extrinsic = readArrayMember(object, "extrinsic")) {
+    if (extrinsic->size() != device.extrinsic.size()) {
+      throw std::runtime_error(
+          "Expected [x, y, z, roll, pitch, yaw] for 'extrinsic'.");
+    }
+    for (Json::ArrayIndex i = 0; i < extrinsic->size(); ++i) {
+      if (!(*extrinsic)[i].isNumeric()) {
+        throw std::runtime_error("Expected number in 'extrinsic'.");
+      }
+      device.extrinsic[i] = (*extrinsic)[i].asFloat();
+    }
+  }
+  return device;
+}
+
 } // namespace
 
 Config Config::fromFile(const std::filesystem::path &config_path) {
@@ -115,6 +155,11 @@ Config Config::fromFile(const std::filesystem::path &config_path) {
   if (const auto *icm20948 = readObjectMember(document, "icm20948")) {
     config.icm20948.enable =
         readBoolMember(*icm20948, "enable", config.icm20948.enable);
+    config.icm20948.rate_hz =
+        readIntMember(*icm20948, "rate_hz", config.icm20948.rate_hz);
+    if (config.icm20948.rate_hz < 1 || config.icm20948.rate_hz > 1100) {
+      throw std::runtime_error("icm20948.rate_hz must be within 1-1100.");
+    }
   }
 
   if (const auto *ads1115 = readObjectMember(document, "ads1115")) {
@@ -142,6 +187,74 @@ Config Config::fromFile(const std::filesystem::path &config_path) {
     config.mid360.enable =
         readBoolMember(*mid360, "enable", config.mid360.enable);
     config.mid360.config = readStringMember(*mid360, "config", "");
+    config.mid360.worker_cpu =
+        readIntMember(*mid360, "worker_cpu", config.mid360.worker_cpu);
+    config.mid360.accumulate_packets = readIntMember(
+        *mid360, "accumulate_packets", config.mid360.accumulate_packets);
+    config.mid360.accumulate_window_ms = readIntMember(
+        *mid360, "accumulate_window_ms", config.mid360.accumulate_window_ms);
+    config.mid360.max_points =
+        readIntMember(*mid360, "max_points", config.mid360.max_points);
+    config.mid360.deskew =
+        readBoolMember(*mid360, "deskew", config.mid360.deskew);
+    config.mid360.merge = readBoolMember(*mid360, "merge", config.mid360.merge);
+    config.mid360.scan_queue =
+        readIntMember(*mid360, "scan_queue", config.mid360.scan_queue);
+    if (config.mid360.scan_queue < 1) {
+      throw std::runtime_error("mid360.scan_queue must be at least 1.");
+    }
+    config.mid360.overflow =
+        readStringMember(*mid360, "overflow", config.mid360.overflow);
+    if (config.mid360.overflow != "drop_oldest" &&
+        config.mid360.overflow != "drop_newest" &&
+        config.mid360.overflow != "block") {
+      throw std::runtime_error("Unknown mid360 overflow policy '" +
+                               config.mid360.overflow + "'.");
+    }
+    if (const auto *devices = readArrayMember(*mid360, "devices")) {
+      for (const auto &device : *devices) {
+        config.mid360.devices.push_back(readMid360Device(device));
+      }
+    }
+    if (config.mid360.deskew && config.mid360.merge) {
+      // The gyro of one device does not describe the merged rig-frame cloud.
+      throw std::runtime_error(
+          "mid360.deskew cannot be combined with mid360.merge.");
+    }
+    // Deskew uses the first device's gyro and clock, in its own frame.
+    const bool rig =
+        config.mid360.devices.size() > 1 ||
+        std::ranges::any_of(config.mid360.devices, [](const auto &device) {
+          return device.extrinsic != std::array<float, 6>{};
+        });
+    if (config.mid360.deskew && rig) {
+      throw std::runtime_error("mid360.deskew needs a single device without "
+                               "extrinsic.");
+    }
+  }
+
+  if (const auto *tracing = readObjectMember(document, "tracing")) {
+    config.tracing.enable =
+        readBoolMember(*tracing, "enable", config.tracing.enable);
+  }
+
+  if (const auto *shm = readObjectMember(document, "shm")) {
+    config.shm.enable = readBoolMember(*shm, "enable", config.shm.enable);
+    config.shm.prefix = readStringMember(*shm, "prefix", config.shm.prefix);
+  }
+
+  if (const auto *multicast = readObjectMember(document, "multicast")) {
+    config.multicast.enable =
+        readBoolMember(*multicast, "enable", config.multicast.enable);
+    config.multicast.group =
+        readStringMember(*multicast, "group", config.multicast.group);
+    config.multicast.port =
+        readIntMember(*multicast, "port", config.multicast.port);
+    if (config.multicast.port < 1 || config.multicast.port > 65535) {
+      throw std::runtime_error("multicast.port must be within 1-65535.");
+    }
+    config.multicast.interface = readStringMember(
+        *multicast, "interface", config.multicast.interface);
   }
 
   return config;
@@ -1,7 +1,261 @@
 
 #include <opencv2/imgcodecs.hpp>
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#ifdef MSENSOR_WITH_ZSTD
+#include <zstd.h>
+#endif
+
 #include "msensor/conversions/conversions.hh"
+#include "msensor/timing/trace.hh"
+
+namespace {
+
+constexpr float g_defaultPackedScale = 0.001F; // 1 mm
+constexpr int g_zstdLevel = 3;
+/// Largest quantized coordinate, so that deltas between two points fit in
+/// 32 bits. Exactly representable as a float.
+constexpr float g_maxQuantized = static_cast<float>((1 << 30) - 64);
+/// Largest serialized `PackedPoints` per point: three 5-byte varints and an
+/// intensity byte, plus a tag and a length per field.
+constexpr size_t g_maxPackedPointBytes = 3 * 5 + 1;
+constexpr size_t g_maxPackedFieldsBytes = 4 * (1 + 5);
+
+using google::protobuf::io::CodedOutputStream;
+
+static_assert(std::endian::native == std::endian::little,
+              "packed float fields are written as raw little-endian bytes");
+static_assert(sizeof(msensor::Point3I) == 8 * sizeof(float),
+              "unexpected PCL PointXYZI layout");
+
+// PointCloud3 wire tags: (field number << 3) | wire type.
+constexpr uint32_t g_tagHeader = (1 << 3) | 2;
+constexpr uint32_t g_tagX = (2 << 3) | 2;
+constexpr uint32_t g_tagY = (3 << 3) | 2;
+constexpr uint32_t g_tagZ = (4 << 3) | 2;
+constexpr uint32_t g_tagIntensity = (5 << 3) | 2;
+constexpr uint32_t g_tagTimeOffset = (9 << 3) | 2;
+constexpr uint32_t g_tagDeviceId = (10 << 3) | 0;
+constexpr uint32_t g_tagTimestamp = (1 << 3) | 0;
+constexpr uint32_t g_tagSequenceNumber = (2 << 3) | 0;
+constexpr uint32_t g_tagTrace = (3 << 3) | 2;
+
+/**
+ * @brief Split interleaved PCL points into x/y/z/intensity columns.
+ *
+ * A PointXYZI is 8 floats: x, y, z, padding, intensity, padding. Four points
+ * are transposed per iteration with SSE or NEON, with a scalar tail.
+ */
+void deinterleave(const msensor::Point3I *points, size_t count, float *x,
+                  float *y, float *z, uint32_t *intensity) {
+  const auto *src = reinterpret_cast<const float *>(points);
+  size_t i = 0;
+#if defined(__SSE2__)
+  for (; i + 4 <= count; i += 4) {
+    const float *p = src + i * 8;
+    __m128 r0 = _mm_loadu_ps(p);
+    __m128 r1 = _mm_loadu_ps(p + 8);
+    __m128 r2 = _mm_loadu_ps(p + 16);
+    __m128 r3 = _mm_loadu_ps(p + 24);
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    _mm_storeu_ps(x + i, r0);
+    _mm_storeu_ps(y + i, r1);
+    _mm_storeu_ps(z + i, r2);
+
+    const __m128 i01 =
+        _mm_unpacklo_ps(_mm_loadu_ps(p + 4), _mm_loadu_ps(p + 12));
+    const __m128 i23 =
+        _mm_unpacklo_ps(_mm_loadu_ps(p + 20), _mm_loadu_ps(p + 28));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(intensity + i),
+                     _mm_cvttps_epi32(_mm_movelh_ps(i01, i23)));
+  }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  for (; i + 4 <= count; i += 4) {
+    const float *p = src + i * 8;
+    // Stride-4 loads: lane pairs hold (x, intensity), (y, pad), (z, pad).
+    const float32x4x4_t a = vld4q_f32(p);
+    const float32x4x4_t b = vld4q_f32(p + 16);
+    vst1q_f32(x + i, vuzp1q_f32(a.val[0], b.val[0]));
+    vst1q_f32(y + i, vuzp1q_f32(a.val[1], b.val[1]));
+    vst1q_f32(z + i, vuzp1q_f32(a.val[2], b.val[2]));
+    vst1q_u32(intensity + i, vcvtq_u32_f32(vuzp2q_f32(a.val[0], b.val[0])));
+  }
+#endif
+  for (; i < count; ++i) {
+    x[i] = points[i].x;
+    y[i] = points[i].y;
+    z[i] = points[i].z;
+    intensity[i] = static_cast<uint32_t>(points[i].intensity);
+  }
+}
+
+/// Trace checkpoints in field order.
+std::array<uint64_t, 4> traceFields(const msensor::Trace &trace) {
+  return {trace.driver_receive_ns, trace.conversion_done_ns,
+          trace.serialization_done_ns, trace.write_start_ns};
+}
+
+size_t traceByteSize(const msensor::Trace &trace) {
+  size_t size = 0;
+  for (const uint64_t value : traceFields(trace)) {
+    if (value != 0) {
+      size += 1 + CodedOutputStream::VarintSize64(value);
+    }
+  }
+  return size;
+}
+
+size_t headerByteSize(const msensor::Header &header) {
+  size_t size = 0;
+  if (header.timestamp != 0) {
+    size += 1 + CodedOutputStream::VarintSize64(header.timestamp);
+  }
+  if (header.sequence_number != 0) {
+    size += 1 + CodedOutputStream::VarintSize32(header.sequence_number);
+  }
+  if (!header.trace.empty()) {
+    const size_t trace_size = traceByteSize(header.trace);
+    size += 1 + CodedOutputStream::VarintSize32(trace_size) + trace_size;
+  }
+  return size;
+}
+
+void writeHeader(const msensor::Header &header, CodedOutputStream *output) {
+  output->WriteTag(g_tagHeader);
+  output->WriteVarint32(headerByteSize(header));
+  if (header.timestamp != 0) {
+    output->WriteTag(g_tagTimestamp);
+    output->WriteVarint64(header.timestamp);
+  }
+  if (header.sequence_number != 0) {
+    output->WriteTag(g_tagSequenceNumber);
+    output->WriteVarint32(header.sequence_number);
+  }
+  if (!header.trace.empty()) {
+    output->WriteTag(g_tagTrace);
+    output->WriteVarint32(traceByteSize(header.trace));
+    uint32_t field = 1;
+    for (const uint64_t value : traceFields(header.trace)) {
+      if (value != 0) {
+        output->WriteTag(field << 3);
+        output->WriteVarint64(value);
+      }
+      ++field;
+    }
+  }
+}
+
+void toProtobuf(const msensor::Header &header, sensors::Header *msg) {
+  msg->set_timestamp(header.timestamp);
+  msg->set_sequence_number(header.sequence_number);
+  if (header.trace.empty()) {
+    if (msg->has_trace()) {
+      msg->clear_trace();
+    }
+    return;
+  }
+  auto *trace = msg->mutable_trace();
+  trace->set_driver_receive_ns(header.trace.driver_receive_ns);
+  trace->set_conversion_done_ns(header.trace.conversion_done_ns);
+  trace->set_serialization_done_ns(header.trace.serialization_done_ns);
+  trace->set_write_start_ns(header.trace.write_start_ns);
+}
+
+msensor::Header fromProtobuf(const sensors::Header &msg) {
+  msensor::Header header{msg.timestamp(), msg.sequence_number()};
+  if (msg.has_trace()) {
+    header.trace = {msg.trace().driver_receive_ns(),
+                    msg.trace().conversion_done_ns(),
+                    msg.trace().serialization_done_ns(),
+                    msg.trace().write_start_ns()};
+  }
+  return header;
+}
+
+/// Record that `msg` has been filled, when tracing.
+void stampSerializationDone(sensors::Header *msg) {
+  if (timing::tracingEnabled()) {
+    msg->mutable_trace()->set_serialization_done_ns(timing::getEpochTimeNs());
+  }
+}
+
+size_t packedFieldByteSize(size_t payload_size) {
+  return 1 + CodedOutputStream::VarintSize32(payload_size) + payload_size;
+}
+
+/// Per-point times are only carried when there is one per point.
+bool hasTimeOffsets(const msensor::Scan3DI &scan) {
+  return !scan.time_offsets_us.empty() &&
+         scan.time_offsets_us.size() == scan.points->size();
+}
+
+size_t varintsByteSize(const std::vector<uint32_t> &values) {
+  size_t size = 0;
+  for (const uint32_t value : values) {
+    size += CodedOutputStream::VarintSize32(value);
+  }
+  return size;
+}
+
+int32_t quantize(float value, float inv_scale) {
+  const float scaled = std::round(value * inv_scale);
+  if (std::isnan(scaled)) {
+    return 0;
+  }
+  return static_cast<int32_t>(
+      std::clamp(scaled, -g_maxQuantized, g_maxQuantized));
+}
+
+/// Write the point fields (2-9) of a non-empty scan.
+void writePoints(const msensor::Scan3DI &scan, CodedOutputStream *output) {
+  const size_t point_count = scan.points->size();
+
+  // Columns are staged in a per-thread buffer that is reused across scans.
+  thread_local std::vector<float> columns;
+  thread_local std::vector<uint32_t> intensity;
+  columns.resize(3 * point_count);
+  intensity.resize(point_count);
+  float *x = columns.data();
+  float *y = x + point_count;
+  float *z = y + point_count;
+  deinterleave(scan.points->points.data(), point_count, x, y, z,
+               intensity.data());
+
+  const size_t column_bytes = point_count * sizeof(float);
+  for (const auto &[tag, column] :
+       {std::pair{g_tagX, x}, std::pair{g_tagY, y}, std::pair{g_tagZ, z}}) {
+    output->WriteTag(tag);
+    output->WriteVarint32(column_bytes);
+    output->WriteRaw(column, static_cast<int>(column_bytes));
+  }
+
+  output->WriteTag(g_tagIntensity);
+  output->WriteVarint32(varintsByteSize(intensity));
+  for (const uint32_t value : intensity) {
+    output->WriteVarint32(value);
+  }
+
+  if (hasTimeOffsets(scan)) {
+    output->WriteTag(g_tagTimeOffset);
+    output->WriteVarint32(varintsByteSize(scan.time_offsets_us));
+    for (const uint32_t value : scan.time_offsets_us) {
+      output->WriteVarint32(value);
+    }
+  }
+}
+} // namespace
 
 std::shared_ptr<msensor::Scan3DI>
 fromProtobuf(const sensors::PointCloud3 &msg) {
@@ -26,48 +280,353 @@ fromProtobuf(const sensors::PointCloud3 &msg) {
     (*scan->points)[i].intensity = intensity_data[i];
   }
 
-  scan->header.timestamp = msg.header().timestamp();
-  scan->header.sequence_number = msg.header().sequence_number();
+  if (msg.time_offset_us_size() == msg.x_size()) {
+    scan->time_offsets_us.assign(msg.time_offset_us().begin(),
+                                 msg.time_offset_us().end());
+  }
+  scan->device_id = msg.device_id();
+
+  scan->header = fromProtobuf(msg.header());
 
   return scan;
 }
 
-sensors::PointCloud3 toProtobuf(const std::shared_ptr<msensor::Scan3DI> &scan) {
+sensors::PointCloud3
+toProtobuf(const std::shared_ptr<const msensor::Scan3DI> &scan) {
   sensors::PointCloud3 point_cloud;
+  toProtobuf(scan, &point_cloud);
+  return point_cloud;
+}
 
+void toProtobuf(const std::shared_ptr<const msensor::Scan3DI> &scan,
+                sensors::PointCloud3 *point_cloud) {
   if (!scan || !scan->points) {
-    return point_cloud;
+    point_cloud->Clear();
+    return;
   }
 
-  point_cloud.mutable_header()->set_timestamp(scan->header.timestamp);
-  point_cloud.mutable_header()->set_sequence_number(
-      scan->header.sequence_number);
+  toProtobuf(scan->header, point_cloud->mutable_header());
 
-  auto *x = point_cloud.mutable_x();
-  auto *y = point_cloud.mutable_y();
-  auto *z = point_cloud.mutable_z();
-  auto *intensity = point_cloud.mutable_intensity();
+  auto *x = point_cloud->mutable_x();
+  auto *y = point_cloud->mutable_y();
+  auto *z = point_cloud->mutable_z();
+  auto *intensity = point_cloud->mutable_intensity();
 
+  // Resize keeps the existing capacity, so a reused message does not
+  // reallocate once it has seen a scan of this size.
   const auto point_count = static_cast<int>(scan->points->size());
-  x->Reserve(point_count);
-  y->Reserve(point_count);
-  z->Reserve(point_count);
-  intensity->Reserve(point_count);
+  x->Resize(point_count, 0.0F);
+  y->Resize(point_count, 0.0F);
+  z->Resize(point_count, 0.0F);
+  intensity->Resize(point_count, 0);
+
+  deinterleave(scan->points->points.data(), point_count, x->mutable_data(),
+               y->mutable_data(), z->mutable_data(), intensity->mutable_data());
+
+  auto *time_offsets = point_cloud->mutable_time_offset_us();
+  if (hasTimeOffsets(*scan)) {
+    time_offsets->Resize(point_count, 0);
+    std::copy(scan->time_offsets_us.begin(), scan->time_offsets_us.end(),
+              time_offsets->mutable_data());
+  } else {
+    time_offsets->Clear();
+  }
+  point_cloud->set_device_id(scan->device_id);
+  stampSerializationDone(point_cloud->mutable_header());
+}
+
+size_t pointCloudByteSize(const std::shared_ptr<const msensor::Scan3DI> &scan) {
+  if (!scan || !scan->points) {
+    return 0;
+  }
 
+  size_t size = packedFieldByteSize(headerByteSize(scan->header));
+  if (scan->device_id != 0) {
+    size += 1 + CodedOutputStream::VarintSize32(scan->device_id);
+  }
+
+  const size_t point_count = scan->points->size();
+  if (point_count == 0) {
+    return size;
+  }
+
+  size += 3 * packedFieldByteSize(point_count * sizeof(float));
+
+  size_t intensity_size = 0;
   for (const auto &point : scan->points->points) {
-    x->Add(point.x);
-    y->Add(point.y);
-    z->Add(point.z);
-    intensity->Add(static_cast<uint32_t>(point.intensity));
+    intensity_size += CodedOutputStream::VarintSize32(
+        static_cast<uint32_t>(point.intensity));
   }
+  size += packedFieldByteSize(intensity_size);
 
-  return point_cloud;
+  if (hasTimeOffsets(*scan)) {
+    size += packedFieldByteSize(varintsByteSize(scan->time_offsets_us));
+  }
+  return size;
+}
+
+void writePointCloud(const std::shared_ptr<const msensor::Scan3DI> &scan,
+                     CodedOutputStream *output) {
+  if (!scan || !scan->points) {
+    return;
+  }
+
+  writeHeader(scan->header, output);
+
+  if (!scan->points->empty()) {
+    writePoints(*scan, output);
+  }
+
+  if (scan->device_id != 0) {
+    output->WriteTag(g_tagDeviceId);
+    output->WriteVarint32(scan->device_id);
+  }
+}
+
+sensors::PointCloud3Packed
+toProtobuf(const std::shared_ptr<const msensor::Scan3DI> &scan,
+           const sensors::PackedEncoding &encoding) {
+  sensors::PointCloud3Packed packed;
+  toProtobuf(scan, encoding, &packed);
+  return packed;
+}
+
+void toProtobuf(const std::shared_ptr<const msensor::Scan3DI> &scan,
+                const sensors::PackedEncoding &encoding,
+                sensors::PointCloud3Packed *packed) {
+  if (!scan || !scan->points) {
+    packed->Clear();
+    return;
+  }
+
+  toProtobuf(scan->header, packed->mutable_header());
+  packed->set_device_id(scan->device_id);
+  packed->set_point_count(static_cast<uint32_t>(scan->points->size()));
+
+  const float scale =
+      encoding.scale() > 0.0F ? encoding.scale() : g_defaultPackedScale;
+  const float inv_scale = 1.0F / scale;
+  auto *applied = packed->mutable_encoding();
+  applied->set_scale(scale);
+  applied->set_delta(encoding.delta());
+
+  // Quantize straight into the outgoing message unless the points are going
+  // to be compressed, in which case they go through a per-thread scratch.
+  sensors::PackedPoints *points = nullptr;
+#ifdef MSENSOR_WITH_ZSTD
+  thread_local sensors::PackedPoints scratch;
+  const bool compress = encoding.compression() == sensors::COMPRESSION_ZSTD;
+  points = compress ? &scratch : packed->mutable_points();
+#else
+  points = packed->mutable_points();
+#endif
+
+  const auto point_count = static_cast<int>(scan->points->size());
+  points->mutable_x()->Resize(point_count, 0);
+  points->mutable_y()->Resize(point_count, 0);
+  points->mutable_z()->Resize(point_count, 0);
+  points->mutable_intensity()->resize(point_count);
+  int32_t *out_x = points->mutable_x()->mutable_data();
+  int32_t *out_y = points->mutable_y()->mutable_data();
+  int32_t *out_z = points->mutable_z()->mutable_data();
+  char *out_intensity = points->mutable_intensity()->data();
+
+  int32_t prev_x = 0;
+  int32_t prev_y = 0;
+  int32_t prev_z = 0;
+  for (int i = 0; i < point_count; ++i) {
+    const auto &point = scan->points->points[i];
+    const int32_t x = quantize(point.x, inv_scale);
+    const int32_t y = quantize(point.y, inv_scale);
+    const int32_t z = quantize(point.z, inv_scale);
+    if (encoding.delta()) {
+      // In range: coordinates are quantized to 31 bits.
+      out_x[i] = static_cast<int32_t>(int64_t{x} - prev_x);
+      out_y[i] = static_cast<int32_t>(int64_t{y} - prev_y);
+      out_z[i] = static_cast<int32_t>(int64_t{z} - prev_z);
+      prev_x = x;
+      prev_y = y;
+      prev_z = z;
+    } else {
+      out_x[i] = x;
+      out_y[i] = y;
+      out_z[i] = z;
+    }
+    out_intensity[i] =
+        static_cast<char>(std::clamp(point.intensity, 0.0F, 255.0F));
+  }
+
+#ifdef MSENSOR_WITH_ZSTD
+  if (compress) {
+    thread_local std::string raw;
+    points->SerializeToString(&raw);
+    auto *compressed = packed->mutable_compressed_points();
+    compressed->resize(ZSTD_compressBound(raw.size()));
+    const size_t size = ZSTD_compress(compressed->data(), compressed->size(),
+                                      raw.data(), raw.size(), g_zstdLevel);
+    if (!ZSTD_isError(size)) {
+      compressed->resize(size);
+      applied->set_compression(sensors::COMPRESSION_ZSTD);
+      stampSerializationDone(packed->mutable_header());
+      return;
+    }
+    *packed->mutable_points() = *points;
+  }
+#endif
+
+  applied->set_compression(sensors::COMPRESSION_NONE);
+  stampSerializationDone(packed->mutable_header());
+}
+
+std::shared_ptr<msensor::Scan3DI>
+fromProtobuf(const sensors::PointCloud3Packed &msg) {
+  auto scan = std::make_shared<msensor::Scan3DI>();
+
+  sensors::PackedPoints decompressed;
+  const sensors::PackedPoints *points = &msg.points();
+  if (msg.has_compressed_points()) {
+#ifdef MSENSOR_WITH_ZSTD
+    const auto &compressed = msg.compressed_points();
+    const auto raw_size =
+        ZSTD_getFrameContentSize(compressed.data(), compressed.size());
+    // Allocate no more than the announced points can take.
+    const uint64_t max_size =
+        uint64_t{msg.point_count()} * g_maxPackedPointBytes +
+        g_maxPackedFieldsBytes;
+    if (raw_size == ZSTD_CONTENTSIZE_ERROR ||
+        raw_size == ZSTD_CONTENTSIZE_UNKNOWN || raw_size > max_size) {
+      return scan;
+    }
+    std::string raw(raw_size, '\0');
+    const size_t size = ZSTD_decompress(raw.data(), raw.size(),
+                                        compressed.data(), compressed.size());
+    if (ZSTD_isError(size) || !decompressed.ParseFromArray(raw.data(), size)) {
+      return scan;
+    }
+    if (decompressed.x_size() != static_cast<int>(msg.point_count())) {
+      return scan;
+    }
+    points = &decompressed;
+#else
+    return scan;
+#endif
+  }
+
+  const int point_count = points->x_size();
+  if (points->y_size() != point_count || points->z_size() != point_count ||
+      static_cast<int>(points->intensity().size()) != point_count) {
+    return scan;
+  }
+
+  const float scale = msg.encoding().scale() > 0.0F ? msg.encoding().scale()
+                                                    : g_defaultPackedScale;
+  const bool delta = msg.encoding().delta();
+  const auto *intensity =
+      reinterpret_cast<const uint8_t *>(points->intensity().data());
+
+  scan->points->resize(point_count);
+
+  // Wide enough for any sum of received deltas.
+  int64_t x = 0;
+  int64_t y = 0;
+  int64_t z = 0;
+  for (int i = 0; i < point_count; ++i) {
+    x = delta ? x + points->x(i) : points->x(i);
+    y = delta ? y + points->y(i) : points->y(i);
+    z = delta ? z + points->z(i) : points->z(i);
+    auto &point = (*scan->points)[i];
+    point.x = static_cast<float>(x) * scale;
+    point.y = static_cast<float>(y) * scale;
+    point.z = static_cast<float>(z) * scale;
+    point.intensity = intensity[i];
+  }
+
+  scan->header = fromProtobuf(msg.header());
+  scan->device_id = msg.device_id();
+
+  return scan;
+}
+
+msensor::CropRegion fromProtobuf(const sensors::CropRegion &msg) {
+  msensor::CropRegion region;
+  if (msg.has_box()) {
+    // Unset bounds keep the region's infinite defaults.
+    const auto &box = msg.box();
+    if (box.has_min_x()) {
+      region.box_min[0] = box.min_x();
+    }
+    if (box.has_min_y()) {
+      region.box_min[1] = box.min_y();
+    }
+    if (box.has_min_z()) {
+      region.box_min[2] = box.min_z();
+    }
+    if (box.has_max_x()) {
+      region.box_max[0] = box.max_x();
+    }
+    if (box.has_max_y()) {
+      region.box_max[1] = box.max_y();
+    }
+    if (box.has_max_z()) {
+      region.box_max[2] = box.max_z();
+    }
+  }
+  region.min_range = msg.min_range();
+  if (msg.max_range() > 0.0F) {
+    region.max_range = msg.max_range();
+  }
+  region.azimuth_min = msg.azimuth_min();
+  region.azimuth_max = msg.azimuth_max();
+  if (msg.min_intensity() != 0.0F) {
+    region.min_intensity = msg.min_intensity();
+  }
+  return region;
+}
+
+sensors::CropRegion toProtobuf(const msensor::CropRegion &region) {
+  constexpr float infinity = msensor::CropRegion::g_infinity;
+  const auto bounded = [](const std::array<float, 3> &bounds) {
+    return std::ranges::any_of(
+        bounds, [](float value) { return std::isfinite(value); });
+  };
+  sensors::CropRegion msg;
+  if (bounded(region.box_min) || bounded(region.box_max)) {
+    // Infinite bounds are left unset.
+    auto *box = msg.mutable_box();
+    if (region.box_min[0] != -infinity) {
+      box->set_min_x(region.box_min[0]);
+    }
+    if (region.box_min[1] != -infinity) {
+      box->set_min_y(region.box_min[1]);
+    }
+    if (region.box_min[2] != -infinity) {
+      box->set_min_z(region.box_min[2]);
+    }
+    if (region.box_max[0] != infinity) {
+      box->set_max_x(region.box_max[0]);
+    }
+    if (region.box_max[1] != infinity) {
+      box->set_max_y(region.box_max[1]);
+    }
+    if (region.box_max[2] != infinity) {
+      box->set_max_z(region.box_max[2]);
+    }
+  }
+  msg.set_min_range(region.min_range);
+  if (region.max_range < infinity) {
+    msg.set_max_range(region.max_range);
+  }
+  msg.set_azimuth_min(region.azimuth_min);
+  msg.set_azimuth_max(region.azimuth_max);
+  if (region.min_intensity > -infinity) {
+    msg.set_min_intensity(region.min_intensity);
+  }
+  return msg;
 }
 
 msensor::IMUData fromProtobuf(const sensors::IMUData &msg) {
   msensor::IMUData imu_data;
-  imu_data.header.timestamp = msg.header().timestamp();
-  imu_data.header.sequence_number = msg.header().sequence_number();
+  imu_data.header = fromProtobuf(msg.header());
   imu_data.ax = msg.ax();
   imu_data.ay = msg.ay();
   imu_data.az = msg.az();
@@ -85,12 +644,49 @@ sensors::IMUData toProtobuf(msensor::IMUData imu_data) {
   grpc_data.set_gx(imu_data.gx);
   grpc_data.set_gy(imu_data.gy);
   grpc_data.set_gz(imu_data.gz);
-  grpc_data.mutable_header()->set_timestamp(imu_data.header.timestamp);
-  grpc_data.mutable_header()->set_sequence_number(
-      imu_data.header.sequence_number);
+  toProtobuf(imu_data.header, grpc_data.mutable_header());
+  stampSerializationDone(grpc_data.mutable_header());
   return grpc_data;
 }
 
+void appendToBatch(sensors::ImuBatch &batch, const msensor::IMUData &imu) {
+  if (batch.ax_size() == 0) {
+    toProtobuf(imu.header, batch.mutable_header());
+  }
+  batch.add_time_offset_ns(imu.header.timestamp - batch.header().timestamp());
+  batch.add_sequence_number(imu.header.sequence_number);
+  batch.add_ax(imu.ax);
+  batch.add_ay(imu.ay);
+  batch.add_az(imu.az);
+  batch.add_gx(imu.gx);
+  batch.add_gy(imu.gy);
+  batch.add_gz(imu.gz);
+}
+
+void sealBatch(sensors::ImuBatch &batch) {
+  stampSerializationDone(batch.mutable_header());
+}
+
+std::vector<msensor::IMUData> fromProtobuf(const sensors::ImuBatch &msg) {
+  std::vector<msensor::IMUData> samples;
+  const int count = msg.ax_size();
+  if (msg.time_offset_ns_size() != count ||
+      msg.sequence_number_size() != count || msg.ay_size() != count ||
+      msg.az_size() != count || msg.gx_size() != count ||
+      msg.gy_size() != count || msg.gz_size() != count) {
+    return samples;
+  }
+
+  samples.reserve(count);
+  for (int i = 0; i < count; ++i) {
+    samples.push_back(msensor::IMUData{
+        msensor::Header{msg.header().timestamp() + msg.time_offset_ns(i),
+                        msg.sequence_number(i)},
+        msg.ax(i), msg.ay(i), msg.az(i), msg.gx(i), msg.gy(i), msg.gz(i)});
+  }
+  return samples;
+}
+
 sensors::CameraStreamReply toProtobuf(const msensor::CameraFrame &frame,
                                       int quality) {
   sensors::CameraStreamReply reply;
@@ -106,8 +702,7 @@ sensors::CameraStreamReply toProtobuf(const msensor::CameraFrame &frame,
     reply.set_encoding(sensors::CameraEncoding::UNKNOWN);
   }
 
-  reply.mutable_header()->set_timestamp(frame.header.timestamp);
-  reply.mutable_header()->set_sequence_number(frame.header.sequence_number);
+  toProtobuf(frame.header, reply.mutable_header());
 
   static std::vector<uchar> jpeg_buffer;
   const std::vector<int> jpeg_params{cv::IMWRITE_JPEG_QUALITY, quality};
@@ -117,6 +712,7 @@ sensors::CameraStreamReply toProtobuf(const msensor::CameraFrame &frame,
 
   reply.set_encoding(sensors::CameraEncoding::MJPEG);
   reply.set_image_data(jpeg_buffer.data(), jpeg_buffer.size());
+  stampSerializationDone(reply.mutable_header());
 
   return reply;
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 
+#include <algorithm>
 #include <fcntl.h>
 extern "C" {
 #include <i2c/smbus.h>
@@ -7,6 +8,7 @@ extern "C" {
 #include <stdexcept>
 #include <string>
 #include <sys/ioctl.h>
+#include <thread>
 #include <unistd.h>
 
 #include "msensor/imu/icm-20948.h"
@@ -50,8 +52,14 @@ void ICM20948::bank_select(int bank) const {
     throw std::runtime_error("Unable to write to Bank selector.");
 }
 
-ICM20948::ICM20948(int i2c_device, int i2c_icm_address)
-    : i2c_device_(i2c_device), i2c_icm_address_(i2c_icm_address) {
+ICM20948::ICM20948(int i2c_device, int i2c_icm_address, int rate_hz)
+    : i2c_device_(i2c_device), i2c_icm_address_(i2c_icm_address),
+      period_(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::seconds(1)) /
+              std::max(rate_hz, 1)) {
+  if (rate_hz < 1 || rate_hz > 1100) {
+    throw std::runtime_error("ICM20948 rate must be within 1-1100 Hz.");
+  }
   const std::string i2c_device_file = "/dev/i2c-" + std::to_string(i2c_device);
   i2c_device_fd_ = open(i2c_device_file.c_str(), O_RDWR);
 
@@ -202,8 +210,25 @@ bool ICM20948::calibrate() const {
   return true;
 }
 
+bool ICM20948::waitForImuData(std::chrono::milliseconds timeout) {
+  const auto now = std::chrono::steady_clock::now();
+  if (next_sample_ - now > timeout) {
+    std::this_thread::sleep_for(timeout);
+    return false;
+  }
+  std::this_thread::sleep_until(next_sample_);
+  return true;
+}
+
 std::optional<IMUData> ICM20948::getImuData() {
   static uint32_t sequence_number = 0;
+  // Paces waitForImuData(); a reader late by more than a period restarts
+  // the schedule rather than bursting to catch up.
+  const auto now = std::chrono::steady_clock::now();
+  next_sample_ += period_;
+  if (next_sample_ < now) {
+    next_sample_ = now + period_;
+  }
   auto acc_data = get_acc_data();
   auto gyr_data = get_gyro_data();
   auto dbl_acc_data = convert_raw_data(acc_data, FACTOR_ACC_2G);
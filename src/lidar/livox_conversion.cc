@@ -0,0 +1,135 @@
+#include "msensor/lidar/livox_conversion.hh"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MSENSOR_LIVOX_X86
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define MSENSOR_LIVOX_NEON
+#endif
+
+namespace msensor::livox {
+
+namespace {
+
+constexpr float g_millimetresToMetres = 0.001F;
+constexpr size_t g_reflectivityOffset = 12;
+
+static_assert(sizeof(Point3I) == 8 * sizeof(float),
+              "unexpected PCL PointXYZI layout");
+
+// The vector kernels load 16 bytes per 14-byte point, i.e. 2 bytes into the
+// next one, so the last point of a packet always goes through this tail.
+void convertScalar(const uint8_t *raw, size_t count, Point3I *dest) {
+  for (size_t i = 0; i < count; ++i) {
+    const uint8_t *p = raw + i * g_cartesianHighPointSize;
+    int32_t xyz[3];
+    std::memcpy(xyz, p, sizeof(xyz));
+    dest[i].x = static_cast<float>(xyz[0]) * g_millimetresToMetres;
+    dest[i].y = static_cast<float>(xyz[1]) * g_millimetresToMetres;
+    dest[i].z = static_cast<float>(xyz[2]) * g_millimetresToMetres;
+    dest[i].intensity = p[g_reflectivityOffset];
+  }
+}
+
+#ifdef MSENSOR_LIVOX_X86
+// One point per register: a 16-byte load covers x, y, z (and the
+// reflectivity/tag bytes, masked off), so no gather or transpose is needed.
+// Measured faster than 8-wide AVX2 gathers, which pay for the AoS transpose.
+__attribute__((target("sse2"))) void
+convertSse2(const uint8_t *raw, size_t count, Point3I *dest) {
+  const __m128 scale = _mm_set1_ps(g_millimetresToMetres);
+  const __m128 xyz_mask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+  const __m128 w_one = _mm_set_ps(1.0F, 0.0F, 0.0F, 0.0F);
+
+  size_t i = 0;
+  for (; i + 1 < count; ++i) {
+    const uint8_t *p = raw + i * g_cartesianHighPointSize;
+    const __m128i mm = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    __m128 m = _mm_mul_ps(_mm_cvtepi32_ps(mm), scale);
+    m = _mm_or_ps(_mm_and_ps(m, xyz_mask), w_one);
+    _mm_storeu_ps(dest[i].data, m);
+    dest[i].intensity = p[g_reflectivityOffset];
+  }
+  convertScalar(raw + i * g_cartesianHighPointSize, count - i, dest + i);
+}
+#endif
+
+#ifdef MSENSOR_LIVOX_NEON
+void convertNeon(const uint8_t *raw, size_t count, Point3I *dest) {
+  size_t i = 0;
+  for (; i + 1 < count; ++i) {
+    const uint8_t *p = raw + i * g_cartesianHighPointSize;
+    const int32x4_t mm = vld1q_s32(reinterpret_cast<const int32_t *>(p));
+    float32x4_t m = vmulq_n_f32(vcvtq_f32_s32(mm), g_millimetresToMetres);
+    m = vsetq_lane_f32(1.0F, m, 3);
+    vst1q_f32(dest[i].data, m);
+    dest[i].intensity = p[g_reflectivityOffset];
+  }
+  convertScalar(raw + i * g_cartesianHighPointSize, count - i, dest + i);
+}
+#endif
+
+Kernel detectKernel() {
+#ifdef MSENSOR_LIVOX_X86
+  if (__builtin_cpu_supports("sse2")) {
+    return Kernel::Sse2;
+  }
+#elif defined(MSENSOR_LIVOX_NEON)
+  return Kernel::Neon;
+#endif
+  return Kernel::Scalar;
+}
+
+} // namespace
+
+Kernel bestKernel() {
+  static const Kernel kernel = detectKernel();
+  return kernel;
+}
+
+bool isSupported(Kernel kernel) {
+  switch (kernel) {
+  case Kernel::Scalar:
+    return true;
+#ifdef MSENSOR_LIVOX_X86
+  case Kernel::Sse2:
+    return __builtin_cpu_supports("sse2");
+#endif
+
+#ifdef MSENSOR_LIVOX_NEON
+  case Kernel::Neon:
+    return true;
+#endif
+  default:
+    return false;
+  }
+}
+
+void convertCartesianHigh(const uint8_t *raw, size_t count, Point3I *dest) {
+  convertCartesianHigh(raw, count, dest, bestKernel());
+}
+
+void convertCartesianHigh(const uint8_t *raw, size_t count, Point3I *dest,
+                          Kernel kernel) {
+  switch (kernel) {
+#ifdef MSENSOR_LIVOX_X86
+  case Kernel::Sse2:
+    convertSse2(raw, count, dest);
+    return;
+#endif
+
+#ifdef MSENSOR_LIVOX_NEON
+  case Kernel::Neon:
+    convertNeon(raw, count, dest);
+    return;
+#endif
+  default:
+    convertScalar(raw, count, dest);
+    return;
+  }
+}
+
+} // namespace msensor::livox
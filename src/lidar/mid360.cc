@@ -1,44 +1,156 @@
 #include "msensor/lidar/mid360.hh"
 
 #include <algorithm>
+#include <bit>
+#include <cstring>
 #include <future>
 #include <livox_lidar_def.h>
+#include <pthread.h>
 
 #include <iostream>
 #include <string>
 
+#include <Eigen/Geometry>
+
 #include "livox_lidar_api.h"
 #include "msensor/interface/ILidar.hh"
+#include "msensor/lidar/livox_conversion.hh"
+#include "msensor/timing/trace.hh"
 
 namespace msensor {
 
-constexpr size_t g_max_queue_elements = 50;
-constexpr size_t g_max_scan_points_per_packet = 96;
+constexpr size_t g_imu_queue_elements = 50;
+constexpr size_t g_max_scan_points_per_packet = livox::g_maxPointsPerPacket;
+/// Raw packets buffered between the SDK thread and the worker, ~0.2 s of
+/// Mid360 traffic.
+constexpr size_t g_packet_ring_size = 1024;
+/// IMU samples buffered between the SDK thread and the worker, ~1 s at the
+/// Mid360's 200 Hz.
+constexpr size_t g_imu_ring_size = 256;
+/// Nominal Mid360 point rate, used to size buffers for time-window scans.
+constexpr size_t g_points_per_second = 200000;
+/// How long init() waits for the expected devices to connect.
+constexpr auto g_device_wait_timeout = std::chrono::milliseconds(10000);
+/// Upper bound on how long the worker sleeps before re-checking for stop.
+constexpr auto g_worker_wait_timeout = std::chrono::milliseconds(100);
 
 namespace {
 
-void convertEthPacketInto(const LivoxLidarEthernetPacket *eth_packet,
-                          unsigned int data_pts,
-                          pcl::PointCloud<pcl::PointXYZI> &dest) {
-  const auto *data_ = reinterpret_cast<const LivoxLidarCartesianHighRawPoint *>(
-      eth_packet->data);
-  const size_t count =
-      std::min(static_cast<size_t>(data_pts), g_max_scan_points_per_packet);
-  const size_t offset = dest.size();
-  dest.resize(offset + count);
-  for (size_t i = 0; i < count; ++i) {
-    dest[offset + i].x = static_cast<float>(data_[i].x) / 1000.0F;
-    dest[offset + i].y = static_cast<float>(data_[i].y) / 1000.0F;
-    dest[offset + i].z = static_cast<float>(data_[i].z) / 1000.0F;
-    dest[offset + i].intensity = data_[i].reflectivity;
+static_assert(sizeof(LivoxLidarCartesianHighRawPoint) ==
+              livox::g_cartesianHighPointSize);
+
+void pinCurrentThread(int cpu) {
+#ifdef __linux__
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(cpu, &cpu_set);
+  if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) != 0) {
+    std::cout << "Unable to pin Mid360 worker to CPU " << cpu << std::endl;
   }
+#else
+  std::cout << "CPU affinity is not supported on this platform." << std::endl;
+#endif
+}
+
+/// Points a scan can hold under `accumulation`, used to size pooled buffers.
+size_t expectedScanPoints(const Mid360::Accumulation &accumulation) {
+  if (accumulation.max_points > 0) {
+    return accumulation.max_points;
+  }
+  if (accumulation.packets > 0) {
+    return accumulation.packets * g_max_scan_points_per_packet;
+  }
+  return g_points_per_second * accumulation.window.count() / 1000;
+}
+
+/// Scans held at once: queued, accumulating per device, merging, and
+/// downstream.
+size_t scanPoolSize(const Mid360::Options &options) {
+  return options.scan_queue_capacity +
+         std::max<size_t>(options.expected_devices, 1) + 1 +
+         g_mid360ScanPoolHeadroom;
+}
+
+/// Points a pooled scan is reserved for: a merged scan holds every device.
+size_t pooledScanPoints(const Mid360::Options &options) {
+  const size_t devices = options.output == Mid360::Output::Merged
+                             ? std::max<size_t>(options.expected_devices, 1)
+                             : 1;
+  return expectedScanPoints(options.accumulation) * devices;
+}
+
+Eigen::Matrix4f toMatrix(const Mid360::Extrinsic &extrinsic) {
+  Eigen::Affine3f transform =
+      Eigen::Translation3f(extrinsic.x, extrinsic.y, extrinsic.z) *
+      Eigen::AngleAxisf(extrinsic.yaw, Eigen::Vector3f::UnitZ()) *
+      Eigen::AngleAxisf(extrinsic.pitch, Eigen::Vector3f::UnitY()) *
+      Eigen::AngleAxisf(extrinsic.roll, Eigen::Vector3f::UnitX());
+  return transform.matrix();
+}
+
+uint64_t windowIndex(const Mid360::Accumulation &accumulation,
+                     uint64_t timestamp) {
+  const auto window_ns = static_cast<uint64_t>(
+      std::chrono::nanoseconds(accumulation.window).count());
+  return window_ns > 0 ? timestamp / window_ns : 0;
+}
+
+void clearScan(Scan3DI &scan) {
+  scan.points->clear();
+  scan.time_offsets_us.clear();
+  scan.device_id = 0;
 }
 } // namespace
 
-Mid360::Mid360(std::string config, size_t accumulate_scan_count)
-    : config_{std::move(config)}, accumulate_scan_count_(accumulate_scan_count),
-      scan_queue_(g_max_queue_elements), imu_queue_(g_max_queue_elements),
-      scan_count_(0) {}
+Mid360::Device::Device(size_t index, uint32_t handle, std::string ip)
+    : index(index), handle(handle), ip(std::move(ip)),
+      packet_ring(g_packet_ring_size) {}
+
+Mid360::Mid360(std::string config, size_t accumulate_scan_count,
+               int worker_cpu)
+    : Mid360(std::move(config), Accumulation{accumulate_scan_count},
+             worker_cpu) {}
+
+Mid360::Mid360(std::string config, Accumulation accumulation, int worker_cpu)
+    : Mid360(std::move(config),
+             Options{.accumulation = accumulation, .worker_cpu = worker_cpu}) {}
+
+Mid360::Mid360(std::string config, Options options)
+    : config_{std::move(config)}, options_(std::move(options)),
+      scan_pool_(scanPoolSize(options_),
+                 [points = pooledScanPoints(options_)] {
+                   auto scan = std::make_shared<Scan3DI>();
+                   scan->points->reserve(points);
+                   scan->time_offsets_us.reserve(points);
+                   return scan;
+                 }),
+      scan_queue_(options_.scan_queue_capacity, options_.overflow,
+                  options_.block_timeout, "Mid360 scan queue"),
+      imu_ring_(g_imu_ring_size),
+      imu_queue_(g_imu_queue_elements, options_.overflow,
+                 options_.block_timeout, "Mid360 IMU queue") {
+  const auto &accumulation = options_.accumulation;
+  if (accumulation.packets == 0 && accumulation.window.count() <= 0) {
+    throw std::runtime_error(
+        "Mid360 accumulation needs a packet count or a time window!");
+  }
+  if (options_.output == Output::Merged && accumulation.window.count() <= 0) {
+    throw std::runtime_error("Merged Mid360 output needs a time window!");
+  }
+  if (options_.expected_devices > g_mid360MaxDevices) {
+    throw std::runtime_error("Too many Mid360 devices!");
+  }
+  if (options_.scan_queue_capacity == 0) {
+    throw std::runtime_error("Mid360 scan queue needs room for a scan!");
+  }
+  worker_ = std::jthread(
+      [this](std::stop_token stop_token) { processPackets(stop_token); });
+}
+
+Mid360::~Mid360() {
+  worker_.request_stop();
+  packet_ready_.notify();
+}
 
 void Mid360::startSampling() {
   if (!LivoxLidarSdkStart()) {
@@ -53,24 +165,27 @@ void Mid360::setMode(Mode mode) {
                                        ? LivoxLidarWorkMode::kLivoxLidarNormal
                                        : LivoxLidarWorkMode::kLivoxLidarWakeUp;
 
-  std::promise<void> promise_complete;
-  const auto future = promise_complete.get_future();
-
-  SetLivoxLidarWorkMode(
-      connection_handle_, _mode,
-      [](livox_status status, uint32_t handle,
-         LivoxLidarAsyncControlResponse *response, void *client_data) {
-        printf("WorkModeCallback, status:%u, handle:%u, ret_code:%u, "
-               "error_key:%u\n",
-               status, handle, response->ret_code, response->error_key);
-        auto *promise = static_cast<std::promise<void> *>(client_data);
-        promise->set_value();
-      },
-      &promise_complete);
-
-  if (future.wait_for(std::chrono::milliseconds(1000)) ==
-      std::future_status::timeout) {
-    throw std::runtime_error("Unable to set mode!");
+  const size_t device_count = deviceCount();
+  for (size_t i = 0; i < device_count; ++i) {
+    std::promise<void> promise_complete;
+    const auto future = promise_complete.get_future();
+
+    SetLivoxLidarWorkMode(
+        devices_[i]->handle, _mode,
+        [](livox_status status, uint32_t handle,
+           LivoxLidarAsyncControlResponse *response, void *client_data) {
+          printf("WorkModeCallback, status:%u, handle:%u, ret_code:%u, "
+                 "error_key:%u\n",
+                 status, handle, response->ret_code, response->error_key);
+          auto *promise = static_cast<std::promise<void> *>(client_data);
+          promise->set_value();
+        },
+        &promise_complete);
+
+    if (future.wait_for(std::chrono::milliseconds(1000)) ==
+        std::future_status::timeout) {
+      throw std::runtime_error("Unable to set mode!");
+    }
   }
 };
 
@@ -84,24 +199,27 @@ void Mid360::setScanPattern(ScanPattern pattern) const {
     scan_pattern = kLivoxLidarScanPatternRepetiveLowFrameRate;
   }
 
-  std::promise<void> promise_complete;
-  const auto future = promise_complete.get_future();
-
-  SetLivoxLidarScanPattern(
-      connection_handle_, scan_pattern,
-      [](livox_status status, uint32_t handle,
-         LivoxLidarAsyncControlResponse *response, void *client_data) {
-        printf("SetLivoxLidarScanPattern, status:%u, handle:%u, ret_code:%u, "
-               "error_key:%u\n",
-               status, handle, response->ret_code, response->error_key);
-        auto *promise = static_cast<std::promise<void> *>(client_data);
-        promise->set_value();
-      },
-      &promise_complete);
-
-  if (future.wait_for(std::chrono::milliseconds(1000)) ==
-      std::future_status::timeout) {
-    throw std::runtime_error("Unable to set scan pattern!");
+  const size_t device_count = deviceCount();
+  for (size_t i = 0; i < device_count; ++i) {
+    std::promise<void> promise_complete;
+    const auto future = promise_complete.get_future();
+
+    SetLivoxLidarScanPattern(
+        devices_[i]->handle, scan_pattern,
+        [](livox_status status, uint32_t handle,
+           LivoxLidarAsyncControlResponse *response, void *client_data) {
+          printf("SetLivoxLidarScanPattern, status:%u, handle:%u, "
+                 "ret_code:%u, error_key:%u\n",
+                 status, handle, response->ret_code, response->error_key);
+          auto *promise = static_cast<std::promise<void> *>(client_data);
+          promise->set_value();
+        },
+        &promise_complete);
+
+    if (future.wait_for(std::chrono::milliseconds(1000)) ==
+        std::future_status::timeout) {
+      throw std::runtime_error("Unable to set scan pattern!");
+    }
   }
 }
 
@@ -113,33 +231,42 @@ void Mid360::init() {
     throw std::runtime_error("Unable to initialize Mid360!");
   }
 
-  std::promise<int> promise_complete;
-  auto future = promise_complete.get_future();
-
   SetLivoxLidarInfoChangeCallback(
       [](const uint32_t handle, const LivoxLidarInfo *info, void *client_data) {
         if (info == nullptr) {
           return;
         }
 
-        auto *this_ = reinterpret_cast<decltype(this)>(client_data);
+        auto *this_ = reinterpret_cast<Mid360 *>(client_data);
 
         std::cout << "Lidar IP: " << info->lidar_ip << std::endl;
         std::cout << "DevType: " << info->dev_type << std::endl;
         std::cout << "SN: " << info->sn << std::endl;
         std::cout << "handle: " << std::to_string(handle) << std::endl;
 
-        auto *promise = static_cast<std::promise<int> *>(client_data);
-        promise->set_value(handle);
+        this_->registerDevice(handle, info->lidar_ip);
       },
-      &promise_complete);
+      this);
 
-  if (future.wait_for(std::chrono::milliseconds(10000)) ==
-      std::future_status::timeout) {
+  using Clock = std::chrono::steady_clock;
+  const auto deadline = Clock::now() + g_device_wait_timeout;
+  const size_t expected = std::max<size_t>(options_.expected_devices, 1);
+  while (deviceCount() < expected) {
+    const auto remaining =
+        std::chrono::duration_cast<std::chrono::milliseconds>(deadline -
+                                                              Clock::now());
+    if (remaining.count() <= 0) {
+      break;
+    }
+    device_ready_.waitFor(remaining);
+  }
+  if (deviceCount() == 0) {
     throw std::runtime_error("Unable to get Lidar Info scan!");
   }
-  connection_handle_ = future.get();
-  std::cout << "connection_handle_: " << connection_handle_ << std::endl;
+  if (deviceCount() < expected) {
+    std::cout << "Only " << deviceCount() << " of " << expected
+              << " Mid360 devices connected." << std::endl;
+  }
 
   SetLivoxLidarImuDataCallback(
       [](const uint32_t handle, const uint8_t dev_type,
@@ -148,15 +275,32 @@ void Mid360::init() {
           return;
         }
 
-        static uint32_t sequence_number = 0;
-        auto *this_ = reinterpret_cast<decltype(this)>(client_data);
+        auto *this_ = reinterpret_cast<Mid360 *>(client_data);
+        // A single IMU stream: samples of the other devices are in their own
+        // frames and would interleave out of order.
+        Device *device = this_->findDevice(handle);
+        if (device == nullptr || device->index != 0) {
+          return;
+        }
         auto *data_ = reinterpret_cast<LivoxLidarImuRawPoint *>(data->data);
 
-        auto imu_data = IMUData(
-            {*reinterpret_cast<uint64_t *>(data->timestamp), sequence_number++},
-            data_->acc_x, data_->acc_y, data_->acc_z, data_->gyro_x,
-            data_->gyro_y, data_->gyro_z);
-        this_->imu_queue_.push(imu_data);
+        // As for packets: never lock or wait on the SDK thread.
+        IMUData *imu_data = this_->imu_ring_.writeSlot();
+        if (imu_data == nullptr) {
+          this_->imu_ring_dropped_.fetch_add(1, std::memory_order_relaxed);
+          return;
+        }
+        *imu_data = IMUData({*reinterpret_cast<uint64_t *>(data->timestamp),
+                             device->imu_sequence_number++},
+                            data_->acc_x, data_->acc_y, data_->acc_z,
+                            data_->gyro_x, data_->gyro_y, data_->gyro_z);
+        // Samples are not batched: received and converted at once.
+        imu_data->header.trace.driver_receive_ns = timing::traceNowNs();
+        imu_data->header.trace.conversion_done_ns =
+            imu_data->header.trace.driver_receive_ns;
+        if (this_->imu_ring_.commit() == 1) {
+          this_->packet_ready_.notify();
+        }
       },
       this);
 
@@ -166,46 +310,289 @@ void Mid360::init() {
         if (data == nullptr) {
           return;
         }
-        auto *this_ = reinterpret_cast<decltype(this)>(client_data);
-
-        static uint32_t sequence_number = 0;
-        if (!this_->accumulated_pointcloud_data_) {
-          this_->accumulated_pointcloud_data_ = std::make_shared<Scan3DI>();
-          this_->accumulated_pointcloud_data_->points->reserve(
-              this_->accumulate_scan_count_ * g_max_scan_points_per_packet);
-          this_->accumulated_pointcloud_data_->header =
-              Header{*reinterpret_cast<uint64_t *>(data->timestamp),
-                     sequence_number++};
+        auto *this_ = reinterpret_cast<Mid360 *>(client_data);
+        Device *device = this_->findDevice(handle);
+        if (device == nullptr) {
+          return;
         }
 
-        convertEthPacketInto(data, data->dot_num,
-                             *this_->accumulated_pointcloud_data_->points);
-
-        if (++this_->scan_count_ % this_->accumulate_scan_count_ == 0) {
-
-          this_->scan_queue_.push(this_->accumulated_pointcloud_data_);
-          this_->accumulated_pointcloud_data_.reset();
+        // Runs on the SDK receive thread: only copy the payload into the
+        // device's ring and leave conversion and accumulation to the worker.
+        device->packets_received.fetch_add(1, std::memory_order_relaxed);
+        RawPacket *packet = device->packet_ring.writeSlot();
+        if (packet == nullptr) {
+          device->packets_dropped.fetch_add(1, std::memory_order_relaxed);
+          return;
+        }
+        packet->received_ns = timing::traceNowNs();
+        std::memcpy(&packet->timestamp, data->timestamp,
+                    sizeof(packet->timestamp));
+        packet->time_interval = data->time_interval;
+        packet->dot_num = static_cast<uint16_t>(
+            std::min<size_t>(data->dot_num, g_max_scan_points_per_packet));
+        std::memcpy(packet->payload.data(), data->data,
+                    packet->dot_num * livox::g_cartesianHighPointSize);
+
+        const size_t depth = device->packet_ring.commit();
+        if (depth > device->ring_high_water.load(std::memory_order_relaxed)) {
+          device->ring_high_water.store(depth, std::memory_order_relaxed);
+        }
+        // The worker drains every ring before it sleeps: only a packet
+        // into an empty ring may find it asleep.
+        if (depth == 1) {
+          this_->packet_ready_.notify();
         }
       },
       this);
 }
 
-std::shared_ptr<Scan3DI> Mid360::getScan() {
-  if (scan_queue_.empty()) {
-    return nullptr;
+void Mid360::registerDevice(uint32_t handle, const std::string &ip) {
+  if (findDevice(handle) != nullptr) {
+    return;
+  }
+  const size_t index = device_count_.load(std::memory_order_relaxed);
+  if (index == g_mid360MaxDevices) {
+    std::cout << "Ignoring Mid360 " << ip << ": too many devices." << std::endl;
+    return;
+  }
+
+  auto device = std::make_unique<Device>(index, handle, ip);
+  if (const auto it = options_.extrinsics.find(ip);
+      it != options_.extrinsics.end()) {
+    device->has_extrinsic = true;
+    device->extrinsic = toMatrix(it->second);
+  }
+  devices_[index] = std::move(device);
+  device_count_.store(index + 1, std::memory_order_release);
+  device_ready_.notify();
+}
+
+Mid360::Device *Mid360::findDevice(uint32_t handle) const {
+  const size_t device_count = deviceCount();
+  for (size_t i = 0; i < device_count; ++i) {
+    if (devices_[i]->handle == handle) {
+      return devices_[i].get();
+    }
+  }
+  return nullptr;
+}
+
+size_t Mid360::deviceCount() const {
+  return device_count_.load(std::memory_order_acquire);
+}
+
+void Mid360::processPackets(std::stop_token stop_token) {
+  if (options_.worker_cpu >= 0) {
+    pinCurrentThread(options_.worker_cpu);
+  }
+
+  while (!stop_token.stop_requested()) {
+    size_t consumed = imu_ring_.consumeAll([this](const IMUData &imu_data) {
+      if (imu_queue_.push(imu_data)) {
+        imu_ready_.notify();
+      }
+    });
+    const size_t device_count = deviceCount();
+    for (size_t i = 0; i < device_count; ++i) {
+      Device &device = *devices_[i];
+      consumed += device.packet_ring.consumeAll(
+          [this, &device](const RawPacket &packet) {
+            accumulate(device, packet);
+          });
+    }
+    // Sleep only once every ring was found empty; see the SDK callback.
+    if (consumed == 0) {
+      packet_ready_.waitFor(g_worker_wait_timeout);
+    }
+  }
+}
+
+void Mid360::accumulate(Device &device, const RawPacket &packet) {
+  const auto &accumulation = options_.accumulation;
+  const uint64_t window_index = windowIndex(accumulation, packet.timestamp);
+
+  if (device.accumulated) {
+    const auto &scan = *device.accumulated;
+    const bool window_elapsed =
+        accumulation.window.count() > 0 && window_index != device.window_index;
+    const bool points_capped =
+        accumulation.max_points > 0 &&
+        scan.points->size() + packet.dot_num > accumulation.max_points;
+    if (window_elapsed || points_capped) {
+      emitScan(device, window_elapsed);
+    }
+  }
+
+  if (!device.accumulated) {
+    // Pooled scans keep their reserved capacity across reuse.
+    device.accumulated = scan_pool_.acquire();
+    clearScan(*device.accumulated);
+    device.accumulated->header =
+        Header{packet.timestamp, device.scan_sequence_number++};
+    device.accumulated->device_id = device.handle;
+    device.window_index = window_index;
+  }
+
+  auto &scan = *device.accumulated;
+  auto &points = *scan.points;
+  const size_t offset = points.size();
+  points.resize(offset + packet.dot_num);
+  livox::convertCartesianHigh(packet.payload.data(), packet.dot_num,
+                              &points[offset]);
+
+  if (device.has_extrinsic) {
+    const Eigen::Matrix3f rotation = device.extrinsic.topLeftCorner<3, 3>();
+    const Eigen::Vector3f translation = device.extrinsic.topRightCorner<3, 1>();
+    for (size_t i = offset; i < points.size(); ++i) {
+      Eigen::Map<Eigen::Vector3f> point(points[i].data);
+      point = rotation * point + translation;
+    }
   }
 
-  auto last = std::move(scan_queue_.front());
-  scan_queue_.pop();
-  return last;
+  // Points are evenly spread over the packet's time interval (0.1 us units).
+  // A packet stamped before the scan started (clock step, reordering) is
+  // clamped to its start rather than wrapping around.
+  const uint64_t packet_offset_ns =
+      packet.timestamp > scan.header.timestamp
+          ? packet.timestamp - scan.header.timestamp
+          : 0;
+  const uint64_t span_ns = uint64_t{packet.time_interval} * 100;
+  for (size_t i = 0; i < packet.dot_num; ++i) {
+    const uint64_t point_ns = packet_offset_ns + span_ns * i / packet.dot_num;
+    scan.time_offsets_us.push_back(static_cast<uint32_t>(point_ns / 1000));
+  }
+  scan.header.trace.driver_receive_ns = packet.received_ns;
+
+  ++device.packets_in_scan;
+  if (options_.output == Output::PerDevice && accumulation.packets > 0 &&
+      device.packets_in_scan >= accumulation.packets) {
+    emitScan(device, true);
+  }
 }
 
-std::optional<IMUData> Mid360::getImuData() {
-  if (imu_queue_.empty()) {
-    return std::nullopt;
+void Mid360::emitScan(Device &device, bool window_done) {
+  auto scan = std::move(device.accumulated);
+  device.packets_in_scan = 0;
+  if (options_.output == Output::Merged) {
+    merge(device, *scan, window_done);
+    return;
+  }
+  queueScan(std::move(scan));
+}
+
+void Mid360::merge(const Device &device, const Scan3DI &scan,
+                   bool window_done) {
+  // At most one merged scan per window, in window order: a device scan whose
+  // window was already emitted, or skipped, is dropped.
+  const uint64_t window_index = device.window_index;
+  const bool late = merged_ ? window_index < merged_window_
+                            : merged_sequence_number_ > 0 &&
+                                  window_index <= merged_window_;
+  if (late) {
+    late_scans_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  if (merged_ && window_index > merged_window_) {
+    emitMerged();
+  }
+
+  if (!merged_) {
+    merged_ = scan_pool_.acquire();
+    clearScan(*merged_);
+    merged_->header = Header{scan.header.timestamp, merged_sequence_number_++};
+    merged_window_ = window_index;
+    merged_devices_ = 0;
+  }
+
+  auto &merged = *merged_;
+  // Offsets are relative to the earliest contributing scan.
+  if (scan.header.timestamp < merged.header.timestamp) {
+    const auto shift_us = static_cast<uint32_t>(
+        (merged.header.timestamp - scan.header.timestamp) / 1000);
+    for (auto &offset : merged.time_offsets_us) {
+      offset += shift_us;
+    }
+    merged.header.timestamp = scan.header.timestamp;
+  }
+  const auto base_us = static_cast<uint32_t>(
+      (scan.header.timestamp - merged.header.timestamp) / 1000);
+
+  merged.points->insert(merged.points->end(), scan.points->begin(),
+                        scan.points->end());
+  for (const uint32_t offset : scan.time_offsets_us) {
+    merged.time_offsets_us.push_back(base_us + offset);
+  }
+
+  merged.header.trace.driver_receive_ns =
+      std::max(merged.header.trace.driver_receive_ns,
+               scan.header.trace.driver_receive_ns);
+
+  // A device capped by `max_points` sends more of the window later.
+  if (window_done) {
+    merged_devices_ |= 1U << device.index;
+  }
+  if (static_cast<size_t>(std::popcount(merged_devices_)) >= deviceCount()) {
+    emitMerged();
+  }
+}
+
+void Mid360::emitMerged() {
+  queueScan(std::move(merged_));
+  merged_devices_ = 0;
+}
+
+void Mid360::queueScan(std::shared_ptr<Scan3DI> scan) {
+  scan->header.trace.conversion_done_ns = timing::traceNowNs();
+  if (scan_queue_.push(std::move(scan))) {
+    scan_ready_.notify();
+  }
+}
+
+Mid360::PacketStats Mid360::packetStats() const {
+  PacketStats stats;
+  stats.ring_capacity = g_packet_ring_size;
+  stats.late_scans = late_scans_.load(std::memory_order_relaxed);
+  const size_t device_count = deviceCount();
+  for (size_t i = 0; i < device_count; ++i) {
+    const Device &device = *devices_[i];
+    stats.received += device.packets_received.load(std::memory_order_relaxed);
+    stats.dropped += device.packets_dropped.load(std::memory_order_relaxed);
+    stats.ring_high_water =
+        std::max(stats.ring_high_water,
+                 device.ring_high_water.load(std::memory_order_relaxed));
+  }
+  return stats;
+}
+
+QueueStats Mid360::scanQueueStats() const { return scan_queue_.stats(); }
+
+QueueStats Mid360::imuQueueStats() const {
+  // Samples lost in the SDK-side ring count as offered and dropped.
+  QueueStats stats = imu_queue_.stats();
+  const uint64_t ring_dropped =
+      imu_ring_dropped_.load(std::memory_order_relaxed);
+  stats.pushed += ring_dropped;
+  stats.dropped += ring_dropped;
+  return stats;
+}
+
+std::shared_ptr<Scan3DI> Mid360::getScan() {
+  return scan_queue_.pop().value_or(nullptr);
+}
+
+bool Mid360::waitForScan(std::chrono::milliseconds timeout) {
+  if (!scan_queue_.empty()) {
+    return true;
+  }
+  return scan_ready_.waitFor(timeout);
+}
+
+std::optional<IMUData> Mid360::getImuData() { return imu_queue_.pop(); }
+
+bool Mid360::waitForImuData(std::chrono::milliseconds timeout) {
+  if (!imu_queue_.empty()) {
+    return true;
   }
-  auto last = std::move(imu_queue_.front());
-  imu_queue_.pop();
-  return last;
+  return imu_ready_.waitFor(timeout);
 }
 } // namespace msensor
\ No newline at end of file
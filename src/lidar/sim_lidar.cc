@@ -6,9 +6,10 @@
 
 namespace msensor {
 
-SimLidar::SimLidar(bool steady) : steady_(steady) {
+SimLidar::SimLidar(bool steady, size_t points)
+    : steady_(steady), points_(points) {
   std::cout << "SimLidar initialized. steady=" << std::boolalpha << steady_
-            << std::endl;
+            << " points=" << points_ << std::endl;
 }
 
 void SimLidar::init() { std::cout << "init" << std::endl; }
@@ -18,7 +19,7 @@ void SimLidar::stopSampling() { std::cout << "stopSampling" << std::endl; }
 
 std::shared_ptr<Scan3DI> SimLidar::getScan() {
 
-  const int nr_points = 2000;
+  const int nr_points = static_cast<int>(points_);
   static uint32_t sequence_number = 0;
 
   std::random_device rd;
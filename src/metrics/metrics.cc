@@ -0,0 +1,255 @@
+#include "msensor/metrics/metrics.hh"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <sstream>
+#include <stdexcept>
+
+namespace msensor::metrics {
+namespace {
+
+std::atomic<size_t> g_nextShard{0};
+
+const char *typeName(Type type) {
+  switch (type) {
+  case Type::Counter:
+    return "counter";
+  case Type::Gauge:
+    return "gauge";
+  case Type::Histogram:
+    return "histogram";
+  }
+  return "untyped";
+}
+
+std::string escapeLabel(const std::string &value) {
+  std::string escaped;
+  escaped.reserve(value.size());
+  for (const char c : value) {
+    if (c == '\\' || c == '"') {
+      escaped += '\\';
+      escaped += c;
+    } else if (c == '\n') {
+      escaped += "\\n";
+    } else {
+      escaped += c;
+    }
+  }
+  return escaped;
+}
+
+/// `{a="1",b="2"}`, with `extra` appended (e.g. a histogram's `le`).
+std::string formatLabels(const Labels &labels, const std::string &extra = {}) {
+  if (labels.empty() && extra.empty()) {
+    return {};
+  }
+  std::string text = "{";
+  for (const auto &[key, value] : labels) {
+    if (text.size() > 1) {
+      text += ',';
+    }
+    text += key + "=\"" + escapeLabel(value) + '"';
+  }
+  if (!extra.empty()) {
+    if (text.size() > 1) {
+      text += ',';
+    }
+    text += extra;
+  }
+  return text + '}';
+}
+
+/// Shortest text that reads back as `value`, so counters print exactly.
+std::string formatValue(double value) {
+  std::array<char, 32> buffer;
+  const auto result =
+      std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+  return std::string(buffer.data(), result.ptr);
+}
+
+bool includes(const Labels &labels, const Labels &subset) {
+  return std::all_of(subset.begin(), subset.end(), [&](const auto &label) {
+    const auto it = labels.find(label.first);
+    return it != labels.end() && it->second == label.second;
+  });
+}
+} // namespace
+
+size_t threadShard() {
+  thread_local const size_t shard =
+      g_nextShard.fetch_add(1, std::memory_order_relaxed) % g_shards;
+  return shard;
+}
+
+uint64_t Counter::value() const {
+  uint64_t total = 0;
+  for (const auto &shard : shards_) {
+    total += shard.value.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+void Histogram::observe(uint64_t value) {
+  const size_t bucket = std::min<size_t>(
+      value == 0 ? 0 : std::bit_width(value - 1), g_histogramBuckets - 1);
+  auto &shard = shards_[threadShard()];
+  shard.counts[bucket].fetch_add(1, std::memory_order_relaxed);
+  shard.sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+Histogram::Snapshot Histogram::snapshot() const {
+  Snapshot snapshot;
+  for (const auto &shard : shards_) {
+    for (size_t i = 0; i < g_histogramBuckets; ++i) {
+      const uint64_t count = shard.counts[i].load(std::memory_order_relaxed);
+      snapshot.counts[i] += count;
+      snapshot.count += count;
+    }
+    snapshot.sum += shard.sum.load(std::memory_order_relaxed);
+  }
+  return snapshot;
+}
+
+Registry::Entry &Registry::findOrAdd(const std::string &name,
+                                     const std::string &help, Type type,
+                                     const Labels &labels) {
+  for (auto &entry : entries_) {
+    if (entry.name == name && entry.labels == labels) {
+      if (entry.type != type || entry.read) {
+        throw std::runtime_error("Metric '" + name +
+                                 "' registered with another type.");
+      }
+      return entry;
+    }
+  }
+  return entries_.emplace_back(
+      Entry{.name = name, .help = help, .type = type, .labels = labels});
+}
+
+std::shared_ptr<Counter> Registry::counter(const std::string &name,
+                                           const std::string &help,
+                                           const Labels &labels) {
+  std::scoped_lock lock(mutex_);
+  auto &entry = findOrAdd(name, help, Type::Counter, labels);
+  if (!entry.counter) {
+    entry.counter = std::make_shared<Counter>();
+  }
+  return entry.counter;
+}
+
+std::shared_ptr<Gauge> Registry::gauge(const std::string &name,
+                                       const std::string &help,
+                                       const Labels &labels) {
+  std::scoped_lock lock(mutex_);
+  auto &entry = findOrAdd(name, help, Type::Gauge, labels);
+  if (!entry.gauge) {
+    entry.gauge = std::make_shared<Gauge>();
+  }
+  return entry.gauge;
+}
+
+std::shared_ptr<Histogram> Registry::histogram(const std::string &name,
+                                               const std::string &help,
+                                               const Labels &labels) {
+  std::scoped_lock lock(mutex_);
+  auto &entry = findOrAdd(name, help, Type::Histogram, labels);
+  if (!entry.histogram) {
+    entry.histogram = std::make_shared<Histogram>();
+  }
+  return entry.histogram;
+}
+
+void Registry::callback(Type type, const std::string &name,
+                        const std::string &help, const Labels &labels,
+                        std::function<double()> read) {
+  if (type == Type::Histogram) {
+    throw std::runtime_error("Callback metrics cannot be histograms.");
+  }
+  std::scoped_lock lock(mutex_);
+  std::erase_if(entries_, [&](const Entry &entry) {
+    return entry.name == name && entry.labels == labels;
+  });
+  entries_.push_back(Entry{.name = name,
+                           .help = help,
+                           .type = type,
+                           .labels = labels,
+                           .read = std::move(read)});
+}
+
+void Registry::remove(const Labels &labels) {
+  std::scoped_lock lock(mutex_);
+  std::erase_if(entries_, [&](const Entry &entry) {
+    return includes(entry.labels, labels);
+  });
+}
+
+std::vector<Sample> Registry::collect() const {
+  // Read outside the lock: callbacks may be slow or take their own locks.
+  std::vector<Entry> entries;
+  {
+    std::scoped_lock lock(mutex_);
+    entries = entries_;
+  }
+  std::vector<Sample> samples;
+  samples.reserve(entries.size());
+  for (auto &entry : entries) {
+    Sample sample{.name = std::move(entry.name),
+                  .help = std::move(entry.help),
+                  .type = entry.type,
+                  .labels = std::move(entry.labels)};
+    if (entry.read) {
+      sample.value = entry.read();
+    } else if (entry.counter) {
+      sample.value = static_cast<double>(entry.counter->value());
+    } else if (entry.gauge) {
+      sample.value = static_cast<double>(entry.gauge->value());
+    } else if (entry.histogram) {
+      sample.histogram = entry.histogram->snapshot();
+    }
+    samples.push_back(std::move(sample));
+  }
+  std::stable_sort(samples.begin(), samples.end(),
+                   [](const Sample &a, const Sample &b) {
+                     return a.name < b.name;
+                   });
+  return samples;
+}
+
+std::string Registry::prometheusText() const {
+  std::ostringstream text;
+  const std::string *family = nullptr;
+  const auto samples = collect();
+  for (const auto &sample : samples) {
+    if (!family || *family != sample.name) {
+      family = &sample.name;
+      text << "# HELP " << sample.name << ' ' << sample.help << '\n'
+           << "# TYPE " << sample.name << ' ' << typeName(sample.type) << '\n';
+    }
+
+    if (!sample.histogram) {
+      text << sample.name << formatLabels(sample.labels) << ' '
+           << formatValue(sample.value) << '\n';
+      continue;
+    }
+
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < g_histogramBuckets; ++i) {
+      cumulative += sample.histogram->counts[i];
+      const std::string le =
+          i + 1 == g_histogramBuckets
+              ? std::string("+Inf")
+              : std::to_string(Histogram::upperBound(i));
+      text << sample.name << "_bucket"
+           << formatLabels(sample.labels, "le=\"" + le + '"') << ' '
+           << cumulative << '\n';
+    }
+    text << sample.name << "_sum" << formatLabels(sample.labels) << ' '
+         << sample.histogram->sum << '\n'
+         << sample.name << "_count" << formatLabels(sample.labels) << ' '
+         << sample.histogram->count << '\n';
+  }
+  return text.str();
+}
+
+} // namespace msensor::metrics
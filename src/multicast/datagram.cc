@@ -0,0 +1,165 @@
+#include "msensor/multicast/datagram.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace msensor {
+namespace {
+
+constexpr uint32_t g_datagramMagic = 0x6d734d43; // "msMC"
+/// Bumped on any change of the header or of the records.
+constexpr uint16_t g_datagramVersion = 2;
+
+/// True if sequence `a` is after `b`, across wrap-around.
+bool after(uint32_t a, uint32_t b) { return static_cast<int32_t>(a - b) > 0; }
+
+/// Fragments a message splits into: at least one, even if empty.
+size_t expectedFragments(const DatagramHeader &header) {
+  const size_t message_bytes = header.message_bytes;
+  return std::max<size_t>(
+      (message_bytes + header.fragment_bytes - 1) / header.fragment_bytes, 1);
+}
+
+} // namespace
+
+Fragmenter::Fragmenter(MulticastStream stream, uint32_t session,
+                       size_t datagram_bytes)
+    : next_{} {
+  if (datagram_bytes <= sizeof(DatagramHeader)) {
+    throw std::runtime_error("Datagrams too small for their header");
+  }
+  payload_bytes_ = datagram_bytes - sizeof(DatagramHeader);
+  next_.magic = g_datagramMagic;
+  next_.version = g_datagramVersion;
+  next_.stream = static_cast<uint8_t>(stream);
+  next_.session = session;
+}
+
+std::span<const DatagramHeader> Fragmenter::fragment(size_t message_bytes) {
+  const size_t fragments =
+      std::max<size_t>((message_bytes + payload_bytes_ - 1) / payload_bytes_,
+                       1);
+  if (fragments > std::numeric_limits<uint16_t>::max() ||
+      message_bytes > std::numeric_limits<uint32_t>::max()) {
+    throw std::runtime_error("Message too large to fragment");
+  }
+  headers_.resize(fragments);
+  for (size_t i = 0; i < fragments; ++i) {
+    DatagramHeader &header = headers_[i];
+    header = next_;
+    header.message_bytes = static_cast<uint32_t>(message_bytes);
+    header.fragment_bytes = static_cast<uint32_t>(payload_bytes_);
+    header.fragment = static_cast<uint16_t>(i);
+    header.fragments = static_cast<uint16_t>(fragments);
+  }
+  ++next_.sequence;
+  return headers_;
+}
+
+Reassembler::Reassembler(size_t window, size_t max_message_bytes)
+    : window_(std::max<size_t>(window, 1)),
+      max_message_bytes_(max_message_bytes) {}
+
+std::optional<Reassembler::Message>
+Reassembler::add(std::span<const std::byte> datagram) {
+  DatagramHeader header;
+  if (datagram.size() < sizeof(header)) {
+    return std::nullopt;
+  }
+  std::memcpy(&header, datagram.data(), sizeof(header));
+  if (header.magic != g_datagramMagic ||
+      header.version != g_datagramVersion ||
+      header.stream >= g_multicastStreams) {
+    return std::nullopt; // not ours: not attributable to a stream
+  }
+  Stream &stream = streams_[header.stream];
+  ++stream.stats.datagrams;
+
+  const auto payload = datagram.subspan(sizeof(header));
+  if (header.fragment_bytes == 0 ||
+      header.message_bytes > max_message_bytes_ ||
+      header.fragments != expectedFragments(header) ||
+      header.fragment >= header.fragments ||
+      payload.size() != fragmentPayloadBytes(header)) {
+    ++stream.stats.invalid;
+    return std::nullopt;
+  }
+
+  if (!stream.started || header.session != stream.session) {
+    if (stream.started) {
+      ++stream.stats.restarts;
+    }
+    stream.started = true;
+    stream.session = header.session;
+    stream.first = header.sequence;
+    stream.newest = header.sequence - 1;
+    stream.slots.assign(window_, Slot{});
+  }
+  if (after(header.sequence, stream.newest)) {
+    advance(stream, header.sequence);
+  } else if (stream.newest - header.sequence >= window_) {
+    ++stream.stats.late;
+    return std::nullopt;
+  }
+
+  Slot &slot = stream.slots[header.sequence % window_];
+  if (!slot.used || slot.sequence != header.sequence) {
+    slot.used = true;
+    slot.complete = false;
+    slot.sequence = header.sequence;
+    slot.received = 0;
+    slot.fragment_bytes = header.fragment_bytes;
+    slot.received_bytes = 0;
+    slot.have.assign(header.fragments, 0);
+    slot.bytes.resize(header.message_bytes);
+  }
+  if (slot.complete || slot.fragment_bytes != header.fragment_bytes ||
+      slot.bytes.size() != header.message_bytes ||
+      slot.have[header.fragment]) {
+    ++stream.stats.invalid;
+    return std::nullopt;
+  }
+  slot.have[header.fragment] = 1;
+  std::memcpy(slot.bytes.data() + fragmentOffset(header), payload.data(),
+              payload.size());
+  ++slot.received;
+  slot.received_bytes += payload.size();
+  if (slot.received_bytes < slot.bytes.size() ||
+      slot.received < slot.have.size()) {
+    return std::nullopt;
+  }
+  slot.complete = true;
+  ++stream.stats.messages;
+  return Message{static_cast<MulticastStream>(header.stream),
+                 header.sequence, slot.bytes};
+}
+
+void Reassembler::advance(Stream &stream, uint32_t sequence) {
+  // Messages leaving the window, oldest first. Those up to `newest` have a
+  // slot; those after it never got a fragment.
+  const uint32_t leaving = sequence - stream.newest;
+  const auto window = static_cast<uint32_t>(window_);
+  for (uint32_t i = 0; i < std::min(leaving, window); ++i) {
+    const uint32_t old = stream.newest - window + 1 + i;
+    if (after(stream.first, old)) {
+      continue; // before the session
+    }
+    Slot &slot = stream.slots[old % window_];
+    if (!(slot.used && slot.sequence == old && slot.complete)) {
+      ++stream.stats.lost;
+    }
+    slot.used = false;
+  }
+  if (leaving > window) {
+    stream.stats.lost += leaving - window;
+  }
+  stream.newest = sequence;
+  // Trail the window, so that comparisons with it never wrap around.
+  if (after(sequence - window + 1, stream.first)) {
+    stream.first = sequence - window + 1;
+  }
+}
+
+} // namespace msensor
@@ -0,0 +1,138 @@
+#include "msensor/multicast/multicast_publisher.hh"
+#include "msensor/shm/shm_records.hh"
+
+#include <arpa/inet.h>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace msensor {
+namespace {
+
+/// Datagrams handed to the kernel per `sendmmsg` call.
+constexpr size_t g_sendBatch = 64;
+/// Room for a few scans in flight, so bursts of fragments are not dropped.
+constexpr int g_sendBufferBytes = 8 * 1024 * 1024;
+
+uint32_t randomSession() { return std::random_device{}(); }
+
+} // namespace
+
+MulticastPublisher::MulticastPublisher(const Options &options,
+                                       std::shared_ptr<ScanHub> scans,
+                                       std::shared_ptr<ImuHub> imu)
+    : scan_fragmenter_(MulticastStream::Lidar, randomSession(),
+                       options.datagram_bytes),
+      imu_fragmenter_(MulticastStream::Imu, randomSession(),
+                      options.datagram_bytes) {
+  group_.sin_family = AF_INET;
+  group_.sin_port = htons(options.port);
+  if (inet_pton(AF_INET, options.group.c_str(), &group_.sin_addr) != 1) {
+    throw std::runtime_error("Invalid multicast group " + options.group);
+  }
+  in_addr interface{htonl(INADDR_ANY)};
+  if (!options.interface.empty() &&
+      inet_pton(AF_INET, options.interface.c_str(), &interface) != 1) {
+    throw std::runtime_error("Invalid interface address " +
+                             options.interface);
+  }
+
+  socket_ = socket(AF_INET, SOCK_DGRAM, 0);
+  if (socket_ < 0) {
+    throw std::runtime_error(std::string("Unable to open UDP socket: ") +
+                             std::strerror(errno));
+  }
+  const unsigned char ttl = static_cast<unsigned char>(options.ttl);
+  // Also deliver to receivers on this host.
+  const unsigned char loop = 1;
+  if (setsockopt(socket_, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl)) ||
+      setsockopt(socket_, IPPROTO_IP, IP_MULTICAST_LOOP, &loop,
+                 sizeof(loop)) ||
+      setsockopt(socket_, IPPROTO_IP, IP_MULTICAST_IF, &interface,
+                 sizeof(interface))) {
+    const std::string error = std::strerror(errno);
+    close(socket_);
+    throw std::runtime_error("Unable to configure multicast socket: " +
+                             error);
+  }
+  // Best effort: capped by net.core.wmem_max.
+  setsockopt(socket_, SOL_SOCKET, SO_SNDBUF, &g_sendBufferBytes,
+             sizeof(g_sendBufferBytes));
+
+  if (scans) {
+    attach(scans, [this](const auto &scan) {
+      scan_record_.resize(shmScanBytes(*scan));
+      writeScanRecord(*scan, scan_record_.data());
+      send(scan_fragmenter_, scan_record_);
+    });
+  }
+  if (imu) {
+    attach(imu, [this](const IMUData &sample) {
+      send(imu_fragmenter_, std::as_bytes(std::span(&sample, 1)));
+    });
+  }
+  std::cout << "Publishing to multicast group " << options.group << ":"
+            << options.port << std::endl;
+}
+
+MulticastPublisher::~MulticastPublisher() {
+  // Waits for a listener running on a producer thread to return.
+  for (const auto &detach : detach_) {
+    detach();
+  }
+  close(socket_);
+}
+
+template <typename Hub, typename Send>
+void MulticastPublisher::attach(const std::shared_ptr<Hub> &hub, Send send) {
+  // Listeners of one hub all run on its producer thread.
+  auto cursor = std::make_shared<typename Hub::Cursor>(hub->subscribe());
+  const uint64_t id = hub->addListener([hub = hub.get(), cursor, send] {
+    while (auto item = hub->read(*cursor)) {
+      send(*item);
+    }
+  });
+  detach_.push_back([hub, id] { hub->removeListener(id); });
+}
+
+void MulticastPublisher::send(Fragmenter &fragmenter,
+                              std::span<const std::byte> message) {
+  const auto headers = fragmenter.fragment(message.size());
+  std::array<std::array<iovec, 2>, g_sendBatch> parts;
+  std::array<mmsghdr, g_sendBatch> datagrams;
+
+  for (size_t sent = 0; sent < headers.size();) {
+    const size_t batch = std::min(g_sendBatch, headers.size() - sent);
+    for (size_t i = 0; i < batch; ++i) {
+      const DatagramHeader &header = headers[sent + i];
+      // The header, then the fragment, straight from the message.
+      parts[i][0] = {const_cast<DatagramHeader *>(&header), sizeof(header)};
+      parts[i][1] = {
+          const_cast<std::byte *>(message.data() + fragmentOffset(header)),
+          fragmentPayloadBytes(header)};
+      datagrams[i] = {};
+      datagrams[i].msg_hdr.msg_name = &group_;
+      datagrams[i].msg_hdr.msg_namelen = sizeof(group_);
+      datagrams[i].msg_hdr.msg_iov = parts[i].data();
+      datagrams[i].msg_hdr.msg_iovlen = parts[i].size();
+    }
+    // Never blocks the producer thread: a full send buffer fails with
+    // EAGAIN instead.
+    const int result = sendmmsg(socket_, datagrams.data(),
+                                static_cast<unsigned>(batch), MSG_DONTWAIT);
+    if (result <= 0) {
+      // Give up on the rest of the message: receivers count it as lost.
+      send_errors_.fetch_add(headers.size() - sent,
+                             std::memory_order_relaxed);
+      return;
+    }
+    sent += static_cast<size_t>(result);
+  }
+}
+
+} // namespace msensor
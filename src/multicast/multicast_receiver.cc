@@ -0,0 +1,155 @@
+#include "msensor/multicast/multicast_receiver.hh"
+#include "msensor/shm/shm_records.hh"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+namespace msensor {
+namespace {
+
+constexpr size_t g_maxLidarSamples = 100;
+constexpr size_t g_maxImuSamples = 200;
+/// Largest UDP payload.
+constexpr size_t g_maxDatagramBytes = 65507;
+/// Room for a few scans of fragments while the receive thread is busy.
+constexpr int g_receiveBufferBytes = 8 * 1024 * 1024;
+/// Period at which the receive thread checks for a stop request.
+constexpr timeval g_receiveTimeout{0, 100000};
+
+in_addr parseAddress(const std::string &address, const char *what) {
+  in_addr parsed{htonl(INADDR_ANY)};
+  if (!address.empty() &&
+      inet_pton(AF_INET, address.c_str(), &parsed) != 1) {
+    throw std::runtime_error(std::string("Invalid ") + what + " " + address);
+  }
+  return parsed;
+}
+
+} // namespace
+
+MulticastReceiver::MulticastReceiver(const Options &options)
+    : reassembler_(options.window),
+      scan_queue_(g_maxLidarSamples, Overflow::DropOldest, {},
+                  "Multicast scan queue"),
+      imu_queue_(g_maxImuSamples, Overflow::DropOldest, {},
+                 "Multicast IMU queue") {
+  ip_mreq membership{};
+  membership.imr_multiaddr = parseAddress(options.group, "multicast group");
+  membership.imr_interface = parseAddress(options.interface, "interface");
+  sockaddr_in local{};
+  local.sin_family = AF_INET;
+  local.sin_port = htons(options.port);
+  // Bound to the group, so that only its datagrams are received.
+  local.sin_addr = membership.imr_multiaddr;
+
+  socket_ = socket(AF_INET, SOCK_DGRAM, 0);
+  if (socket_ < 0) {
+    throw std::runtime_error(std::string("Unable to open UDP socket: ") +
+                             std::strerror(errno));
+  }
+  // Several receivers may run on one host.
+  const int reuse = 1;
+  if (setsockopt(socket_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) ||
+      setsockopt(socket_, SOL_SOCKET, SO_RCVTIMEO, &g_receiveTimeout,
+                 sizeof(g_receiveTimeout)) ||
+      bind(socket_, reinterpret_cast<const sockaddr *>(&local),
+           sizeof(local)) ||
+      setsockopt(socket_, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership,
+                 sizeof(membership))) {
+    const std::string error = std::strerror(errno);
+    close(socket_);
+    throw std::runtime_error("Unable to join multicast group " +
+                             options.group + ": " + error);
+  }
+  // Best effort: capped by net.core.rmem_max.
+  setsockopt(socket_, SOL_SOCKET, SO_RCVBUF, &g_receiveBufferBytes,
+             sizeof(g_receiveBufferBytes));
+}
+
+MulticastReceiver::~MulticastReceiver() {
+  stop();
+  close(socket_);
+}
+
+void MulticastReceiver::start() {
+  if (!receiver_.joinable()) {
+    receiver_ = std::jthread(
+        [this](std::stop_token stop_token) { receive(stop_token); });
+  }
+}
+
+void MulticastReceiver::stop() {
+  if (receiver_.joinable()) {
+    receiver_.request_stop();
+    receiver_.join();
+  }
+}
+
+std::shared_ptr<Scan3DI> MulticastReceiver::getScan() {
+  return scan_queue_.pop().value_or(nullptr);
+}
+
+bool MulticastReceiver::waitForScan(std::chrono::milliseconds timeout) {
+  if (!scan_queue_.empty()) {
+    return true;
+  }
+  return scan_ready_.waitFor(timeout);
+}
+
+std::optional<IMUData> MulticastReceiver::getImuData() {
+  return imu_queue_.pop();
+}
+
+bool MulticastReceiver::waitForImuData(std::chrono::milliseconds timeout) {
+  if (!imu_queue_.empty()) {
+    return true;
+  }
+  return imu_ready_.waitFor(timeout);
+}
+
+Reassembler::Stats MulticastReceiver::stats(MulticastStream stream) const {
+  std::scoped_lock lock(mutex_);
+  return reassembler_.stats(stream);
+}
+
+void MulticastReceiver::receive(std::stop_token stop_token) {
+  std::vector<std::byte> datagram(g_maxDatagramBytes);
+  while (!stop_token.stop_requested()) {
+    const ssize_t size = recv(socket_, datagram.data(), datagram.size(), 0);
+    if (size < 0) {
+      continue; // timeout: check for a stop request
+    }
+    std::optional<Reassembler::Message> message;
+    {
+      std::scoped_lock lock(mutex_);
+      message = reassembler_.add(
+          std::span(datagram.data(), static_cast<size_t>(size)));
+    }
+    // The message stays valid: only this thread adds datagrams.
+    if (!message) {
+      continue;
+    }
+    const auto &bytes = message->bytes;
+    if (message->stream == MulticastStream::Lidar) {
+      auto scan = std::make_shared<Scan3DI>();
+      if (readScanRecord(bytes.data(), bytes.size(), *scan) &&
+          scan_queue_.push(std::move(scan))) {
+        scan_ready_.notify();
+      }
+    } else if (bytes.size() == sizeof(IMUData)) {
+      IMUData sample;
+      std::memcpy(&sample, bytes.data(), sizeof(sample));
+      if (imu_queue_.push(sample)) {
+        imu_ready_.notify();
+      }
+    }
+  }
+}
+
+} // namespace msensor
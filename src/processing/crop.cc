@@ -0,0 +1,229 @@
+#include "msensor/processing/crop.hh"
+
+#include <bit>
+#include <cmath>
+#include <numbers>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace msensor {
+namespace {
+
+static_assert(sizeof(Point3I) == 8 * sizeof(float),
+              "unexpected PCL PointXYZI layout");
+
+constexpr float g_twoPi = 2.0F * std::numbers::pi_v<float>;
+
+/// `CropRegion` in the form the kernels test: squared ranges, and the
+/// sector as the unit vectors of its edges.
+struct Bounds {
+  explicit Bounds(const CropRegion &region)
+      : min(region.box_min), max(region.box_max),
+        min_range2(region.min_range > 0.0F
+                       ? region.min_range * region.min_range
+                       : 0.0F),
+        max_range2(region.max_range * region.max_range),
+        min_intensity(region.min_intensity) {
+    float span = std::fmod(region.azimuth_max - region.azimuth_min, g_twoPi);
+    if (span < 0.0F) {
+      span += g_twoPi;
+    }
+    sector = span > 0.0F;
+    wide = span > std::numbers::pi_v<float>;
+    start_x = std::cos(region.azimuth_min);
+    start_y = std::sin(region.azimuth_min);
+    end_x = std::cos(region.azimuth_max);
+    end_y = std::sin(region.azimuth_max);
+  }
+
+  std::array<float, 3> min;
+  std::array<float, 3> max;
+  float min_range2;
+  float max_range2;
+  float min_intensity;
+  bool sector;
+  bool wide; ///< Sector over half a turn: kept unless inside the rest.
+  float start_x;
+  float start_y;
+  float end_x;
+  float end_y;
+};
+
+// A point is counter-clockwise of the sector start if cross(start, p) >= 0,
+// and clockwise of its end if cross(p, end) >= 0. A sector up to half a turn
+// needs both; a wider one either. Comparisons are written so that NaN fails.
+bool keep(const Bounds &b, const Point3I &p) {
+  if (!(p.x >= b.min[0] && p.x <= b.max[0] && p.y >= b.min[1] &&
+        p.y <= b.max[1] && p.z >= b.min[2] && p.z <= b.max[2])) {
+    return false;
+  }
+  const float range2 = p.x * p.x + p.y * p.y + p.z * p.z;
+  if (!(range2 >= b.min_range2 && range2 <= b.max_range2 &&
+        p.intensity >= b.min_intensity)) {
+    return false;
+  }
+  if (!b.sector) {
+    return true;
+  }
+  const bool after_start = b.start_x * p.y - b.start_y * p.x >= 0.0F;
+  const bool before_end = p.x * b.end_y - p.y * b.end_x >= 0.0F;
+  return b.wide ? after_start || before_end : after_start && before_end;
+}
+
+#if defined(__SSE2__)
+/// Bit k set if point k of the four at `points` is kept.
+class Sse2Bounds {
+public:
+  explicit Sse2Bounds(const Bounds &b)
+      : min_x_(_mm_set1_ps(b.min[0])), min_y_(_mm_set1_ps(b.min[1])),
+        min_z_(_mm_set1_ps(b.min[2])), max_x_(_mm_set1_ps(b.max[0])),
+        max_y_(_mm_set1_ps(b.max[1])), max_z_(_mm_set1_ps(b.max[2])),
+        min_range2_(_mm_set1_ps(b.min_range2)),
+        max_range2_(_mm_set1_ps(b.max_range2)),
+        min_intensity_(_mm_set1_ps(b.min_intensity)),
+        start_x_(_mm_set1_ps(b.start_x)), start_y_(_mm_set1_ps(b.start_y)),
+        end_x_(_mm_set1_ps(b.end_x)), end_y_(_mm_set1_ps(b.end_y)),
+        sector_(b.sector), wide_(b.wide) {}
+
+  unsigned mask(const Point3I *points) const {
+    const auto *p = reinterpret_cast<const float *>(points);
+    __m128 x = _mm_loadu_ps(p);
+    __m128 y = _mm_loadu_ps(p + 8);
+    __m128 z = _mm_loadu_ps(p + 16);
+    __m128 w = _mm_loadu_ps(p + 24);
+    _MM_TRANSPOSE4_PS(x, y, z, w);
+    const __m128 i01 =
+        _mm_unpacklo_ps(_mm_loadu_ps(p + 4), _mm_loadu_ps(p + 12));
+    const __m128 i23 =
+        _mm_unpacklo_ps(_mm_loadu_ps(p + 20), _mm_loadu_ps(p + 28));
+    const __m128 intensity = _mm_movelh_ps(i01, i23);
+
+    __m128 keep = _mm_and_ps(_mm_cmpge_ps(x, min_x_), _mm_cmple_ps(x, max_x_));
+    keep = _mm_and_ps(keep, _mm_cmpge_ps(y, min_y_));
+    keep = _mm_and_ps(keep, _mm_cmple_ps(y, max_y_));
+    keep = _mm_and_ps(keep, _mm_cmpge_ps(z, min_z_));
+    keep = _mm_and_ps(keep, _mm_cmple_ps(z, max_z_));
+    const __m128 range2 = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+    keep = _mm_and_ps(keep, _mm_cmpge_ps(range2, min_range2_));
+    keep = _mm_and_ps(keep, _mm_cmple_ps(range2, max_range2_));
+    keep = _mm_and_ps(keep, _mm_cmpge_ps(intensity, min_intensity_));
+    if (sector_) {
+      const __m128 zero = _mm_setzero_ps();
+      const __m128 after_start = _mm_cmpge_ps(
+          _mm_sub_ps(_mm_mul_ps(start_x_, y), _mm_mul_ps(start_y_, x)), zero);
+      const __m128 before_end = _mm_cmpge_ps(
+          _mm_sub_ps(_mm_mul_ps(x, end_y_), _mm_mul_ps(y, end_x_)), zero);
+      keep = _mm_and_ps(keep, wide_ ? _mm_or_ps(after_start, before_end)
+                                    : _mm_and_ps(after_start, before_end));
+    }
+    return static_cast<unsigned>(_mm_movemask_ps(keep));
+  }
+
+private:
+  __m128 min_x_, min_y_, min_z_, max_x_, max_y_, max_z_;
+  __m128 min_range2_, max_range2_, min_intensity_;
+  __m128 start_x_, start_y_, end_x_, end_y_;
+  bool sector_;
+  bool wide_;
+};
+using VectorBounds = Sse2Bounds;
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+/// Bit k set if point k of the four at `points` is kept.
+class NeonBounds {
+public:
+  explicit NeonBounds(const Bounds &b) : b_(b) {}
+
+  unsigned mask(const Point3I *points) const {
+    const auto *p = reinterpret_cast<const float *>(points);
+    // Stride-4 loads: lane pairs hold (x, intensity), (y, pad), (z, pad).
+    const float32x4x4_t a = vld4q_f32(p);
+    const float32x4x4_t c = vld4q_f32(p + 16);
+    const float32x4_t x = vuzp1q_f32(a.val[0], c.val[0]);
+    const float32x4_t y = vuzp1q_f32(a.val[1], c.val[1]);
+    const float32x4_t z = vuzp1q_f32(a.val[2], c.val[2]);
+    const float32x4_t intensity = vuzp2q_f32(a.val[0], c.val[0]);
+
+    uint32x4_t keep = vandq_u32(vcgeq_f32(x, vdupq_n_f32(b_.min[0])),
+                                vcleq_f32(x, vdupq_n_f32(b_.max[0])));
+    keep = vandq_u32(keep, vcgeq_f32(y, vdupq_n_f32(b_.min[1])));
+    keep = vandq_u32(keep, vcleq_f32(y, vdupq_n_f32(b_.max[1])));
+    keep = vandq_u32(keep, vcgeq_f32(z, vdupq_n_f32(b_.min[2])));
+    keep = vandq_u32(keep, vcleq_f32(z, vdupq_n_f32(b_.max[2])));
+    const float32x4_t range2 =
+        vmlaq_f32(vmlaq_f32(vmulq_f32(x, x), y, y), z, z);
+    keep = vandq_u32(keep, vcgeq_f32(range2, vdupq_n_f32(b_.min_range2)));
+    keep = vandq_u32(keep, vcleq_f32(range2, vdupq_n_f32(b_.max_range2)));
+    keep = vandq_u32(keep,
+                     vcgeq_f32(intensity, vdupq_n_f32(b_.min_intensity)));
+    if (b_.sector) {
+      const uint32x4_t after_start =
+          vcgezq_f32(vsubq_f32(vmulq_n_f32(y, b_.start_x),
+                               vmulq_n_f32(x, b_.start_y)));
+      const uint32x4_t before_end = vcgezq_f32(
+          vsubq_f32(vmulq_n_f32(x, b_.end_y), vmulq_n_f32(y, b_.end_x)));
+      keep = vandq_u32(keep, b_.wide ? vorrq_u32(after_start, before_end)
+                                     : vandq_u32(after_start, before_end));
+    }
+    // One bit per lane, as _mm_movemask_ps.
+    const uint32x4_t bits = {1, 2, 4, 8};
+    return vaddvq_u32(vandq_u32(keep, bits));
+  }
+
+private:
+  const Bounds &b_;
+};
+using VectorBounds = NeonBounds;
+#endif
+
+} // namespace
+
+void crop(const Scan3DI &input, const CropRegion &region, Scan3DI &output) {
+  const auto &points = *input.points;
+  auto &kept_points = *output.points;
+  const size_t size = points.size();
+  const bool offsets = input.time_offsets_us.size() == size;
+  kept_points.resize(size);
+  output.time_offsets_us.resize(offsets ? size : 0);
+
+  size_t kept = 0;
+  const auto emit = [&](size_t i) {
+    kept_points[kept] = points[i];
+    if (offsets) {
+      output.time_offsets_us[kept] = input.time_offsets_us[i];
+    }
+    ++kept;
+  };
+
+  const Bounds bounds(region);
+  size_t i = 0;
+#if defined(__SSE2__) || (defined(__ARM_NEON) && defined(__aarch64__))
+  const VectorBounds vector_bounds(bounds);
+  for (; i + 4 <= size; i += 4) {
+    for (unsigned mask = vector_bounds.mask(&points[i]); mask != 0;
+         mask &= mask - 1) {
+      emit(i + std::countr_zero(mask));
+    }
+  }
+#endif
+  for (; i < size; ++i) {
+    if (keep(bounds, points[i])) {
+      emit(i);
+    }
+  }
+
+  kept_points.resize(kept);
+  output.time_offsets_us.resize(offsets ? kept : 0);
+  kept_points.header = points.header;
+  kept_points.width = static_cast<uint32_t>(kept);
+  kept_points.height = 1;
+  kept_points.is_dense = points.is_dense;
+  output.header = input.header;
+  output.device_id = input.device_id;
+}
+
+} // namespace msensor
@@ -0,0 +1,123 @@
+#include "msensor/processing/deskew.hh"
+
+#include <Eigen/Geometry>
+#include <algorithm>
+#include <vector>
+
+namespace msensor {
+
+namespace {
+
+/// Rotations below this angle (rad) are treated as identity.
+constexpr float g_minRotationAngle = 1e-9F;
+
+uint64_t scanEndTime(const Scan3DI &scan) {
+  const auto max_offset = std::max_element(scan.time_offsets_us.begin(),
+                                           scan.time_offsets_us.end());
+  return scan.header.timestamp + uint64_t{*max_offset} * 1000;
+}
+
+Eigen::Quaternionf rotationFromRate(const IMUData &imu, uint64_t dt_ns) {
+  const Eigen::Vector3f rate(imu.gx, imu.gy, imu.gz);
+  const float angle = rate.norm() * static_cast<float>(dt_ns) * 1e-9F;
+  if (angle < g_minRotationAngle) {
+    return Eigen::Quaternionf::Identity();
+  }
+  return Eigen::Quaternionf(Eigen::AngleAxisf(angle, rate.normalized()));
+}
+
+} // namespace
+
+ImuDeskewer::ImuDeskewer(size_t imu_capacity) : imu_capacity_(imu_capacity) {}
+
+void ImuDeskewer::addImu(const IMUData &imu) {
+  imu_.push_back(imu);
+  while (imu_.size() > imu_capacity_) {
+    imu_.pop_front();
+  }
+}
+
+bool ImuDeskewer::covers(const Scan3DI &scan) const {
+  if (imu_.empty() || scan.time_offsets_us.empty()) {
+    return false;
+  }
+  return imu_.back().header.timestamp >= scanEndTime(scan);
+}
+
+bool ImuDeskewer::deskew(const Scan3DI &scan, Scan3DI &out) const {
+  const auto &points = *scan.points;
+  if (points.empty() || scan.time_offsets_us.size() != points.size() ||
+      !covers(scan)) {
+    return false;
+  }
+
+  const uint64_t start = scan.header.timestamp;
+  const uint64_t end = scanEndTime(scan);
+
+  // Knots at the scan start, at every IMU sample inside the scan and at the
+  // scan end. Each segment rotates at the rate of the latest sample at or
+  // before its start (the first sample if the scan starts before it).
+  std::vector<uint64_t> knot_times{start};
+  std::vector<Eigen::Quaternionf> knot_rotations{
+      Eigen::Quaternionf::Identity()};
+  auto sample = std::upper_bound(
+      imu_.begin(), imu_.end(), start, [](uint64_t time, const IMUData &imu) {
+        return time < imu.header.timestamp;
+      });
+  auto rate = sample == imu_.begin() ? sample : std::prev(sample);
+  while (knot_times.back() < end) {
+    const uint64_t next =
+        sample != imu_.end() ? std::min(sample->header.timestamp, end) : end;
+    knot_rotations.push_back(
+        (knot_rotations.back() *
+         rotationFromRate(*rate, next - knot_times.back()))
+            .normalized());
+    knot_times.push_back(next);
+    if (sample != imu_.end() && sample->header.timestamp <= next) {
+      rate = sample++;
+    }
+  }
+
+  // Rotations into the end frame.
+  const Eigen::Quaternionf to_end = knot_rotations.back().conjugate();
+  for (auto &rotation : knot_rotations) {
+    rotation = to_end * rotation;
+  }
+
+  if (&out != &scan) {
+    *out.points = points;
+  }
+  out.header = Header{end, scan.header.sequence_number, scan.header.trace};
+  out.device_id = scan.device_id;
+
+  size_t segment = 0;
+  for (size_t i = 0; i < points.size(); ++i) {
+    const uint64_t time = start + uint64_t{scan.time_offsets_us[i]} * 1000;
+    if (time < knot_times[segment]) {
+      segment = 0; // offsets are normally increasing; restart otherwise
+    }
+    while (segment + 2 < knot_times.size() &&
+           time >= knot_times[segment + 1]) {
+      ++segment;
+    }
+
+    // A segment turns at a constant rate about a fixed axis: slerp between
+    // its end rotations is exact and stays a rotation.
+    const uint64_t span = knot_times[segment + 1] - knot_times[segment];
+    const uint64_t elapsed = time - knot_times[segment];
+    const float alpha =
+        span == 0 ? 0.0F
+                  : std::min(1.0F, static_cast<float>(elapsed) /
+                                       static_cast<float>(span));
+    const Eigen::Quaternionf rotation =
+        knot_rotations[segment].slerp(alpha, knot_rotations[segment + 1]);
+
+    Eigen::Map<Eigen::Vector3f> point(out.points->points[i].data);
+    point = rotation * Eigen::Vector3f(point);
+  }
+
+  out.time_offsets_us.clear();
+  return true;
+}
+
+} // namespace msensor
@@ -0,0 +1,249 @@
+#include "msensor/processing/voxel_filter.hh"
+
+#include <algorithm>
+#include <bit>
+#include <thread>
+
+namespace msensor {
+namespace {
+
+constexpr uint64_t g_emptyKey = ~uint64_t{0};
+/// Bits per axis in a voxel key; the three axes fill 63 bits, so no key
+/// collides with `g_emptyKey`.
+constexpr int g_axisBits = 21;
+constexpr int32_t g_axisBias = 1 << (g_axisBits - 1);
+constexpr size_t g_minSlots = 64;
+
+/// Biased voxel index of `value` (already scaled by the inverse leaf), or -1
+/// if not finite or out of range. Avoids a libm floor() call per axis.
+int64_t axisIndex(float value) {
+  // Written so that NaN fails the comparison.
+  if (!(value >= -g_axisBias && value < g_axisBias)) {
+    return -1;
+  }
+  auto index = static_cast<int32_t>(value);
+  index -= static_cast<float>(index) > value; // truncation -> floor
+  return int64_t{index} + g_axisBias;
+}
+
+/// Voxel key of `point`, or `g_emptyKey` if it is not finite or out of range.
+uint64_t voxelKey(const Point3I &point, float inverse_leaf) {
+  const int64_t x = axisIndex(point.x * inverse_leaf);
+  const int64_t y = axisIndex(point.y * inverse_leaf);
+  const int64_t z = axisIndex(point.z * inverse_leaf);
+  if (x < 0 || y < 0 || z < 0) {
+    return g_emptyKey;
+  }
+  return (static_cast<uint64_t>(x) << (2 * g_axisBits)) |
+         (static_cast<uint64_t>(y) << g_axisBits) | static_cast<uint64_t>(z);
+}
+
+/// Fibonacci hash: slots use the high half, partitions bits 24 and up.
+uint64_t mix(uint64_t key) { return key * 0x9E3779B97F4A7C15ULL; }
+
+size_t slotOf(uint64_t hash, size_t mask) { return (hash >> 32) & mask; }
+
+size_t partitionOf(uint64_t hash, size_t count) {
+  return (hash >> 24) % count;
+}
+
+} // namespace
+
+void VoxelFilter::Partition::reset(size_t expected_voxels) {
+  const size_t slots = std::max(g_minSlots, std::bit_ceil(2 * expected_voxels));
+  slot_keys.assign(slots, g_emptyKey);
+  slot_cells.resize(slots);
+  cells.clear();
+}
+
+VoxelFilter::Cell &VoxelFilter::Partition::find(uint64_t key, uint64_t hash,
+                                                bool &inserted) {
+  if (2 * (cells.size() + 1) > slot_keys.size()) {
+    // Keep the load under one half: rebuild twice as large.
+    std::vector<uint64_t> old_keys(2 * slot_keys.size(), g_emptyKey);
+    old_keys.swap(slot_keys);
+    std::vector<uint32_t> old_cells(slot_keys.size());
+    old_cells.swap(slot_cells);
+    const size_t mask = slot_keys.size() - 1;
+    for (size_t i = 0; i < old_keys.size(); ++i) {
+      if (old_keys[i] == g_emptyKey) {
+        continue;
+      }
+      size_t slot = slotOf(mix(old_keys[i]), mask);
+      while (slot_keys[slot] != g_emptyKey) {
+        slot = (slot + 1) & mask;
+      }
+      slot_keys[slot] = old_keys[i];
+      slot_cells[slot] = old_cells[i];
+    }
+  }
+
+  const size_t mask = slot_keys.size() - 1;
+  for (size_t slot = slotOf(hash, mask);; slot = (slot + 1) & mask) {
+    if (slot_keys[slot] == key) {
+      inserted = false;
+      return cells[slot_cells[slot]];
+    }
+    if (slot_keys[slot] == g_emptyKey) {
+      slot_keys[slot] = key;
+      slot_cells[slot] = static_cast<uint32_t>(cells.size());
+      inserted = true;
+      return cells.emplace_back();
+    }
+  }
+}
+
+VoxelFilter::VoxelFilter(Mode mode, size_t threads)
+    : mode_(mode),
+      threads_(threads > 0
+                   ? threads
+                   : std::max<size_t>(std::thread::hardware_concurrency(), 1)),
+      buckets_(threads_, std::vector<std::vector<uint32_t>>(threads_)),
+      chunk_dropped_(threads_), partitions_(threads_),
+      start_(static_cast<std::ptrdiff_t>(threads_)),
+      done_(static_cast<std::ptrdiff_t>(threads_)) {
+  workers_.reserve(threads_ - 1);
+  for (size_t i = 1; i < threads_; ++i) {
+    workers_.emplace_back([this, i] { work(i); });
+  }
+}
+
+VoxelFilter::~VoxelFilter() {
+  if (!workers_.empty()) {
+    stopping_ = true;
+    start_.arrive_and_wait();
+  }
+}
+
+void VoxelFilter::work(size_t index) {
+  while (true) {
+    start_.arrive_and_wait();
+    if (stopping_) {
+      return;
+    }
+    job_(job_context_, index);
+    done_.arrive_and_wait();
+  }
+}
+
+template <typename Fn> void VoxelFilter::parallelFor(Fn &fn) {
+  job_ = [](void *context, size_t index) {
+    (*static_cast<Fn *>(context))(index);
+  };
+  job_context_ = &fn;
+  start_.arrive_and_wait();
+  fn(0);
+  done_.arrive_and_wait();
+}
+
+void VoxelFilter::add(Partition &partition, const Point3I &point,
+                      uint64_t key, uint64_t hash) const {
+  bool inserted = false;
+  Cell &cell = partition.find(key, hash, inserted);
+  if (inserted) {
+    cell = Cell{point.x, point.y, point.z, point.intensity, 1};
+  } else if (mode_ == Mode::Centroid) {
+    cell.x += point.x;
+    cell.y += point.y;
+    cell.z += point.z;
+    cell.intensity += point.intensity;
+    ++cell.count;
+  }
+}
+
+void VoxelFilter::split(const PointCloud3I &input, float inverse_leaf,
+                        size_t chunk) {
+  auto &buckets = buckets_[chunk];
+  for (auto &bucket : buckets) {
+    bucket.clear();
+  }
+  size_t dropped = 0;
+  const size_t size = input.size();
+  const size_t end = size * (chunk + 1) / threads_;
+  for (size_t i = size * chunk / threads_; i < end; ++i) {
+    const uint64_t key = voxelKey(input[i], inverse_leaf);
+    keys_[i] = key;
+    if (key == g_emptyKey) {
+      ++dropped;
+      continue;
+    }
+    buckets[partitionOf(mix(key), threads_)].push_back(
+        static_cast<uint32_t>(i));
+  }
+  chunk_dropped_[chunk] = dropped;
+}
+
+void VoxelFilter::aggregate(const PointCloud3I &input, size_t index) {
+  auto &partition = partitions_[index];
+  // Size the table for as many voxels as this partition saw last time.
+  partition.reset(partition.cells.size());
+  // Chunks in order, so each voxel accumulates its points in input order.
+  for (const auto &buckets : buckets_) {
+    for (const uint32_t i : buckets[index]) {
+      add(partition, input[i], keys_[i], mix(keys_[i]));
+    }
+  }
+}
+
+void VoxelFilter::filter(const PointCloud3I &input, float leaf,
+                         PointCloud3I &output) {
+  dropped_ = 0;
+  if (!(leaf > 0.0F)) {
+    output = input;
+    return;
+  }
+
+  const float inverse_leaf = 1.0F / leaf;
+  const size_t size = input.size();
+  const size_t count = size >= g_voxelParallelThreshold ? threads_ : 1;
+
+  if (count == 1) {
+    auto &partition = partitions_[0];
+    partition.reset(partition.cells.size());
+    for (size_t i = 0; i < size; ++i) {
+      const uint64_t key = voxelKey(input[i], inverse_leaf);
+      if (key == g_emptyKey) {
+        ++dropped_;
+        continue;
+      }
+      add(partition, input[i], key, mix(key));
+    }
+  } else {
+    // Keys are computed and partitioned once; each partition then reads
+    // only its own points.
+    keys_.resize(size);
+    auto split_chunk = [&](size_t chunk) {
+      split(input, inverse_leaf, chunk);
+    };
+    parallelFor(split_chunk);
+    auto aggregate_partition = [&](size_t index) { aggregate(input, index); };
+    parallelFor(aggregate_partition);
+    for (const size_t dropped : chunk_dropped_) {
+      dropped_ += dropped;
+    }
+  }
+
+  size_t voxels = 0;
+  for (size_t p = 0; p < count; ++p) {
+    voxels += partitions_[p].cells.size();
+  }
+  output.resize(voxels);
+  size_t out = 0;
+  for (size_t p = 0; p < count; ++p) {
+    for (const Cell &cell : partitions_[p].cells) {
+      auto &point = output[out++];
+      // Divided rather than scaled by the inverse, as PCL does.
+      const auto n = static_cast<float>(cell.count);
+      point.x = cell.x / n;
+      point.y = cell.y / n;
+      point.z = cell.z / n;
+      point.intensity = cell.intensity / n;
+    }
+  }
+  output.header = input.header;
+  output.width = static_cast<uint32_t>(voxels);
+  output.height = 1;
+  output.is_dense = true;
+}
+
+} // namespace msensor
@@ -20,14 +20,17 @@ ScanPlayer::ScanPlayer(const std::filesystem::path &file) {
   }
 
   void *memmap = mmap(nullptr, num_bytes_, PROT_READ, MAP_PRIVATE, fd, 0);
-  if (memory_map_ == MAP_FAILED) {
-    close(fd);
+  // The mapping stays valid once the descriptor is closed.
+  close(fd);
+  if (memmap == MAP_FAILED) {
     throw std::runtime_error("Failed to map file into memory.");
   }
   memory_map_ = reinterpret_cast<char *>(memmap);
   offset_ = 0;
 }
 
+ScanPlayer::~ScanPlayer() { munmap(memory_map_, num_bytes_); }
+
 bool ScanPlayer::next() {
   size_t msg_size;
 
@@ -2,6 +2,7 @@
 #include "msensor/conversions/conversions.hh"
 #include "msensor/timing/timing.hh"
 #include "recording.pb.h"
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
 #include <mutex>
 
 std::mutex g_mutex;
@@ -9,7 +10,8 @@ std::mutex g_mutex;
 namespace msensor {
 
 ScanRecorder::ScanRecorder(const std::shared_ptr<IFile> &file)
-    : record_file_{file}, has_started_{false} {}
+    : record_file_{file}, has_started_{false},
+      arena_{arena_block_.data(), arena_block_.size()} {}
 
 ScanRecorder::~ScanRecorder() { record_file_->close(); }
 
@@ -30,16 +32,28 @@ void ScanRecorder::record(const std::shared_ptr<Scan3DI> &scan) {
   if (!has_started_)
     return;
 
-  sensors::RecordingEntry entry;
-  *entry.mutable_scan() = toProtobuf(scan);
-
-  auto bytes = entry.ByteSizeLong();
+  // RecordingEntry { PointCloud3 scan = 1; } written field by field, so the
+  // points go straight from the PCL cloud into the reused scratch buffer.
+  using google::protobuf::io::CodedOutputStream;
+  constexpr uint32_t scan_tag =
+      (sensors::RecordingEntry::kScanFieldNumber << 3) | 2;
+  const size_t scan_bytes = pointCloudByteSize(scan);
+  size_t bytes = 1 + CodedOutputStream::VarintSize64(scan_bytes) + scan_bytes;
   {
     std::scoped_lock<std::mutex> lock(g_mutex);
+    scratch_.resize(bytes);
+    {
+      google::protobuf::io::ArrayOutputStream raw(scratch_.data(),
+                                                  static_cast<int>(bytes));
+      CodedOutputStream output(&raw);
+      output.WriteTag(scan_tag);
+      output.WriteVarint64(scan_bytes);
+      writePointCloud(scan, &output);
+    }
     // Write size of data
     record_file_->write(reinterpret_cast<char *>(&bytes), sizeof(size_t));
     // Write the sensor data
-    entry.SerializeToOstream(record_file_->ostream());
+    record_file_->ostream()->write(scratch_.data(), bytes);
     *record_file_->ostream() << std::flush;
   }
 }
@@ -48,8 +62,12 @@ void ScanRecorder::record(msensor::IMUData imu) {
   if (!has_started_)
     return;
 
-  sensors::RecordingEntry entry;
-  auto *proto_msg = entry.mutable_imu();
+  std::scoped_lock<std::mutex> lock(g_mutex);
+  // The entry lives on the recorder's arena and is dropped by Reset(), which
+  // keeps the inline initial block, so IMU records do not touch the heap.
+  auto *entry = google::protobuf::Arena::CreateMessage<sensors::RecordingEntry>(
+      &arena_);
+  auto *proto_msg = entry->mutable_imu();
   proto_msg->mutable_header()->set_timestamp(imu.header.timestamp);
   proto_msg->mutable_header()->set_sequence_number(imu.header.sequence_number);
   proto_msg->set_ax(imu.ax);
@@ -59,16 +77,17 @@ void ScanRecorder::record(msensor::IMUData imu) {
   proto_msg->set_gy(imu.gy);
   proto_msg->set_gz(imu.gz);
 
-  auto bytes = entry.ByteSizeLong();
+  auto bytes = entry->ByteSizeLong();
+  scratch_.resize(bytes);
+  entry->SerializeWithCachedSizesToArray(
+      reinterpret_cast<uint8_t *>(scratch_.data()));
+  arena_.Reset();
 
-  {
-    std::scoped_lock<std::mutex> lock(g_mutex);
-    // Write size of data
-    record_file_->write(reinterpret_cast<char *>(&bytes), sizeof(size_t));
-    // Write the sensor data
-    entry.SerializeToOstream(record_file_->ostream());
-    *record_file_->ostream() << std::flush;
-  }
+  // Write size of data
+  record_file_->write(reinterpret_cast<char *>(&bytes), sizeof(size_t));
+  // Write the sensor data
+  record_file_->ostream()->write(scratch_.data(), bytes);
+  *record_file_->ostream() << std::flush;
 }
 
 void ScanRecorder::stop() {
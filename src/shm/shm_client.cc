@@ -0,0 +1,141 @@
+#include "msensor/shm/shm_client.hh"
+#include "msensor/shm/shm_records.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+namespace msensor {
+namespace {
+
+constexpr size_t g_scanPoolCapacity = 4;
+/// Delay between attempts to open a segment that does not exist yet.
+constexpr auto g_reconnectDelay = std::chrono::milliseconds(200);
+/// Longest `read()` waits for a camera frame.
+constexpr auto g_frameTimeout = std::chrono::milliseconds(500);
+
+} // namespace
+
+ShmClient::ShmClient(const std::string &prefix)
+    : lidar_{prefix + "_lidar"}, imu_{prefix + "_imu"},
+      camera_{prefix + "_camera"},
+      scan_pool_(g_scanPoolCapacity,
+                 [] { return std::make_shared<Scan3DI>(); }) {}
+
+void ShmClient::init() {
+  connect(lidar_);
+  connect(imu_);
+  connect(camera_);
+}
+
+bool ShmClient::connect(Stream &stream) {
+  if (stream.ring && stream.ring->closed()) {
+    stream.ring.reset();
+  }
+  if (stream.ring) {
+    return true;
+  }
+  const auto now = std::chrono::steady_clock::now();
+  if (now < stream.retry_at) {
+    return false;
+  }
+  try {
+    stream.ring = ShmRing::open(stream.name);
+  } catch (const std::runtime_error &) {
+    stream.retry_at = now + g_reconnectDelay;
+    return false;
+  }
+  stream.cursor = {stream.ring->published(), stream.cursor.skipped};
+  std::cout << "Reading shared memory " << stream.name << std::endl;
+  return true;
+}
+
+bool ShmClient::waitFor(Stream &stream, std::chrono::nanoseconds timeout) {
+  if (!connect(stream)) {
+    std::this_thread::sleep_for(std::min<std::chrono::nanoseconds>(
+        timeout, g_reconnectDelay));
+    return connect(stream) && stream.ring->published() > stream.cursor.next;
+  }
+  if (stream.ring->waitFor(stream.cursor, timeout)) {
+    return true;
+  }
+  // A crashed publisher never closes its segment: check on idle timeouts.
+  if (stream.ring->replaced()) {
+    stream.ring.reset();
+  }
+  return false;
+}
+
+std::shared_ptr<Scan3DI> ShmClient::getScan() {
+  if (!connect(lidar_)) {
+    return nullptr;
+  }
+  auto scan = scan_pool_.acquire();
+  bool valid = false;
+  const bool read = lidar_.ring->read(
+      lidar_.cursor, [&](const std::byte *payload, size_t size) {
+        valid = readScanRecord(payload, size, *scan);
+      });
+  return read && valid ? scan : nullptr;
+}
+
+bool ShmClient::waitForScan(std::chrono::milliseconds timeout) {
+  return waitFor(lidar_, timeout);
+}
+
+std::optional<IMUData> ShmClient::getImuData() {
+  if (!connect(imu_)) {
+    return std::nullopt;
+  }
+  IMUData sample;
+  bool valid = false;
+  const bool read = imu_.ring->read(
+      imu_.cursor, [&](const std::byte *payload, size_t size) {
+        valid = size == sizeof(sample);
+        if (valid) {
+          std::memcpy(&sample, payload, sizeof(sample));
+        }
+      });
+  return read && valid ? std::optional(sample) : std::nullopt;
+}
+
+bool ShmClient::waitForImuData(std::chrono::milliseconds timeout) {
+  return waitFor(imu_, timeout);
+}
+
+bool ShmClient::read(CameraFrame &frame) {
+  if (!waitFor(camera_, g_frameTimeout)) {
+    return false;
+  }
+  bool valid = false;
+  const bool read = camera_.ring->read(
+      camera_.cursor, [&](const std::byte *payload, size_t size) {
+        ShmFrameRecord record;
+        std::memcpy(&record, payload, sizeof(record));
+        // Bounded first, so that the product cannot overflow.
+        const auto rows = static_cast<size_t>(record.rows);
+        const auto cols = static_cast<size_t>(record.cols);
+        valid = record.rows >= 0 && record.cols >= 0 && rows <= size &&
+                cols <= size &&
+                g_shmDataOffset + rows * cols * CV_ELEM_SIZE(record.type) <=
+                    size;
+        if (!valid) {
+          return;
+        }
+        frame.mat.create(record.rows, record.cols, record.type);
+        std::memcpy(frame.mat.data, payload + g_shmDataOffset,
+                    frame.mat.total() * frame.mat.elemSize());
+        frame.header = record.header;
+      });
+  return read && valid;
+}
+
+void ShmClient::release() {
+  lidar_.ring.reset();
+  imu_.ring.reset();
+  camera_.ring.reset();
+}
+
+} // namespace msensor
@@ -0,0 +1,98 @@
+#include "msensor/shm/shm_publisher.hh"
+#include "msensor/shm/shm_records.hh"
+
+#include <cstring>
+#include <iostream>
+
+namespace msensor {
+
+ShmPublisher::ShmPublisher(const Options &options,
+                           std::shared_ptr<ScanHub> scans,
+                           std::shared_ptr<ImuHub> imu,
+                           std::shared_ptr<FrameHub> frames) {
+  try {
+    if (scans) {
+      lidar_ring_ = ShmRing::create(
+          options.prefix + "_lidar", options.scan_slots,
+          shmScanBytes(options.max_scan_points, true));
+      attach(scans, [this](const auto &scan) { write(*scan); });
+    }
+    if (imu) {
+      imu_ring_ = ShmRing::create(options.prefix + "_imu", options.imu_slots,
+                                  sizeof(IMUData));
+      attach(imu, [this](const IMUData &sample) { write(sample); });
+    }
+    if (frames) {
+      camera_ring_ =
+          ShmRing::create(options.prefix + "_camera", options.frame_slots,
+                          g_shmDataOffset + options.max_frame_bytes);
+      attach(frames, [this](const auto &frame) { write(*frame); });
+    }
+  } catch (...) {
+    for (const auto &detach : detach_) {
+      detach();
+    }
+    throw;
+  }
+  std::cout << "Publishing to shared memory " << options.prefix << "_*"
+            << std::endl;
+}
+
+ShmPublisher::~ShmPublisher() {
+  // Waits for a listener running on a producer thread to return.
+  for (const auto &detach : detach_) {
+    detach();
+  }
+}
+
+template <typename Hub, typename Write>
+void ShmPublisher::attach(const std::shared_ptr<Hub> &hub, Write write) {
+  // Listeners of one hub all run on its producer thread.
+  auto cursor = std::make_shared<typename Hub::Cursor>(hub->subscribe());
+  const uint64_t id = hub->addListener([hub = hub.get(), cursor, write] {
+    while (auto item = hub->read(*cursor)) {
+      write(*item);
+    }
+  });
+  detach_.push_back([hub, id] { hub->removeListener(id); });
+}
+
+void ShmPublisher::write(const Scan3DI &scan) {
+  const size_t bytes = shmScanBytes(scan);
+  if (bytes > lidar_ring_->slotBytes()) {
+    oversized_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  writeScanRecord(scan, lidar_ring_->beginWrite());
+  lidar_ring_->publish(bytes);
+}
+
+void ShmPublisher::write(const IMUData &sample) {
+  std::memcpy(imu_ring_->beginWrite(), &sample, sizeof(sample));
+  imu_ring_->publish(sizeof(sample));
+}
+
+void ShmPublisher::write(const CameraFrame &frame) {
+  const cv::Mat &mat = frame.mat;
+  const size_t row_bytes = mat.cols * mat.elemSize();
+  const size_t bytes = g_shmDataOffset + mat.rows * row_bytes;
+  if (mat.dims > 2 || bytes > camera_ring_->slotBytes()) {
+    oversized_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  std::byte *slot = camera_ring_->beginWrite();
+  const ShmFrameRecord record{frame.header, mat.rows, mat.cols, mat.type()};
+  std::memcpy(slot, &record, sizeof(record));
+  std::byte *data = slot + g_shmDataOffset;
+  if (mat.isContinuous()) {
+    std::memcpy(data, mat.data, mat.rows * row_bytes);
+  } else {
+    for (int row = 0; row < mat.rows; ++row) {
+      std::memcpy(data + row * row_bytes, mat.ptr(row), row_bytes);
+    }
+  }
+  camera_ring_->publish(bytes);
+}
+
+} // namespace msensor
@@ -0,0 +1,50 @@
+#include "msensor/shm/shm_records.hh"
+
+#include <cstring>
+
+namespace msensor {
+
+size_t shmScanBytes(const Scan3DI &scan) {
+  const size_t points = scan.points->size();
+  return shmScanBytes(points, scan.time_offsets_us.size() == points);
+}
+
+void writeScanRecord(const Scan3DI &scan, std::byte *out) {
+  const size_t points = scan.points->size();
+  const bool offsets = scan.time_offsets_us.size() == points;
+  const ShmScanRecord record{scan.header, scan.device_id,
+                             static_cast<uint32_t>(points),
+                             static_cast<uint32_t>(offsets ? points : 0)};
+  std::memcpy(out, &record, sizeof(record));
+  std::byte *data = out + g_shmDataOffset;
+  std::memcpy(data, scan.points->points.data(), points * sizeof(Point3I));
+  if (offsets) {
+    std::memcpy(data + points * sizeof(Point3I), scan.time_offsets_us.data(),
+                points * sizeof(uint32_t));
+  }
+}
+
+bool readScanRecord(const std::byte *data, size_t size, Scan3DI &scan) {
+  ShmScanRecord record;
+  if (size < g_shmDataOffset) {
+    return false;
+  }
+  std::memcpy(&record, data, sizeof(record));
+  if ((record.time_offsets != 0 && record.time_offsets != record.points) ||
+      shmScanBytes(record.points, record.time_offsets != 0) > size) {
+    return false;
+  }
+  const std::byte *points = data + g_shmDataOffset;
+  scan.points->resize(record.points);
+  std::memcpy(scan.points->points.data(), points,
+              record.points * sizeof(Point3I));
+  scan.time_offsets_us.resize(record.time_offsets);
+  std::memcpy(scan.time_offsets_us.data(),
+              points + record.points * sizeof(Point3I),
+              record.time_offsets * sizeof(uint32_t));
+  scan.header = record.header;
+  scan.device_id = record.device_id;
+  return true;
+}
+
+} // namespace msensor
@@ -0,0 +1,236 @@
+#include "msensor/shm/shm_ring.hh"
+
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <limits>
+#include <linux/futex.h>
+#include <new>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <utility>
+
+namespace msensor {
+namespace {
+
+constexpr uint32_t g_ringMagic = 0x6d73524e; // "msRN"
+/// Bumped on any change of the shared layout.
+constexpr uint32_t g_ringVersion = 1;
+constexpr size_t g_slotAlignment = 64;
+
+std::runtime_error shmError(const std::string &what, const std::string &name) {
+  return std::runtime_error(what + " " + name + ": " + std::strerror(errno));
+}
+
+// Not FUTEX_PRIVATE: waiter and waker live in different processes.
+long futex(std::atomic<uint32_t> *word, int op, uint32_t value,
+           const timespec *timeout = nullptr) {
+  return syscall(SYS_futex, reinterpret_cast<uint32_t *>(word), op, value,
+                 timeout, nullptr, 0);
+}
+
+} // namespace
+
+ShmRing ShmRing::create(const std::string &name, size_t slots,
+                        size_t slot_bytes) {
+  if (slots == 0) {
+    throw std::runtime_error("Shared-memory ring " + name + " has no slots");
+  }
+  constexpr size_t max = std::numeric_limits<size_t>::max();
+  if (slot_bytes > max - sizeof(Slot) - g_slotAlignment) {
+    throw std::runtime_error("Shared-memory ring " + name + " is too large");
+  }
+  const size_t stride = (sizeof(Slot) + slot_bytes + g_slotAlignment - 1) /
+                        g_slotAlignment * g_slotAlignment;
+  if (slots > (max - sizeof(Control)) / stride ||
+      sizeof(Control) + slots * stride >
+          static_cast<size_t>(std::numeric_limits<off_t>::max())) {
+    throw std::runtime_error("Shared-memory ring " + name + " is too large");
+  }
+  const size_t bytes = sizeof(Control) + slots * stride;
+
+  // A segment left by a crashed writer is replaced, not reused; its readers
+  // find out through `replaced()`.
+  shm_unlink(name.c_str());
+  const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0660);
+  if (fd < 0) {
+    throw shmError("Unable to create shared memory", name);
+  }
+  struct stat status {};
+  if (ftruncate(fd, static_cast<off_t>(bytes)) != 0 || fstat(fd, &status)) {
+    const auto error = shmError("Unable to size shared memory", name);
+    close(fd);
+    shm_unlink(name.c_str());
+    throw error;
+  }
+  void *memory =
+      mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (memory == MAP_FAILED) {
+    shm_unlink(name.c_str());
+    throw shmError("Unable to map shared memory", name);
+  }
+
+  // Pages are only backed once touched, so large idle slots cost nothing.
+  auto *control = new (memory) Control{};
+  control->slots = slots;
+  control->slot_bytes = slot_bytes;
+  control->stride = stride;
+  for (uint64_t i = 0; i < slots; ++i) {
+    new (reinterpret_cast<std::byte *>(memory) + sizeof(Control) + i * stride)
+        Slot{};
+  }
+  control->version = g_ringVersion;
+  std::atomic_thread_fence(std::memory_order_release);
+  control->magic = g_ringMagic;
+  return ShmRing(name, memory, bytes, status.st_ino, true);
+}
+
+ShmRing ShmRing::open(const std::string &name) {
+  const int fd = shm_open(name.c_str(), O_RDWR, 0);
+  if (fd < 0) {
+    throw shmError("Unable to open shared memory", name);
+  }
+  struct stat status {};
+  if (fstat(fd, &status) != 0 ||
+      static_cast<size_t>(status.st_size) < sizeof(Control)) {
+    close(fd);
+    throw std::runtime_error("Shared memory " + name + " is not a ring");
+  }
+  const auto bytes = static_cast<size_t>(status.st_size);
+  // Read-write: readers register as futex waiters in the control block.
+  void *memory =
+      mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (memory == MAP_FAILED) {
+    throw shmError("Unable to map shared memory", name);
+  }
+
+  const auto *control = static_cast<const Control *>(memory);
+  if (control->magic != g_ringMagic || control->version != g_ringVersion) {
+    munmap(memory, bytes);
+    throw std::runtime_error("Shared memory " + name +
+                             " is not a compatible ring");
+  }
+  // The geometry is checked, without overflow, on the ring's own copy: the
+  // segment may be corrupt or change later.
+  ShmRing ring(name, memory, bytes, status.st_ino, false);
+  if (ring.slots_ == 0 || ring.stride_ < sizeof(Slot) ||
+      ring.stride_ % alignof(Slot) != 0 ||
+      ring.slot_bytes_ > ring.stride_ - sizeof(Slot) ||
+      ring.slots_ > (bytes - sizeof(Control)) / ring.stride_) {
+    throw std::runtime_error("Shared memory " + name +
+                             " is not a compatible ring");
+  }
+  return ring;
+}
+
+ShmRing::ShmRing(std::string name, void *memory, size_t bytes,
+                 uint64_t inode, bool writer)
+    : name_(std::move(name)), control_(static_cast<Control *>(memory)),
+      bytes_(bytes), slots_(control_->slots),
+      slot_bytes_(control_->slot_bytes), stride_(control_->stride),
+      inode_(inode), writer_(writer) {}
+
+ShmRing::ShmRing(ShmRing &&other) noexcept
+    : name_(std::move(other.name_)),
+      control_(std::exchange(other.control_, nullptr)),
+      bytes_(other.bytes_), slots_(other.slots_),
+      slot_bytes_(other.slot_bytes_), stride_(other.stride_),
+      inode_(other.inode_), writer_(other.writer_) {}
+
+ShmRing &ShmRing::operator=(ShmRing &&other) noexcept {
+  if (this != &other) {
+    release();
+    name_ = std::move(other.name_);
+    control_ = std::exchange(other.control_, nullptr);
+    bytes_ = other.bytes_;
+    slots_ = other.slots_;
+    slot_bytes_ = other.slot_bytes_;
+    stride_ = other.stride_;
+    inode_ = other.inode_;
+    writer_ = other.writer_;
+  }
+  return *this;
+}
+
+ShmRing::~ShmRing() { release(); }
+
+void ShmRing::release() {
+  if (!control_) {
+    return;
+  }
+  if (writer_) {
+    control_->closed.store(1, std::memory_order_release);
+    control_->notify.fetch_add(1);
+    futex(&control_->notify, FUTEX_WAKE, INT_MAX);
+    shm_unlink(name_.c_str());
+  }
+  munmap(control_, bytes_);
+  control_ = nullptr;
+}
+
+bool ShmRing::replaced() const {
+  const int fd = shm_open(name_.c_str(), O_RDONLY, 0);
+  if (fd < 0) {
+    return true;
+  }
+  struct stat status {};
+  const bool same = fstat(fd, &status) == 0 && status.st_ino == inode_;
+  close(fd);
+  return !same;
+}
+
+std::byte *ShmRing::beginWrite() {
+  const uint64_t index = control_->head.load(std::memory_order_relaxed);
+  Slot &slot = slotAt(index);
+  slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+  // Readers must see the odd sequence before any payload byte changes.
+  std::atomic_thread_fence(std::memory_order_release);
+  return payload(slot);
+}
+
+void ShmRing::publish(size_t size) {
+  const uint64_t index = control_->head.load(std::memory_order_relaxed);
+  Slot &slot = slotAt(index);
+  slot.size = size;
+  slot.sequence.store(2 * index + 2, std::memory_order_release);
+  control_->head.store(index + 1, std::memory_order_release);
+
+  // Pairs with waitFor(): a reader either sees the new head, or registers
+  // as a waiter before this check and is woken.
+  control_->notify.fetch_add(1);
+  if (control_->waiters.load() > 0) {
+    futex(&control_->notify, FUTEX_WAKE, INT_MAX);
+  }
+}
+
+bool ShmRing::waitFor(const Cursor &cursor,
+                      std::chrono::nanoseconds timeout) const {
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  control_->waiters.fetch_add(1);
+  bool ready;
+  while (true) {
+    const uint32_t notify = control_->notify.load();
+    ready = published() > cursor.next;
+    const auto left = deadline - std::chrono::steady_clock::now();
+    if (ready || closed() || left <= std::chrono::nanoseconds::zero()) {
+      break;
+    }
+    const auto seconds =
+        std::chrono::duration_cast<std::chrono::seconds>(left);
+    const timespec relative{
+        static_cast<time_t>(seconds.count()),
+        static_cast<long>((left - seconds).count())};
+    // Returns at once if a publish bumped `notify` since it was loaded.
+    futex(&control_->notify, FUTEX_WAIT, notify, &relative);
+  }
+  control_->waiters.fetch_sub(1);
+  return ready;
+}
+
+} // namespace msensor
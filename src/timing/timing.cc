@@ -1,5 +1,7 @@
 #include "msensor/timing/timing.hh"
+#include "msensor/timing/trace.hh"
 
+#include <atomic>
 #include <chrono>
 
 namespace timing {
@@ -28,4 +30,18 @@ uint64_t getNowNs() {
              std::chrono::steady_clock::now().time_since_epoch())
       .count();
 }
+
+#ifdef MSENSOR_WITH_TRACING
+namespace {
+std::atomic<bool> g_tracingEnabled{false};
+} // namespace
+
+bool tracingEnabled() {
+  return g_tracingEnabled.load(std::memory_order_relaxed);
+}
+
+void setTracingEnabled(bool enabled) {
+  g_tracingEnabled.store(enabled, std::memory_order_relaxed);
+}
+#endif
 } // namespace timing
\ No newline at end of file
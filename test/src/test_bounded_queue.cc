@@ -0,0 +1,65 @@
+#include "msensor/concurrency/bounded_queue.hh"
+#include <gtest/gtest.h>
+
+#include <thread>
+
+using namespace msensor;
+using namespace std::chrono_literals;
+
+TEST(TestBoundedQueue, DropOldestKeepsNewest) {
+  BoundedQueue<int> queue(2, Overflow::DropOldest);
+  EXPECT_TRUE(queue.push(1));
+  EXPECT_TRUE(queue.push(2));
+  EXPECT_TRUE(queue.push(3));
+
+  EXPECT_EQ(queue.pop(), 2);
+  EXPECT_EQ(queue.pop(), 3);
+  EXPECT_EQ(queue.pop(), std::nullopt);
+
+  const auto stats = queue.stats();
+  EXPECT_EQ(stats.pushed, 3);
+  EXPECT_EQ(stats.dropped, 1);
+  EXPECT_EQ(stats.high_water, 2);
+  EXPECT_EQ(stats.depth, 0);
+}
+
+TEST(TestBoundedQueue, DropNewestKeepsOldest) {
+  BoundedQueue<int> queue(2, Overflow::DropNewest);
+  queue.push(1);
+  queue.push(2);
+  EXPECT_FALSE(queue.push(3));
+
+  EXPECT_EQ(queue.pop(), 1);
+  EXPECT_EQ(queue.pop(), 2);
+  EXPECT_EQ(queue.stats().dropped, 1);
+}
+
+TEST(TestBoundedQueue, BlockWaitsForRoom) {
+  BoundedQueue<int> queue(1, Overflow::Block, 1000ms);
+  queue.push(1);
+
+  std::jthread consumer([&] {
+    std::this_thread::sleep_for(20ms);
+    queue.pop();
+  });
+  EXPECT_TRUE(queue.push(2));
+  consumer.join();
+  EXPECT_EQ(queue.pop(), 2);
+
+  BoundedQueue<int> full(1, Overflow::Block, 1ms);
+  full.push(1);
+  EXPECT_FALSE(full.push(2));
+  EXPECT_EQ(full.stats().dropped, 1);
+}
+
+TEST(TestBoundedQueue, LogsDropsAtMostOncePerPeriod) {
+  BoundedQueue<int> queue(1, Overflow::DropNewest, {}, "test queue");
+  queue.push(0);
+  testing::internal::CaptureStdout();
+  for (int i = 0; i < 100; ++i) {
+    queue.push(i);
+  }
+  const std::string log = testing::internal::GetCapturedStdout();
+  EXPECT_EQ(log, "test queue: 1 elements dropped (capacity 1).\n");
+  EXPECT_EQ(queue.stats().dropped, 100);
+}
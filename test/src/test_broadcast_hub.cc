@@ -0,0 +1,100 @@
+#include "msensor/concurrency/broadcast_hub.hh"
+#include <gtest/gtest.h>
+#include <memory>
+
+using namespace msensor;
+
+TEST(TestBroadcastHub, EmptyUntilPublished) {
+  BroadcastHub<int> hub(4);
+  auto cursor = hub.subscribe();
+
+  EXPECT_EQ(hub.read(cursor), std::nullopt);
+
+  hub.publish(1);
+  EXPECT_EQ(hub.read(cursor), 1);
+  EXPECT_EQ(hub.read(cursor), std::nullopt);
+}
+
+TEST(TestBroadcastHub, EverySubscriberSeesEveryItem) {
+  BroadcastHub<std::shared_ptr<const int>> hub(4);
+  auto first = hub.subscribe();
+  auto second = hub.subscribe();
+
+  const auto item = std::make_shared<const int>(42);
+  hub.publish(item);
+
+  const auto read_first = hub.read(first);
+  const auto read_second = hub.read(second);
+  ASSERT_TRUE(read_first.has_value());
+  ASSERT_TRUE(read_second.has_value());
+  // Both subscribers share the same immutable instance.
+  EXPECT_EQ(read_first->get(), item.get());
+  EXPECT_EQ(read_second->get(), item.get());
+}
+
+TEST(TestBroadcastHub, LateSubscriberStartsAtHead) {
+  BroadcastHub<int> hub(4);
+  hub.publish(1);
+  hub.publish(2);
+
+  auto cursor = hub.subscribe();
+  EXPECT_EQ(hub.read(cursor), std::nullopt);
+
+  hub.publish(3);
+  EXPECT_EQ(hub.read(cursor), 3);
+}
+
+TEST(TestBroadcastHub, SlowSubscriberSkipsOverwrittenItems) {
+  BroadcastHub<int> hub(3);
+  auto cursor = hub.subscribe();
+
+  for (int i = 0; i < 5; ++i) {
+    hub.publish(i);
+  }
+
+  // Items 0 and 1 were overwritten.
+  EXPECT_EQ(hub.read(cursor), 2);
+  EXPECT_EQ(cursor.skipped, 2);
+  EXPECT_EQ(hub.read(cursor), 3);
+  EXPECT_EQ(hub.read(cursor), 4);
+  EXPECT_EQ(hub.read(cursor), std::nullopt);
+  EXPECT_EQ(hub.published(), 5);
+}
+
+TEST(TestBroadcastHub, ReadLatestSkipsToNewestItem) {
+  BroadcastHub<int> hub(3);
+  auto cursor = hub.subscribe();
+  EXPECT_EQ(hub.readLatest(cursor), std::nullopt);
+
+  hub.publish(0);
+  EXPECT_EQ(hub.readLatest(cursor), 0);
+  EXPECT_EQ(cursor.skipped, 0);
+
+  for (int i = 1; i < 6; ++i) {
+    hub.publish(i);
+  }
+  // 1 to 4 were never read, whether still held by the ring or not.
+  EXPECT_EQ(hub.readLatest(cursor), 5);
+  EXPECT_EQ(cursor.skipped, 4);
+  EXPECT_EQ(hub.readLatest(cursor), std::nullopt);
+  EXPECT_EQ(hub.read(cursor), std::nullopt);
+}
+
+TEST(TestBroadcastHub, ListenersRunOnPublishUntilRemoved) {
+  BroadcastHub<int> hub(4);
+  auto cursor = hub.subscribe();
+  std::vector<int> received;
+
+  const auto id = hub.addListener([&] {
+    while (const auto item = hub.read(cursor)) {
+      received.push_back(*item);
+    }
+  });
+
+  hub.publish(1);
+  hub.publish(2);
+  hub.removeListener(id);
+  hub.publish(3);
+
+  EXPECT_EQ(received, (std::vector<int>{1, 2}));
+}
@@ -0,0 +1,164 @@
+#include "msensor/conversions/conversions.hh"
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <gtest/gtest.h>
+
+using namespace msensor;
+
+class TestPackedConversions : public ::testing::Test {
+public:
+  void SetUp() override {
+    scan_ = std::make_shared<Scan3DI>();
+    scan_->points->emplace_back(1.2345F, -2.5F, 0.0F, 12.0F);
+    scan_->points->emplace_back(1.2338F, -2.4F, 0.01F, 255.0F);
+    scan_->points->emplace_back(-40.0F, 30.0F, -1.0F, 300.0F);
+    scan_->header = Header{10, 3};
+  }
+
+protected:
+  void expectRoundTrip(const sensors::PackedEncoding &encoding) {
+    const auto packed = toProtobuf(scan_, encoding);
+    const auto decoded = fromProtobuf(packed);
+
+    EXPECT_EQ(decoded->header.timestamp, 10);
+    EXPECT_EQ(decoded->header.sequence_number, 3);
+    ASSERT_EQ(decoded->points->size(), scan_->points->size());
+
+    const float tolerance = packed.encoding().scale() / 2 + 1e-5F;
+    for (size_t i = 0; i < scan_->points->size(); ++i) {
+      const auto &expected = (*scan_->points)[i];
+      const auto &actual = (*decoded->points)[i];
+      EXPECT_NEAR(actual.x, expected.x, tolerance);
+      EXPECT_NEAR(actual.y, expected.y, tolerance);
+      EXPECT_NEAR(actual.z, expected.z, tolerance);
+      EXPECT_EQ(actual.intensity, std::min(expected.intensity, 255.0F));
+    }
+  }
+
+  std::shared_ptr<Scan3DI> scan_;
+};
+
+TEST_F(TestPackedConversions, DefaultScaleIsMillimetre) {
+  const auto packed = toProtobuf(scan_, sensors::PackedEncoding{});
+  EXPECT_FLOAT_EQ(packed.encoding().scale(), 0.001F);
+  ASSERT_TRUE(packed.has_points());
+  EXPECT_EQ(packed.points().x(0), 1235); // round(1234.5) away from zero
+  expectRoundTrip(sensors::PackedEncoding{});
+}
+
+TEST_F(TestPackedConversions, DeltaRoundTrip) {
+  sensors::PackedEncoding encoding;
+  encoding.set_delta(true);
+  encoding.set_scale(0.01F);
+
+  const auto packed = toProtobuf(scan_, encoding);
+  ASSERT_TRUE(packed.has_points());
+  EXPECT_EQ(packed.points().x(1), 0); // 1.2345 and 1.2338 share a 1 cm cell
+  expectRoundTrip(encoding);
+}
+
+TEST_F(TestPackedConversions, DeltasOfDistantPointsDoNotOverflow) {
+  scan_->points->clear();
+  scan_->points->emplace_back(3e6F, -3e6F, 0.0F, 0.0F);
+  scan_->points->emplace_back(-3e6F, 3e6F, 0.0F, 0.0F);
+  sensors::PackedEncoding encoding;
+  encoding.set_delta(true);
+
+  // Clamped to the quantized range, but not wrapped around.
+  const auto decoded = fromProtobuf(toProtobuf(scan_, encoding));
+  ASSERT_EQ(decoded->points->size(), 2u);
+  EXPECT_GT((*decoded->points)[0].x, 1e6F);
+  EXPECT_LT((*decoded->points)[0].y, -1e6F);
+  EXPECT_LT((*decoded->points)[1].x, -1e6F);
+  EXPECT_GT((*decoded->points)[1].y, 1e6F);
+}
+
+TEST_F(TestPackedConversions, CompressionRoundTrip) {
+  sensors::PackedEncoding encoding;
+  encoding.set_delta(true);
+  encoding.set_compression(sensors::COMPRESSION_ZSTD);
+  expectRoundTrip(encoding);
+}
+
+TEST(TestImuBatchConversions, RoundTrip) {
+  sensors::ImuBatch batch;
+  appendToBatch(batch, IMUData{Header{1000, 7}, 1, 2, 3, 4, 5, 6});
+  appendToBatch(batch, IMUData{Header{6000, 8}, 7, 8, 9, 10, 11, 12});
+
+  EXPECT_EQ(batch.header().timestamp(), 1000);
+  EXPECT_EQ(batch.time_offset_ns(1), 5000);
+
+  const auto samples = fromProtobuf(batch);
+  ASSERT_EQ(samples.size(), 2);
+  EXPECT_EQ(samples[1].header.timestamp, 6000);
+  EXPECT_EQ(samples[1].header.sequence_number, 8);
+  EXPECT_EQ(samples[1].ax, 7);
+  EXPECT_EQ(samples[1].gz, 12);
+}
+
+TEST(TestPointCloudConversions, DirectWriteMatchesMessage) {
+  auto scan = std::make_shared<Scan3DI>();
+  scan->header = Header{123456789, 42};
+  scan->device_id = 300;
+  // Unset checkpoints are skipped on the wire.
+  scan->header.trace = Trace{1700000000000000000, 0, 1700000000000500000, 0};
+  // Odd count so both the vector body and the scalar tail are exercised.
+  for (int i = 0; i < 11; ++i) {
+    scan->points->emplace_back(0.5F * i, -1.0F * i, 2.0F + i, 30.0F * i);
+    scan->time_offsets_us.push_back(i * 5000);
+  }
+
+  const auto message = toProtobuf(scan);
+  ASSERT_EQ(message.x_size(), 11);
+  EXPECT_FLOAT_EQ(message.y(10), -10.0F);
+  EXPECT_EQ(message.intensity(9), 270);
+
+  std::string direct;
+  {
+    google::protobuf::io::StringOutputStream raw(&direct);
+    google::protobuf::io::CodedOutputStream output(&raw);
+    writePointCloud(scan, &output);
+  }
+  EXPECT_EQ(pointCloudByteSize(scan), message.ByteSizeLong());
+  EXPECT_EQ(direct, message.SerializeAsString());
+
+  const auto decoded = fromProtobuf(message);
+  EXPECT_EQ(decoded->time_offsets_us, scan->time_offsets_us);
+  EXPECT_EQ(decoded->device_id, 300);
+  EXPECT_EQ(decoded->header.trace.driver_receive_ns,
+            scan->header.trace.driver_receive_ns);
+  EXPECT_EQ(decoded->header.trace.serialization_done_ns,
+            scan->header.trace.serialization_done_ns);
+  EXPECT_EQ(decoded->header.trace.write_start_ns, 0);
+}
+
+TEST(TestCropConversions, UnsetFieldsKeepEverything) {
+  EXPECT_TRUE(fromProtobuf(sensors::CropRegion{}).keepsAll());
+  EXPECT_FALSE(toProtobuf(msensor::CropRegion{}).has_box());
+
+  msensor::CropRegion region;
+  region.box_min[2] = -0.5F;
+  region.max_range = 12.0F;
+  region.azimuth_min = -0.5F;
+  region.azimuth_max = 0.5F;
+  region.min_intensity = 10.0F;
+  const auto decoded = fromProtobuf(toProtobuf(region));
+  EXPECT_EQ(decoded.box_min, region.box_min);
+  EXPECT_EQ(decoded.box_max, region.box_max);
+  EXPECT_EQ(decoded.max_range, 12.0F);
+  EXPECT_EQ(decoded.azimuth_max, 0.5F);
+  EXPECT_EQ(decoded.min_intensity, 10.0F);
+}
+
+TEST(TestCropConversions, UnsetBoxBoundsAreUnbounded) {
+  sensors::CropRegion msg;
+  msg.mutable_box()->set_max_z(2.0F);
+  const auto region = fromProtobuf(msg);
+  EXPECT_EQ(region.box_min[2], -msensor::CropRegion::g_infinity);
+  EXPECT_EQ(region.box_max[0], msensor::CropRegion::g_infinity);
+  EXPECT_EQ(region.box_max[2], 2.0F);
+
+  const auto box = toProtobuf(region).box();
+  EXPECT_FALSE(box.has_min_z());
+  EXPECT_FALSE(box.has_max_x());
+  EXPECT_TRUE(box.has_max_z());
+}
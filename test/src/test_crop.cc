@@ -0,0 +1,124 @@
+#include "msensor/processing/crop.hh"
+#include <cmath>
+#include <gtest/gtest.h>
+#include <limits>
+#include <numbers>
+#include <random>
+
+using namespace msensor;
+
+namespace {
+
+constexpr float g_pi = std::numbers::pi_v<float>;
+
+Scan3DI makeScan(size_t count) {
+  std::mt19937 random(3);
+  std::uniform_real_distribution<float> coordinate(-20.0F, 20.0F);
+  std::uniform_real_distribution<float> intensity(0.0F, 255.0F);
+  Scan3DI scan;
+  scan.header = Header{42, 7};
+  scan.device_id = 2;
+  for (size_t i = 0; i < count; ++i) {
+    scan.points->emplace_back(coordinate(random), coordinate(random),
+                              coordinate(random), intensity(random));
+    scan.time_offsets_us.push_back(static_cast<uint32_t>(i));
+  }
+  (*scan.points)[5].x = std::numeric_limits<float>::quiet_NaN();
+  return scan;
+}
+
+/// Straightforward test of one point, with atan2 for the sector.
+bool inside(const CropRegion &region, const Point3I &p) {
+  for (size_t axis = 0; axis < 3; ++axis) {
+    const float value = axis == 0 ? p.x : axis == 1 ? p.y : p.z;
+    if (!(value >= region.box_min[axis] && value <= region.box_max[axis])) {
+      return false;
+    }
+  }
+  const float range = std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z);
+  if (range < region.min_range || range > region.max_range ||
+      p.intensity < region.min_intensity) {
+    return false;
+  }
+  const float span =
+      std::remainder(region.azimuth_max - region.azimuth_min - g_pi,
+                     2 * g_pi) +
+      g_pi;
+  if (region.azimuth_min == region.azimuth_max) {
+    return true;
+  }
+  const float offset =
+      std::remainder(std::atan2(p.y, p.x) - region.azimuth_min - g_pi,
+                     2 * g_pi) +
+      g_pi;
+  return offset <= span;
+}
+
+void expectCrop(const CropRegion &region) {
+  // Odd size: exercises the scalar tail after the vector loop.
+  const Scan3DI scan = makeScan(10003);
+  Scan3DI out;
+  crop(scan, region, out);
+
+  size_t kept = 0;
+  for (size_t i = 0; i < scan.points->size(); ++i) {
+    if (!inside(region, (*scan.points)[i])) {
+      continue;
+    }
+    ASSERT_LT(kept, out.points->size());
+    EXPECT_EQ(out.time_offsets_us[kept], i);
+    EXPECT_EQ((*out.points)[kept].x, (*scan.points)[i].x);
+    ++kept;
+  }
+  EXPECT_EQ(out.points->size(), kept);
+  EXPECT_EQ(out.points->width, kept);
+  EXPECT_EQ(out.time_offsets_us.size(), kept);
+  EXPECT_EQ(out.header.sequence_number, 7u);
+  EXPECT_EQ(out.device_id, 2u);
+}
+
+} // namespace
+
+TEST(Crop, DefaultRegionKeepsFinitePoints) {
+  EXPECT_TRUE(CropRegion{}.keepsAll());
+  expectCrop({});
+}
+
+TEST(Crop, MatchesReferenceForEachTest) {
+  CropRegion box;
+  box.box_min = {-5.0F, 0.0F, -1.0F};
+  box.box_max = {5.0F, 10.0F, 1.0F};
+  EXPECT_FALSE(box.keepsAll());
+  expectCrop(box);
+
+  CropRegion range;
+  range.min_range = 5.0F;
+  range.max_range = 15.0F;
+  expectCrop(range);
+
+  CropRegion intensity;
+  intensity.min_intensity = 200.0F;
+  expectCrop(intensity);
+
+  CropRegion combined = box;
+  combined.max_range = 8.0F;
+  combined.min_intensity = 50.0F;
+  expectCrop(combined);
+}
+
+TEST(Crop, SectorsNarrowWideAndAcrossPi) {
+  CropRegion narrow; // 30 degrees ahead
+  narrow.azimuth_min = -g_pi / 12;
+  narrow.azimuth_max = g_pi / 12;
+  expectCrop(narrow);
+
+  CropRegion wide; // everything but the 60 degrees behind
+  wide.azimuth_min = -5 * g_pi / 6;
+  wide.azimuth_max = 5 * g_pi / 6;
+  expectCrop(wide);
+
+  CropRegion behind; // wraps through +-pi
+  behind.azimuth_min = 5 * g_pi / 6;
+  behind.azimuth_max = -5 * g_pi / 6;
+  expectCrop(behind);
+}
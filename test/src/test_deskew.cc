@@ -0,0 +1,77 @@
+#include "msensor/processing/deskew.hh"
+#include <cmath>
+#include <gtest/gtest.h>
+
+using namespace msensor;
+
+class TestDeskew : public ::testing::Test {
+public:
+  void SetUp() override {
+    // 100 ms scan: one point along +X at the start, middle and end.
+    scan_.header = Header{g_start, 1};
+    for (uint32_t offset_us : {0U, 50000U, 100000U}) {
+      scan_.points->emplace_back(1.0F, 0.0F, 0.0F, 5.0F);
+      scan_.time_offsets_us.push_back(offset_us);
+    }
+  }
+
+protected:
+  static constexpr uint64_t g_start = 1000000000;
+
+  /// Yaw at `rate` rad/s from before the scan until `until_ns` after it.
+  void addYawRate(float rate, uint64_t until_ns) {
+    for (uint64_t t = g_start - 5000000; t <= g_start + until_ns;
+         t += 5000000) {
+      deskewer_.addImu(IMUData{Header{t, 0}, 0, 0, 9.81F, 0, 0, rate});
+    }
+  }
+
+  ImuDeskewer deskewer_;
+  Scan3DI scan_;
+};
+
+TEST_F(TestDeskew, WaitsForImuCoverage) {
+  addYawRate(1.0F, 50000000);
+  EXPECT_FALSE(deskewer_.covers(scan_));
+
+  Scan3DI out;
+  EXPECT_FALSE(deskewer_.deskew(scan_, out));
+}
+
+TEST_F(TestDeskew, RotatesPointsIntoScanEndFrame) {
+  addYawRate(1.0F, 120000000);
+  ASSERT_TRUE(deskewer_.covers(scan_));
+
+  Scan3DI out;
+  ASSERT_TRUE(deskewer_.deskew(scan_, out));
+  EXPECT_EQ(out.header.timestamp, g_start + 100000000);
+  EXPECT_TRUE(out.time_offsets_us.empty());
+  ASSERT_EQ(out.points->size(), 3);
+
+  // The sensor yawed 0.1 rad by the end, so earlier points appear rotated
+  // back by the remaining angle.
+  for (size_t i = 0; i < 3; ++i) {
+    const float remaining = 0.1F - 0.05F * static_cast<float>(i);
+    EXPECT_NEAR((*out.points)[i].x, std::cos(remaining), 1e-4F) << i;
+    EXPECT_NEAR((*out.points)[i].y, -std::sin(remaining), 1e-4F) << i;
+    EXPECT_NEAR((*out.points)[i].z, 0.0F, 1e-6F) << i;
+    EXPECT_FLOAT_EQ((*out.points)[i].intensity, 5.0F) << i;
+  }
+}
+
+TEST_F(TestDeskew, KeepsPointNormsAcrossLargeRotations) {
+  // Two samples only: the whole scan is one segment turning 2 rad.
+  for (uint64_t t : {g_start - 5000000, g_start + 120000000}) {
+    deskewer_.addImu(IMUData{Header{t, 0}, 0, 0, 9.81F, 0, 0, 20.0F});
+  }
+  scan_.device_id = 3;
+
+  Scan3DI out;
+  ASSERT_TRUE(deskewer_.deskew(scan_, out));
+  EXPECT_EQ(out.device_id, 3u);
+  for (size_t i = 0; i < 3; ++i) {
+    const float remaining = 2.0F - 1.0F * static_cast<float>(i);
+    EXPECT_NEAR((*out.points)[i].x, std::cos(remaining), 1e-4F) << i;
+    EXPECT_NEAR((*out.points)[i].y, -std::sin(remaining), 1e-4F) << i;
+  }
+}
@@ -0,0 +1,144 @@
+#include "imu_service.hh"
+#include <condition_variable>
+#include <grpcpp/grpcpp.h>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+/// IMU whose samples are fed by the test.
+class FakeImu : public msensor::IImu {
+public:
+  void feed(int count) {
+    {
+      std::scoped_lock lock(mutex_);
+      pending_ += count;
+    }
+    ready_.notify_all();
+  }
+
+  std::optional<msensor::IMUData> getImuData() override {
+    std::scoped_lock lock(mutex_);
+    if (pending_ == 0) {
+      return std::nullopt;
+    }
+    --pending_;
+    ++sequence_;
+    const auto value = static_cast<float>(sequence_);
+    return msensor::IMUData{msensor::Header{1000ULL * sequence_, sequence_},
+                            value, 0, 9.81F, 0, 0, value};
+  }
+
+  bool waitForImuData(std::chrono::milliseconds timeout) override {
+    std::unique_lock lock(mutex_);
+    return ready_.wait_for(lock, timeout, [this] { return pending_ > 0; });
+  }
+
+private:
+  std::mutex mutex_;
+  std::condition_variable ready_;
+  int pending_ = 0;
+  uint32_t sequence_ = 0;
+};
+
+} // namespace
+
+class TestImuService : public ::testing::Test {
+public:
+  void SetUp() override {
+    grpc::ServerBuilder builder;
+    builder.RegisterService(&service);
+    server = builder.BuildAndStart();
+    ASSERT_NE(server, nullptr);
+    stub = sensors::ImuService::NewStub(
+        server->InProcessChannel(grpc::ChannelArguments()));
+  }
+
+  void TearDown() override {
+    server->Shutdown(std::chrono::system_clock::now() + 1s);
+  }
+
+  /// Open a batch stream and wait until the service publishes to it.
+  std::unique_ptr<grpc::ClientReader<sensors::ImuBatch>>
+  openBatchStream(grpc::ClientContext &context, uint32_t max_samples,
+                  uint32_t max_latency_ms) {
+    sensors::ImuBatchRequest request;
+    request.set_max_samples(max_samples);
+    request.set_max_latency_ms(max_latency_ms);
+    auto reader = stub->getImuBatch(&context, request);
+    const auto deadline = std::chrono::steady_clock::now() + 2s;
+    while (!service.hub()->hasListeners() &&
+           std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(1ms);
+    }
+    return reader;
+  }
+
+protected:
+  std::shared_ptr<FakeImu> imu = std::make_shared<FakeImu>();
+  ImuServiceImpl service{imu};
+  std::unique_ptr<grpc::Server> server;
+  std::unique_ptr<sensors::ImuService::Stub> stub;
+};
+
+TEST_F(TestImuService, BatchClosesOnSizeLimit) {
+  grpc::ClientContext context;
+  auto reader = openBatchStream(context, 4, 60000);
+  ASSERT_TRUE(service.hub()->hasListeners());
+
+  imu->feed(10);
+
+  sensors::ImuBatch batch;
+  for (uint32_t first : {1u, 5u}) {
+    ASSERT_TRUE(reader->Read(&batch));
+    ASSERT_EQ(batch.ax_size(), 4);
+    EXPECT_EQ(batch.header().sequence_number(), first);
+    for (int i = 0; i < 4; ++i) {
+      EXPECT_EQ(batch.sequence_number(i), first + i);
+      EXPECT_EQ(batch.time_offset_ns(i), 1000u * i);
+      EXPECT_EQ(batch.ax(i), static_cast<float>(first + i));
+    }
+  }
+
+  context.TryCancel();
+  reader->Finish();
+}
+
+TEST_F(TestImuService, BatchClosesOnLatencyLimit) {
+  grpc::ClientContext context;
+  auto reader = openBatchStream(context, 100, 50);
+  ASSERT_TRUE(service.hub()->hasListeners());
+
+  const auto fed = std::chrono::steady_clock::now();
+  imu->feed(3);
+
+  sensors::ImuBatch batch;
+  ASSERT_TRUE(reader->Read(&batch));
+  const auto elapsed = std::chrono::steady_clock::now() - fed;
+  EXPECT_EQ(batch.ax_size(), 3);
+  EXPECT_EQ(batch.header().sequence_number(), 1u);
+  EXPECT_GE(elapsed, 50ms);
+  EXPECT_LT(elapsed, 2s);
+
+  context.TryCancel();
+  reader->Finish();
+}
+
+TEST(ImuService, BatchUnavailableWithoutImu) {
+  ImuServiceImpl service(nullptr);
+  grpc::ServerBuilder builder;
+  builder.RegisterService(&service);
+  const auto server = builder.BuildAndStart();
+  const auto stub = sensors::ImuService::NewStub(
+      server->InProcessChannel(grpc::ChannelArguments()));
+
+  grpc::ClientContext context;
+  auto reader = stub->getImuBatch(&context, sensors::ImuBatchRequest());
+  sensors::ImuBatch batch;
+  EXPECT_FALSE(reader->Read(&batch));
+  EXPECT_EQ(reader->Finish().error_code(), grpc::StatusCode::UNAVAILABLE);
+  server->Shutdown();
+}
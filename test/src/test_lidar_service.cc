@@ -0,0 +1,204 @@
+#include "lidar_service.hh"
+#include "msensor/conversions/conversions.hh"
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <grpcpp/grpcpp.h>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+/// Lidar whose scans are fed by the test.
+class FakeLidar : public msensor::ILidar {
+public:
+  void init() override {}
+  void startSampling() override {}
+  void stopSampling() override {}
+
+  void feed(std::shared_ptr<msensor::Scan3DI> scan) {
+    {
+      std::scoped_lock lock(mutex_);
+      scans_.push_back(std::move(scan));
+    }
+    ready_.notify_all();
+  }
+
+  std::shared_ptr<msensor::Scan3DI> getScan() override {
+    std::scoped_lock lock(mutex_);
+    if (scans_.empty()) {
+      return nullptr;
+    }
+    auto scan = std::move(scans_.front());
+    scans_.pop_front();
+    return scan;
+  }
+
+  bool waitForScan(std::chrono::milliseconds timeout) override {
+    std::unique_lock lock(mutex_);
+    return ready_.wait_for(lock, timeout, [this] { return !scans_.empty(); });
+  }
+
+private:
+  std::mutex mutex_;
+  std::condition_variable ready_;
+  std::deque<std::shared_ptr<msensor::Scan3DI>> scans_;
+};
+
+} // namespace
+
+class TestLidarService : public ::testing::Test {
+public:
+  void TearDown() override {
+    if (server) {
+      server->Shutdown(std::chrono::system_clock::now() + 1s);
+    }
+  }
+
+  /// Serve `service` on an in-process channel.
+  void start() {
+    grpc::ServerBuilder builder;
+    builder.RegisterService(&service);
+    server = builder.BuildAndStart();
+    ASSERT_NE(server, nullptr);
+    stub = sensors::LidarService::NewStub(
+        server->InProcessChannel(grpc::ChannelArguments()));
+  }
+
+  /// Wait until a stream reads the raw scan hub.
+  void waitForListener() {
+    const auto deadline = std::chrono::steady_clock::now() + 2s;
+    while (!service.hub()->hasListeners() &&
+           std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(1ms);
+    }
+    ASSERT_TRUE(service.hub()->hasListeners());
+  }
+
+protected:
+  std::shared_ptr<FakeLidar> lidar = std::make_shared<FakeLidar>();
+  LidarServiceImpl service{lidar};
+  std::unique_ptr<grpc::Server> server;
+  std::unique_ptr<sensors::LidarService::Stub> stub;
+};
+
+TEST_F(TestLidarService, PackedScanKeepsPointsWithinScale) {
+  start();
+  sensors::PackedLidarStreamRequest request;
+  request.mutable_encoding()->set_scale(0.01F);
+  request.mutable_encoding()->set_delta(true);
+  request.mutable_crop()->mutable_box()->set_max_x(10.0F);
+  grpc::ClientContext context;
+  auto reader = stub->getPackedLidarScan(&context, request);
+  waitForListener();
+
+  auto scan = std::make_shared<msensor::Scan3DI>();
+  scan->header = msensor::Header{5000, 7};
+  scan->device_id = 2;
+  scan->points->emplace_back(1.234F, -5.678F, 0.5F, 10.0F);
+  scan->points->emplace_back(-3.001F, 2.0F, -0.25F, 200.0F);
+  scan->points->emplace_back(20.0F, 0.0F, 0.0F, 1.0F); // cropped
+  lidar->feed(scan);
+
+  sensors::PointCloud3Packed packed;
+  ASSERT_TRUE(reader->Read(&packed));
+  EXPECT_FLOAT_EQ(packed.encoding().scale(), 0.01F);
+  EXPECT_TRUE(packed.encoding().delta());
+  EXPECT_EQ(packed.point_count(), 2u);
+
+  const auto unpacked = fromProtobuf(packed);
+  EXPECT_EQ(unpacked->header.timestamp, 5000u);
+  EXPECT_EQ(unpacked->header.sequence_number, 7u);
+  EXPECT_EQ(unpacked->device_id, 2u);
+  ASSERT_EQ(unpacked->points->size(), 2u);
+  for (size_t i = 0; i < 2; ++i) {
+    const auto &expected = (*scan->points)[i];
+    const auto &actual = (*unpacked->points)[i];
+    EXPECT_NEAR(actual.x, expected.x, 0.005F) << i;
+    EXPECT_NEAR(actual.y, expected.y, 0.005F) << i;
+    EXPECT_NEAR(actual.z, expected.z, 0.005F) << i;
+    EXPECT_FLOAT_EQ(actual.intensity, expected.intensity) << i;
+  }
+
+  context.TryCancel();
+  reader->Finish();
+}
+
+TEST_F(TestLidarService, DeskewedScanRotatesIntoScanEndFrame) {
+  auto imu_hub = std::make_shared<ImuHub>(1024);
+  service.enableDeskew(imu_hub);
+  start();
+  grpc::ClientContext context;
+  auto reader =
+      stub->getDeskewedLidarScan(&context, sensors::LidarStreamRequest());
+
+  // The deskew stage drops scans while no stream listens, so keep feeding
+  // 100 ms scans, covered by a 1 rad/s yaw, until one comes out.
+  constexpr uint64_t g_scanNs = 100000000;
+  constexpr uint64_t g_imuPeriodNs = 5000000;
+  std::jthread feeder([&](std::stop_token stop_token) {
+    uint64_t imu_time = 0;
+    for (uint32_t sequence = 1; !stop_token.stop_requested(); ++sequence) {
+      const uint64_t start = sequence * g_scanNs;
+      for (; imu_time <= start + g_scanNs; imu_time += g_imuPeriodNs) {
+        imu_hub->publish(msensor::IMUData{msensor::Header{imu_time, 0}, 0, 0,
+                                          9.81F, 0, 0, 1.0F});
+      }
+      auto scan = std::make_shared<msensor::Scan3DI>();
+      scan->header = msensor::Header{start, sequence};
+      for (uint32_t offset_us : {0U, 50000U, 100000U}) {
+        scan->points->emplace_back(1.0F, 0.0F, 0.0F, 5.0F);
+        scan->time_offsets_us.push_back(offset_us);
+      }
+      lidar->feed(scan);
+      std::this_thread::sleep_for(20ms);
+    }
+  });
+
+  sensors::PointCloud3 msg;
+  ASSERT_TRUE(reader->Read(&msg));
+  feeder.request_stop();
+  const auto deskewed = fromProtobuf(msg);
+  EXPECT_EQ(deskewed->header.timestamp,
+            (deskewed->header.sequence_number + 1) * g_scanNs);
+  EXPECT_TRUE(deskewed->time_offsets_us.empty());
+  ASSERT_EQ(deskewed->points->size(), 3u);
+  for (size_t i = 0; i < 3; ++i) {
+    const float remaining = 0.1F - 0.05F * static_cast<float>(i);
+    EXPECT_NEAR((*deskewed->points)[i].x, std::cos(remaining), 1e-4F) << i;
+    EXPECT_NEAR((*deskewed->points)[i].y, -std::sin(remaining), 1e-4F) << i;
+  }
+
+  context.TryCancel();
+  reader->Finish();
+}
+
+TEST_F(TestLidarService, DeskewedUnavailableWithoutDeskew) {
+  start();
+  grpc::ClientContext context;
+  auto reader =
+      stub->getDeskewedLidarScan(&context, sensors::LidarStreamRequest());
+  sensors::PointCloud3 msg;
+  EXPECT_FALSE(reader->Read(&msg));
+  EXPECT_EQ(reader->Finish().error_code(), grpc::StatusCode::UNAVAILABLE);
+}
+
+TEST(LidarService, PackedUnavailableWithoutLidar) {
+  LidarServiceImpl service(nullptr);
+  grpc::ServerBuilder builder;
+  builder.RegisterService(&service);
+  const auto server = builder.BuildAndStart();
+  const auto stub = sensors::LidarService::NewStub(
+      server->InProcessChannel(grpc::ChannelArguments()));
+
+  grpc::ClientContext context;
+  auto reader = stub->getPackedLidarScan(&context,
+                                         sensors::PackedLidarStreamRequest());
+  sensors::PointCloud3Packed packed;
+  EXPECT_FALSE(reader->Read(&packed));
+  EXPECT_EQ(reader->Finish().error_code(), grpc::StatusCode::UNAVAILABLE);
+  server->Shutdown();
+}
@@ -0,0 +1,53 @@
+#include "msensor/lidar/livox_conversion.hh"
+#include <cstring>
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace msensor;
+using namespace msensor::livox;
+
+namespace {
+/// Build a packed Cartesian high payload with `count` points.
+std::vector<uint8_t> makePayload(size_t count) {
+  std::vector<uint8_t> payload(count * g_cartesianHighPointSize);
+  for (size_t i = 0; i < count; ++i) {
+    const int32_t xyz[3] = {static_cast<int32_t>(i) * 1001 - 40000,
+                            -static_cast<int32_t>(i) * 7, 1234};
+    uint8_t *p = payload.data() + i * g_cartesianHighPointSize;
+    std::memcpy(p, xyz, sizeof(xyz));
+    p[12] = static_cast<uint8_t>(i * 3);
+    p[13] = 0xFF; // tag
+  }
+  return payload;
+}
+} // namespace
+
+TEST(TestLivoxConversion, KernelsMatchScalar) {
+  // Odd size so every vector kernel also runs its scalar tail.
+  constexpr size_t count = 95;
+  const auto payload = makePayload(count);
+  PointCloud3I expected;
+  expected.resize(count);
+  convertCartesianHigh(payload.data(), count, expected.points.data(),
+                       Kernel::Scalar);
+  EXPECT_FLOAT_EQ(expected[0].x, -40.0F);
+  EXPECT_FLOAT_EQ(expected[2].y, -0.014F);
+  EXPECT_FLOAT_EQ(expected[94].z, 1.234F);
+  EXPECT_FLOAT_EQ(expected[94].intensity, (94 * 3) % 256);
+
+  for (const auto kernel : {Kernel::Sse2, Kernel::Neon}) {
+    if (!isSupported(kernel)) {
+      continue;
+    }
+    PointCloud3I actual;
+    actual.resize(count);
+    convertCartesianHigh(payload.data(), count, actual.points.data(), kernel);
+    for (size_t i = 0; i < count; ++i) {
+      EXPECT_FLOAT_EQ(actual[i].x, expected[i].x) << i;
+      EXPECT_FLOAT_EQ(actual[i].y, expected[i].y) << i;
+      EXPECT_FLOAT_EQ(actual[i].z, expected[i].z) << i;
+      EXPECT_FLOAT_EQ(actual[i].data[3], 1.0F) << i;
+      EXPECT_FLOAT_EQ(actual[i].intensity, expected[i].intensity) << i;
+    }
+  }
+}
@@ -0,0 +1,67 @@
+#include "msensor/metrics/metrics.hh"
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+using namespace msensor::metrics;
+
+TEST(TestMetrics, CountersSumAllThreads) {
+  Registry registry;
+  auto counter = registry.counter("test_total", "Test counter.");
+  {
+    std::vector<std::jthread> threads;
+    for (int t = 0; t < 4; ++t) {
+      threads.emplace_back([&] {
+        for (int i = 0; i < 1000; ++i) {
+          counter->add();
+        }
+      });
+    }
+  }
+  EXPECT_EQ(counter->value(), 4000);
+  EXPECT_EQ(registry.counter("test_total", "Test counter."), counter);
+}
+
+TEST(TestMetrics, PrometheusText) {
+  Registry registry;
+  registry.counter("msensor_bytes_total", "Bytes.", {{"rpc", "a"}})
+      ->add(1234567);
+  registry.gauge("msensor_clients", "Clients.")->set(2);
+  auto latency = registry.histogram("msensor_write_us", "Write time.",
+                                    {{"stream", "1"}});
+  latency->observe(3); // le=4
+  latency->observe(4); // le=4
+  latency->observe(100);
+
+  const auto text = registry.prometheusText();
+  EXPECT_NE(text.find("# TYPE msensor_bytes_total counter\n"
+                      "msensor_bytes_total{rpc=\"a\"} 1234567\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("msensor_clients 2\n"), std::string::npos);
+  EXPECT_NE(text.find("msensor_write_us_bucket{stream=\"1\",le=\"2\"} 0\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("msensor_write_us_bucket{stream=\"1\",le=\"4\"} 2\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("msensor_write_us_bucket{stream=\"1\",le=\"+Inf\"} 3\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("msensor_write_us_sum{stream=\"1\"} 107\n"),
+            std::string::npos);
+
+  registry.remove({{"stream", "1"}});
+  EXPECT_EQ(registry.prometheusText().find("msensor_write_us"),
+            std::string::npos);
+}
+
+TEST(TestMetrics, CallbacksRunOutsideTheRegistryLock) {
+  Registry registry;
+  // Would deadlock if read under the registry lock.
+  registry.callback(Type::Gauge, "msensor_test", "Test callback.", {},
+                    [&registry] {
+                      return static_cast<double>(
+                          registry.counter("msensor_other", "Other.") ? 1 : 0);
+                    });
+  const auto samples = registry.collect();
+  ASSERT_EQ(samples.size(), 1);
+  EXPECT_EQ(samples[0].value, 1.0);
+}
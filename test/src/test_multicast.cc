@@ -0,0 +1,191 @@
+#include "msensor/multicast/multicast_publisher.hh"
+#include "msensor/multicast/multicast_receiver.hh"
+#include <algorithm>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+using namespace msensor;
+using namespace std::chrono_literals;
+
+namespace {
+
+using Datagram = std::vector<std::byte>;
+
+/// Message `sequence` of `bytes` bytes, with recognizable contents.
+std::vector<std::byte> makeMessage(size_t bytes, uint8_t sequence) {
+  std::vector<std::byte> message(bytes);
+  for (size_t i = 0; i < bytes; ++i) {
+    message[i] = static_cast<std::byte>(i * 7 + sequence);
+  }
+  return message;
+}
+
+/// The datagrams of `message`, as a publisher would send them.
+std::vector<Datagram> fragment(Fragmenter &fragmenter,
+                               const std::vector<std::byte> &message) {
+  std::vector<Datagram> datagrams;
+  for (const auto &header : fragmenter.fragment(message.size())) {
+    Datagram datagram(sizeof(header) + fragmentPayloadBytes(header));
+    std::memcpy(datagram.data(), &header, sizeof(header));
+    std::memcpy(datagram.data() + sizeof(header),
+                message.data() + fragmentOffset(header),
+                fragmentPayloadBytes(header));
+    datagrams.push_back(std::move(datagram));
+  }
+  return datagrams;
+}
+
+} // namespace
+
+TEST(Reassembler, RebuildsInterleavedAndReorderedFragments) {
+  Fragmenter fragmenter(MulticastStream::Lidar, 1, 1000);
+  Reassembler reassembler;
+  const auto first = makeMessage(5000, 0);
+  const auto second = makeMessage(1500, 1);
+  auto datagrams = fragment(fragmenter, first);
+  ASSERT_EQ(datagrams.size(), 6u);
+  const auto second_datagrams = fragment(fragmenter, second);
+  ASSERT_EQ(second_datagrams.size(), 2u);
+
+  // The second message overtakes the first, whose fragments arrive reversed.
+  std::reverse(datagrams.begin(), datagrams.end());
+  datagrams.insert(datagrams.begin() + 2, second_datagrams.begin(),
+                   second_datagrams.end());
+  std::vector<std::vector<std::byte>> received;
+  for (const auto &datagram : datagrams) {
+    if (const auto message = reassembler.add(datagram)) {
+      received.emplace_back(message->bytes.begin(), message->bytes.end());
+    }
+  }
+  ASSERT_EQ(received.size(), 2u);
+  EXPECT_EQ(received[0], second);
+  EXPECT_EQ(received[1], first);
+
+  const auto &stats = reassembler.stats(MulticastStream::Lidar);
+  EXPECT_EQ(stats.datagrams, 8u);
+  EXPECT_EQ(stats.messages, 2u);
+  EXPECT_EQ(stats.lost, 0u);
+  EXPECT_EQ(reassembler.add(datagrams[0]), std::nullopt); // late duplicate
+  EXPECT_EQ(stats.invalid, 1u);
+}
+
+TEST(Reassembler, CountsLostMessagesOnceOutOfTheWindow) {
+  Fragmenter fragmenter(MulticastStream::Lidar, 1, 1000);
+  Reassembler reassembler(4);
+  const auto &stats = reassembler.stats(MulticastStream::Lidar);
+  Datagram dropped;
+  for (uint8_t sequence = 0; sequence < 10; ++sequence) {
+    auto datagrams = fragment(fragmenter, makeMessage(3000, sequence));
+    if (sequence == 5) {
+      EXPECT_EQ(stats.lost, 0u); // message 2 is still within the window
+      continue;                  // every fragment lost
+    }
+    if (sequence == 2) {
+      dropped = datagrams[1];
+      datagrams.erase(datagrams.begin() + 1);
+    }
+    for (const auto &datagram : datagrams) {
+      reassembler.add(datagram);
+    }
+  }
+  EXPECT_EQ(stats.messages, 8u);
+  EXPECT_EQ(stats.lost, 2u);
+
+  // Too late to complete message 2.
+  EXPECT_EQ(reassembler.add(dropped), std::nullopt);
+  EXPECT_EQ(stats.late, 1u);
+  EXPECT_EQ(stats.messages, 8u);
+}
+
+TEST(Reassembler, RejectsFragmentsNotMatchingTheirIndex) {
+  Fragmenter fragmenter(MulticastStream::Lidar, 1, 1000);
+  Reassembler reassembler;
+  const auto &stats = reassembler.stats(MulticastStream::Lidar);
+  const auto message = makeMessage(1500, 0);
+  auto datagrams = fragment(fragmenter, message);
+  ASSERT_EQ(datagrams.size(), 2u);
+
+  // A single fragment declaring 10 bytes but carrying 2.
+  Fragmenter small(MulticastStream::Lidar, 1, 1000);
+  auto truncated = fragment(small, makeMessage(10, 0))[0];
+  truncated.resize(truncated.size() - 8);
+  EXPECT_EQ(reassembler.add(truncated), std::nullopt);
+
+  // The fragment of a smaller split, claiming the index of the last one.
+  auto shifted = datagrams[1];
+  DatagramHeader header;
+  std::memcpy(&header, shifted.data(), sizeof(header));
+  header.fragment_bytes -= 100;
+  std::memcpy(shifted.data(), &header, sizeof(header));
+  EXPECT_EQ(reassembler.add(shifted), std::nullopt);
+  EXPECT_EQ(stats.invalid, 2u);
+
+  // Neither left a hole in the message eventually completed.
+  EXPECT_EQ(reassembler.add(datagrams[0]), std::nullopt);
+  const auto completed = reassembler.add(datagrams[1]);
+  ASSERT_TRUE(completed);
+  EXPECT_TRUE(std::equal(completed->bytes.begin(), completed->bytes.end(),
+                         message.begin(), message.end()));
+  EXPECT_EQ(stats.messages, 1u);
+}
+
+TEST(Reassembler, RestartsWithANewSession) {
+  Reassembler reassembler;
+  Fragmenter before(MulticastStream::Imu, 1);
+  for (int i = 0; i < 100; ++i) {
+    reassembler.add(fragment(before, makeMessage(64, 0))[0]);
+  }
+  Fragmenter after(MulticastStream::Imu, 2);
+  EXPECT_TRUE(reassembler.add(fragment(after, makeMessage(64, 0))[0]));
+
+  const auto &stats = reassembler.stats(MulticastStream::Imu);
+  EXPECT_EQ(stats.messages, 101u);
+  EXPECT_EQ(stats.restarts, 1u);
+  EXPECT_EQ(stats.lost, 0u);
+  EXPECT_EQ(reassembler.stats(MulticastStream::Lidar).datagrams, 0u);
+}
+
+TEST(MulticastPublisher, ReceiverGetsScansAndImuOverLoopback) {
+  MulticastPublisher::Options options;
+  options.interface = "127.0.0.1";
+  options.port = static_cast<uint16_t>(20000 + getpid() % 10000);
+  MulticastReceiver::Options receiver_options;
+  receiver_options.interface = options.interface;
+  receiver_options.port = options.port;
+
+  auto scans = std::make_shared<MulticastPublisher::ScanHub>(4);
+  auto imu = std::make_shared<MulticastPublisher::ImuHub>(4);
+  std::unique_ptr<MulticastReceiver> receiver;
+  std::unique_ptr<MulticastPublisher> publisher;
+  try {
+    receiver = std::make_unique<MulticastReceiver>(receiver_options);
+    publisher = std::make_unique<MulticastPublisher>(options, scans, imu);
+  } catch (const std::runtime_error &error) {
+    GTEST_SKIP() << "No multicast on loopback: " << error.what();
+  }
+  receiver->start();
+
+  auto scan = std::make_shared<Scan3DI>();
+  scan->header = Header{1000, 3};
+  for (uint32_t i = 0; i < 2000; ++i) {
+    const auto f = static_cast<float>(i);
+    scan->points->emplace_back(f, -f, 0.5F * f, 2.0F * f);
+    scan->time_offsets_us.push_back(i);
+  }
+  scans->publish(scan);
+  imu->publish(IMUData{Header{5, 4}, 0.0F, 0.0F, 9.81F});
+
+  ASSERT_TRUE(receiver->waitForScan(2s));
+  const auto received = receiver->getScan();
+  ASSERT_NE(received, nullptr);
+  EXPECT_EQ(received->header.sequence_number, 3u);
+  ASSERT_EQ(received->points->size(), 2000u);
+  EXPECT_EQ((*received->points)[1999].y, -1999.0F);
+  EXPECT_EQ(received->time_offsets_us, scan->time_offsets_us);
+
+  ASSERT_TRUE(receiver->waitForImuData(2s));
+  EXPECT_EQ(receiver->getImuData()->az, 9.81F);
+  EXPECT_EQ(receiver->stats(MulticastStream::Lidar).lost, 0u);
+  EXPECT_EQ(publisher->sendErrors(), 0u);
+}
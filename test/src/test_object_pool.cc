@@ -0,0 +1,42 @@
+#include "msensor/concurrency/object_pool.hh"
+#include <gtest/gtest.h>
+
+using namespace msensor;
+
+TEST(TestObjectPool, ReusesReleasedObjects) {
+  int created = 0;
+  ObjectPool<int> pool(2, [&] {
+    ++created;
+    return std::make_shared<int>(0);
+  });
+  EXPECT_EQ(created, 2);
+
+  auto first = pool.acquire();
+  *first = 7;
+  const int *address = first.get();
+  first.reset();
+
+  auto second = pool.acquire();
+  auto third = pool.acquire();
+  EXPECT_TRUE(second.get() == address || third.get() == address);
+  EXPECT_NE(second.get(), third.get());
+  EXPECT_EQ(created, 2);
+  EXPECT_EQ(pool.misses(), 0);
+}
+
+TEST(TestObjectPool, HeldObjectsAreNotHandedOut) {
+  ObjectPool<int> pool(1, [] { return std::make_shared<int>(0); });
+
+  auto held = pool.acquire();
+  auto copy = held; // a second consumer of the same object
+  held.reset();
+
+  auto overflow = pool.acquire();
+  EXPECT_NE(overflow.get(), copy.get());
+  EXPECT_EQ(pool.misses(), 1);
+
+  copy.reset();
+  auto reused = pool.acquire();
+  EXPECT_EQ(pool.misses(), 1);
+  EXPECT_NE(reused.get(), overflow.get());
+}
@@ -0,0 +1,161 @@
+#include "msensor/shm/shm_client.hh"
+#include "msensor/shm/shm_publisher.hh"
+#include <cstring>
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <limits>
+#include <sys/mman.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace msensor;
+using namespace std::chrono_literals;
+
+namespace {
+
+/// Segment prefix unique to this process, so parallel runs do not collide.
+std::string testPrefix() {
+  return "/msensor_test_" + std::to_string(getpid());
+}
+
+void writeValue(ShmRing &ring, uint32_t value) {
+  std::memcpy(ring.beginWrite(), &value, sizeof(value));
+  ring.publish(sizeof(value));
+}
+
+std::optional<uint32_t> readValue(const ShmRing &ring,
+                                  ShmRing::Cursor &cursor) {
+  uint32_t value = 0;
+  if (!ring.read(cursor, [&](const std::byte *payload, size_t size) {
+        EXPECT_EQ(size, sizeof(value));
+        std::memcpy(&value, payload, sizeof(value));
+      })) {
+    return std::nullopt;
+  }
+  return value;
+}
+
+std::shared_ptr<const Scan3DI> makeScan(uint32_t sequence) {
+  auto scan = std::make_shared<Scan3DI>();
+  scan->header = Header{1000 + sequence, sequence};
+  scan->device_id = 7;
+  for (uint32_t i = 0; i < 100; ++i) {
+    const auto f = static_cast<float>(i);
+    scan->points->emplace_back(f, -f, 0.5F * f, 2.0F * f);
+    scan->time_offsets_us.push_back(10 * i);
+  }
+  return scan;
+}
+
+} // namespace
+
+TEST(ShmRing, ReaderSkipsItemsOverwrittenByTheWriter) {
+  auto writer = ShmRing::create(testPrefix() + "_ring", 4, sizeof(uint32_t));
+  const auto reader = ShmRing::open(testPrefix() + "_ring");
+  auto cursor = reader.subscribe();
+  EXPECT_FALSE(readValue(reader, cursor));
+  EXPECT_FALSE(reader.waitFor(cursor, 1ms));
+
+  writeValue(writer, 1);
+  EXPECT_TRUE(reader.waitFor(cursor, 1ms));
+  EXPECT_EQ(readValue(reader, cursor), 1u);
+
+  for (uint32_t value = 2; value <= 7; ++value) {
+    writeValue(writer, value);
+  }
+  // Items 2 and 3 were overwritten by 6 and 7.
+  EXPECT_EQ(readValue(reader, cursor), 4u);
+  EXPECT_EQ(cursor.skipped, 2u);
+  EXPECT_EQ(readValue(reader, cursor), 5u);
+
+  EXPECT_FALSE(reader.closed());
+  writer = ShmRing::create(testPrefix() + "_other", 1, 1);
+  EXPECT_TRUE(reader.closed());
+  EXPECT_TRUE(reader.replaced());
+}
+
+TEST(ShmRing, RejectsInvalidGeometry) {
+  EXPECT_THROW(ShmRing::create(testPrefix() + "_ring",
+                               std::numeric_limits<size_t>::max() / 64, 1),
+               std::runtime_error);
+
+  const auto writer = ShmRing::create(testPrefix() + "_ring", 4, 4);
+  // Zero the slot count, the 64-bit field after the magic and version.
+  const int fd = shm_open((testPrefix() + "_ring").c_str(), O_RDWR, 0);
+  ASSERT_GE(fd, 0);
+  const uint64_t slots = 0;
+  ASSERT_EQ(pwrite(fd, &slots, sizeof(slots), 8), sizeof(slots));
+  close(fd);
+  EXPECT_THROW(ShmRing::open(testPrefix() + "_ring"), std::runtime_error);
+}
+
+TEST(ShmRing, WakesWaitingReader) {
+  auto writer = ShmRing::create(testPrefix() + "_ring", 4, sizeof(uint32_t));
+  const auto reader = ShmRing::open(testPrefix() + "_ring");
+  auto cursor = reader.subscribe();
+
+  std::jthread publisher([&] {
+    std::this_thread::sleep_for(10ms);
+    writeValue(writer, 42);
+  });
+  EXPECT_TRUE(reader.waitFor(cursor, 5s));
+  EXPECT_EQ(readValue(reader, cursor), 42u);
+}
+
+TEST(ShmPublisher, ClientReadsHubItemsAndReconnects) {
+  auto scans = std::make_shared<ShmPublisher::ScanHub>(4);
+  auto imu = std::make_shared<ShmPublisher::ImuHub>(4);
+  auto frames = std::make_shared<ShmPublisher::FrameHub>(2);
+  ShmPublisher::Options options;
+  options.prefix = testPrefix();
+  options.max_scan_points = 100;
+  options.max_frame_bytes = 64;
+  auto publisher =
+      std::make_unique<ShmPublisher>(options, scans, imu, frames);
+
+  ShmClient client(testPrefix());
+  EXPECT_FALSE(client.isOpened());
+  client.init();
+  EXPECT_TRUE(client.isOpened());
+  EXPECT_EQ(client.getScan(), nullptr);
+  EXPECT_FALSE(client.getImuData());
+
+  const auto scan = makeScan(1);
+  scans->publish(scan);
+  ASSERT_TRUE(client.waitForScan(1s));
+  const auto received = client.getScan();
+  ASSERT_NE(received, nullptr);
+  EXPECT_EQ(received->header.sequence_number, 1u);
+  EXPECT_EQ(received->device_id, 7u);
+  ASSERT_EQ(received->points->size(), scan->points->size());
+  EXPECT_EQ((*received->points)[99].y, -99.0F);
+  EXPECT_EQ((*received->points)[99].intensity, 198.0F);
+  EXPECT_EQ(received->time_offsets_us, scan->time_offsets_us);
+  EXPECT_EQ(client.getScan(), nullptr);
+
+  // Scans over `max_scan_points` do not fit a slot.
+  auto large = std::make_shared<Scan3DI>(*scan);
+  large->points = pcl::make_shared<PointCloud3I>(*scan->points);
+  large->points->resize(200);
+  large->time_offsets_us.clear();
+  scans->publish(large);
+  EXPECT_EQ(publisher->oversized(), 1u);
+
+  imu->publish(IMUData{Header{5, 3}, 0.0F, 0.0F, 9.81F});
+  ASSERT_TRUE(client.waitForImuData(1s));
+  const auto sample = client.getImuData();
+  ASSERT_TRUE(sample);
+  EXPECT_EQ(sample->header.sequence_number, 3u);
+  EXPECT_EQ(sample->az, 9.81F);
+
+  // A restarted publisher is picked up on the next read.
+  publisher.reset();
+  publisher = std::make_unique<ShmPublisher>(options, scans, imu, frames);
+  EXPECT_EQ(client.getScan(), nullptr);
+  scans->publish(makeScan(2));
+  ASSERT_TRUE(client.waitForScan(1s));
+  const auto after_restart = client.getScan();
+  ASSERT_NE(after_restart, nullptr);
+  EXPECT_EQ(after_restart->header.sequence_number, 2u);
+  EXPECT_EQ(client.skipped().scans, 0u);
+}
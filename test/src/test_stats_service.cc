@@ -0,0 +1,102 @@
+#include "stats_service.hh"
+#include <cmath>
+#include <grpcpp/grpcpp.h>
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+class TestStatsService : public ::testing::Test {
+public:
+  void SetUp() override {
+    grpc::ServerBuilder builder;
+    builder.RegisterService(&service);
+    server = builder.BuildAndStart();
+    ASSERT_NE(server, nullptr);
+    stub = sensors::StatsService::NewStub(
+        server->InProcessChannel(grpc::ChannelArguments()));
+  }
+
+  void TearDown() override { server->Shutdown(); }
+
+  sensors::Stats getStats() {
+    grpc::ClientContext context;
+    sensors::Stats stats;
+    EXPECT_TRUE(stub->getStats(&context, sensors::StatsRequest(), &stats).ok());
+    return stats;
+  }
+
+  /// Metric of `stats` named `name`, or null.
+  static const sensors::Metric *find(const sensors::Stats &stats,
+                                     const std::string &name) {
+    for (const auto &metric : stats.metrics()) {
+      if (metric.name() == name) {
+        return &metric;
+      }
+    }
+    return nullptr;
+  }
+
+protected:
+  std::shared_ptr<msensor::metrics::Registry> registry =
+      std::make_shared<msensor::metrics::Registry>();
+  StatsServiceImpl service{registry};
+  std::unique_ptr<grpc::Server> server;
+  std::unique_ptr<sensors::StatsService::Stub> stub;
+};
+
+TEST_F(TestStatsService, ReportsMetricsAndCounterRates) {
+  auto counter =
+      registry->counter("msensor_bytes_total", "Bytes.", {{"rpc", "a"}});
+  registry->gauge("msensor_clients", "Clients.")->set(2);
+  auto latency = registry->histogram("msensor_write_us", "Write time.");
+  counter->add(100);
+  latency->observe(3);
+  latency->observe(100);
+
+  const auto first = getStats();
+  const auto *bytes = find(first, "msensor_bytes_total");
+  ASSERT_NE(bytes, nullptr);
+  EXPECT_EQ(bytes->type(), sensors::Metric::COUNTER);
+  EXPECT_EQ(bytes->labels().at("rpc"), "a");
+  EXPECT_EQ(bytes->value(), 100);
+  EXPECT_EQ(bytes->rate(), 0); // no previous call
+
+  const auto *clients = find(first, "msensor_clients");
+  ASSERT_NE(clients, nullptr);
+  EXPECT_EQ(clients->type(), sensors::Metric::GAUGE);
+  EXPECT_EQ(clients->value(), 2);
+
+  const auto *write = find(first, "msensor_write_us");
+  ASSERT_NE(write, nullptr);
+  EXPECT_EQ(write->type(), sensors::Metric::HISTOGRAM);
+  EXPECT_EQ(write->histogram().total(), 2u);
+  EXPECT_EQ(write->histogram().sum(), 103);
+  ASSERT_GT(write->histogram().count_size(), 0);
+  EXPECT_EQ(write->histogram().upper_bound_size(),
+            write->histogram().count_size());
+  EXPECT_TRUE(std::isinf(write->histogram().upper_bound(
+      write->histogram().upper_bound_size() - 1)));
+
+  std::this_thread::sleep_for(20ms);
+  counter->add(50);
+  const auto second = getStats();
+  bytes = find(second, "msensor_bytes_total");
+  ASSERT_NE(bytes, nullptr);
+  EXPECT_EQ(bytes->value(), 150);
+  // 50 over at least 20 ms.
+  EXPECT_GT(bytes->rate(), 0);
+  EXPECT_LE(bytes->rate(), 2500);
+  EXPECT_GE(second.uptime_s(), first.uptime_s());
+}
+
+TEST_F(TestStatsService, ServesPrometheusText) {
+  registry->gauge("msensor_clients", "Clients.")->set(2);
+
+  grpc::ClientContext context;
+  sensors::PrometheusText text;
+  ASSERT_TRUE(
+      stub->getPrometheusText(&context, sensors::StatsRequest(), &text).ok());
+  EXPECT_EQ(text.text(), registry->prometheusText());
+  EXPECT_NE(text.text().find("msensor_clients 2\n"), std::string::npos);
+}
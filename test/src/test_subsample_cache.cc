@@ -0,0 +1,106 @@
+#include "subsample_cache.hh"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using namespace msensor;
+
+namespace {
+
+std::shared_ptr<const Scan3DI> makeScan(uint32_t sequence) {
+  auto scan = std::make_shared<Scan3DI>();
+  scan->header = Header{1000 + sequence, sequence};
+  for (int i = 0; i < 1000; ++i) {
+    const auto f = static_cast<float>(i);
+    scan->points->emplace_back(0.01F * f, 0.0F, 1.0F, f);
+  }
+  return scan;
+}
+
+uint64_t lookups(metrics::Registry &registry, const std::string &result) {
+  return registry
+      .counter("msensor_subsample_cache_total", "", {{"result", result}})
+      ->value();
+}
+
+} // namespace
+
+TEST(SubsampleCache, SharesOneMessagePerScanAndLeaf) {
+  auto registry = std::make_shared<metrics::Registry>();
+  SubsampleCache cache(2, registry);
+  const auto scan = makeScan(1);
+
+  const auto first = cache.get(scan, 0.1F);
+  EXPECT_EQ(first, cache.get(scan, 0.1F));
+  EXPECT_EQ(first->x_size(), 100);
+  EXPECT_EQ(first->header().sequence_number(), 1u);
+
+  const auto coarse = cache.get(scan, 1.0F);
+  EXPECT_NE(first, coarse);
+  EXPECT_EQ(coarse->x_size(), 10);
+
+  CropRegion region;
+  region.box_max[0] = 4.95F;
+  const auto cropped = cache.get(scan, 0.1F, region);
+  EXPECT_NE(first, cropped);
+  EXPECT_EQ(cropped->x_size(), 50);
+  EXPECT_EQ(cropped, cache.get(scan, 0.1F, region));
+  EXPECT_EQ(lookups(*registry, "hit"), 2u);
+  EXPECT_EQ(lookups(*registry, "miss"), 3u);
+}
+
+TEST(SubsampleCache, ComputesOnceForConcurrentStreams) {
+  auto registry = std::make_shared<metrics::Registry>();
+  SubsampleCache cache(2, registry);
+  const auto scan = makeScan(1);
+
+  std::vector<std::shared_ptr<const sensors::PointCloud3>> results(8);
+  {
+    std::vector<std::jthread> streams;
+    for (auto &result : results) {
+      streams.emplace_back([&] { result = cache.get(scan, 0.1F); });
+    }
+  }
+  for (const auto &result : results) {
+    EXPECT_EQ(result, results.front());
+  }
+  EXPECT_EQ(lookups(*registry, "miss"), 1u);
+}
+
+TEST(SubsampleCache, SerializesEachViewOnce) {
+  SubsampleCache cache(2);
+  const auto scan = makeScan(1);
+  const auto message = cache.get(scan, 0.1F);
+  const grpc::Slice serialized = cache.getSerialized(scan, 0.1F);
+  EXPECT_EQ(serialized.begin(), cache.getSerialized(scan, 0.1F).begin());
+
+  // As written by a stream reporting skipped scans: the appended header is
+  // merged into the shared one.
+  sensors::PointCloud3 report;
+  report.mutable_header()->set_skipped(3);
+  const std::string bytes =
+      std::string(reinterpret_cast<const char *>(serialized.begin()),
+                  serialized.size()) +
+      report.SerializeAsString();
+  sensors::PointCloud3 parsed;
+  ASSERT_TRUE(parsed.ParseFromString(bytes));
+  EXPECT_EQ(parsed.header().skipped(), 3u);
+  EXPECT_EQ(parsed.header().sequence_number(), 1u);
+  EXPECT_EQ(parsed.x_size(), message->x_size());
+}
+
+TEST(SubsampleCache, EvictsOldScansAndRestartedSequences) {
+  auto registry = std::make_shared<metrics::Registry>();
+  SubsampleCache cache(2, registry);
+  const auto first = cache.get(makeScan(1), 0.1F);
+  cache.get(makeScan(2), 0.1F);
+  cache.get(makeScan(3), 0.1F);
+  EXPECT_NE(first, cache.get(makeScan(1), 0.1F)); // evicted
+
+  // Same sequence number, but another scan (e.g. after a driver restart).
+  auto restarted = std::make_shared<Scan3DI>(*makeScan(3));
+  restarted->header.timestamp += 1;
+  cache.get(restarted, 0.1F);
+  EXPECT_EQ(lookups(*registry, "hit"), 0u);
+  EXPECT_EQ(lookups(*registry, "miss"), 5u);
+}
@@ -0,0 +1,113 @@
+#include "msensor/processing/voxel_filter.hh"
+#include <algorithm>
+#include <cmath>
+#include <gtest/gtest.h>
+#include <limits>
+#include <map>
+#include <random>
+#include <tuple>
+
+using namespace msensor;
+
+namespace {
+
+PointCloud3I makeCloud(size_t count, float extent) {
+  std::mt19937 random(7);
+  std::uniform_real_distribution<float> coordinate(-extent, extent);
+  std::uniform_real_distribution<float> intensity(0.0F, 255.0F);
+  PointCloud3I cloud;
+  for (size_t i = 0; i < count; ++i) {
+    cloud.emplace_back(coordinate(random), coordinate(random),
+                       coordinate(random), intensity(random));
+  }
+  return cloud;
+}
+
+/// Per-voxel means accumulated in input order, as pcl::VoxelGrid computes
+/// them, or the first point of each voxel.
+PointCloud3I reference(const PointCloud3I &cloud, float leaf, bool centroid) {
+  std::map<std::tuple<int, int, int>, std::pair<Point3I, int>> voxels;
+  for (const auto &point : cloud) {
+    if (!std::isfinite(point.x)) {
+      continue;
+    }
+    const auto key = std::make_tuple(
+        static_cast<int>(std::floor(point.x * (1.0F / leaf))),
+        static_cast<int>(std::floor(point.y * (1.0F / leaf))),
+        static_cast<int>(std::floor(point.z * (1.0F / leaf))));
+    auto [it, inserted] = voxels.try_emplace(key, point, 1);
+    if (!inserted && centroid) {
+      auto &[sum, count] = it->second;
+      sum.x += point.x;
+      sum.y += point.y;
+      sum.z += point.z;
+      sum.intensity += point.intensity;
+      ++count;
+    }
+  }
+  PointCloud3I out;
+  for (const auto &[key, voxel] : voxels) {
+    const auto n = static_cast<float>(voxel.second);
+    out.emplace_back(voxel.first.x / n, voxel.first.y / n, voxel.first.z / n,
+                     voxel.first.intensity / n);
+  }
+  return out;
+}
+
+/// Points in a canonical order, so clouds compare regardless of voxel order.
+std::vector<std::tuple<float, float, float, float>>
+sorted(const PointCloud3I &cloud) {
+  std::vector<std::tuple<float, float, float, float>> points;
+  for (const auto &point : cloud) {
+    points.emplace_back(point.x, point.y, point.z, point.intensity);
+  }
+  std::sort(points.begin(), points.end());
+  return points;
+}
+
+} // namespace
+
+TEST(TestVoxelFilter, CentroidMatchesVoxelGridSemantics) {
+  auto cloud = makeCloud(5000, 5.0F);
+  cloud.emplace_back(std::numeric_limits<float>::quiet_NaN(), 0.0F, 0.0F,
+                     1.0F);
+
+  VoxelFilter filter;
+  PointCloud3I out;
+  filter.filter(cloud, 0.5F, out);
+
+  EXPECT_EQ(filter.dropped(), 1);
+  EXPECT_EQ(out.width, out.size());
+  EXPECT_EQ(sorted(out), sorted(reference(cloud, 0.5F, true)));
+}
+
+TEST(TestVoxelFilter, FirstPointKeepsOnePointPerVoxel) {
+  PointCloud3I cloud;
+  cloud.emplace_back(0.01F, 0.01F, 0.01F, 10.0F);
+  cloud.emplace_back(0.09F, 0.02F, 0.03F, 20.0F); // same 10 cm voxel
+  cloud.emplace_back(-0.01F, 0.01F, 0.01F, 30.0F);
+
+  VoxelFilter filter(VoxelFilter::Mode::FirstPoint);
+  PointCloud3I out;
+  filter.filter(cloud, 0.1F, out);
+
+  ASSERT_EQ(out.size(), 2);
+  EXPECT_EQ(sorted(out), sorted(reference(cloud, 0.1F, false)));
+}
+
+TEST(TestVoxelFilter, ParallelMatchesSerial) {
+  const auto cloud = makeCloud(2 * g_voxelParallelThreshold, 20.0F);
+
+  VoxelFilter serial(VoxelFilter::Mode::Centroid, 1);
+  VoxelFilter parallel(VoxelFilter::Mode::Centroid, 4);
+  PointCloud3I serial_out;
+  PointCloud3I parallel_out;
+  // Twice, so the second pass runs on the reused tables.
+  for (int pass = 0; pass < 2; ++pass) {
+    serial.filter(cloud, 0.2F, serial_out);
+    parallel.filter(cloud, 0.2F, parallel_out);
+    EXPECT_EQ(sorted(parallel_out), sorted(serial_out));
+    EXPECT_EQ(parallel.dropped(), serial.dropped());
+  }
+  EXPECT_EQ(sorted(serial_out), sorted(reference(cloud, 0.2F, true)));
+}